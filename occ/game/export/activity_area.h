@@ -0,0 +1,9 @@
+#pragma once
+
+#include "geometry.h"
+
+// The size of the game camera
+static constexpr geometry::Size CAMERA_SIZE = geometry::Size(320, 192);
+
+// Entities further than this (in pixels) outside the game camera are not simulated, see Game::set_activity_area
+static constexpr int ACTIVITY_RADIUS = 4 * 16;
@@ -1,9 +1,15 @@
 // Base class of enemies and hazards
 #pragma once
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
 #include <utility>
 
 #include "geometry.h"
 #include "misc.h"
+#include "object.h"
+#include "snapshot.h"
 #include "sprite.h"
 
 enum class LeverColor : int
@@ -15,9 +21,37 @@ enum class LeverColor : int
 
 struct Level;
 
+// Rectangles in which an actor detects the player, one per tile the actor covers along the detection axis
+// Actors are at most two tiles big, so the rectangles are stored inline instead of being allocated every tick
+class DetectionRects
+{
+ public:
+  static constexpr std::size_t MAX_RECTS = 2;
+
+  // The rectangles of bigger actors than MAX_RECTS tiles are dropped (and assert in debug builds)
+  void push_back(const geometry::Rectangle& rect)
+  {
+    assert(size_ < MAX_RECTS);
+    if (size_ < MAX_RECTS)
+    {
+      rects_[size_++] = rect;
+    }
+  }
+
+  const geometry::Rectangle* begin() const { return rects_.data(); }
+  const geometry::Rectangle* end() const { return rects_.data() + size_; }
+  std::size_t size() const { return size_; }
+
+ private:
+  std::array<geometry::Rectangle, MAX_RECTS> rects_;
+  std::size_t size_ = 0;
+};
+
 class Actor
 {
  public:
+  static constexpr uint32_t NOT_INDEXED = UINT32_MAX;
+
   Actor(geometry::Position position, geometry::Size size) : position(std::move(position)), size(std::move(size)) {}
   virtual ~Actor() = default;
 
@@ -27,20 +61,25 @@ class Actor
 
   virtual void update(const geometry::Rectangle& player_rect, Level& level) = 0;
   virtual bool interact([[maybe_unused]] Level& level) { return false; };
-  virtual std::vector<std::pair<geometry::Position, Sprite>> get_sprites(const Level& level) const = 0;
-  virtual std::vector<geometry::Rectangle> get_detection_rects([[maybe_unused]] const Level& level) const { return {}; }
+  virtual void get_sprites(const Level& level, SpriteSink& sink) const = 0;
+  virtual DetectionRects get_detection_rects([[maybe_unused]] const Level& level) const { return {}; }
+  // Called on the copy of the actor when its level is cloned, to point it to the copies of the actors it refers to
+  virtual void on_clone([[maybe_unused]] const Level& original, [[maybe_unused]] const Level& clone) {}
+  // Saves the fields of the actor to snapshot and restores them, see Level::save
+  // Derived classes with fields of their own must save and restore them after the fields of their base class.
+  virtual void save(Snapshot& snapshot, const Level& level) const;
+  virtual bool restore(Snapshot::Reader& reader, Level& level);
 
   geometry::Position position;
   geometry::Size size;
+  // Record of the actor in the SpatialIndex it is inserted into
+  uint32_t index_record = NOT_INDEXED;
 
  protected:
-  std::vector<geometry::Rectangle> create_detection_rects(const int dx,
-                                                          const int dy,
-                                                          const Level& level,
-                                                          const bool include_self = false) const;
+  DetectionRects create_detection_rects(const int dx, const int dy, const Level& level, const bool include_self = false) const;
 };
 
-class Lever : public Actor
+class Lever final : public Actor
 {
   // ⬛⬛⬛⬛⬛⬛⬛⬛⬛⬛🟥🚨🟥⬛⬛⬛
   // ⬛⬛⬛⬛⬛⬛⬛⬛⬛🟥🚨🟥🟥🟥⬛⬛
@@ -60,16 +99,19 @@ class Lever : public Actor
   // Opens a door when interacted with
  public:
   Lever(geometry::Position position, LeverColor color) : Actor(position, geometry::Size(16, 16)), color_(color) {}
+  Lever() : Lever(geometry::Position(), LeverColor::LEVER_COLOR_R) {}
 
   virtual bool interact(Level& level) override;
-  virtual std::vector<std::pair<geometry::Position, Sprite>> get_sprites(const Level& level) const override;
+  virtual void get_sprites(const Level& level, SpriteSink& sink) const override;
   virtual void update([[maybe_unused]] const geometry::Rectangle& player_rect, [[maybe_unused]] Level& level) override {}
+  virtual void save(Snapshot& snapshot, const Level& level) const override;
+  virtual bool restore(Snapshot::Reader& reader, Level& level) override;
 
  private:
   LeverColor color_;
 };
 
-class Door : public Actor
+class Door final : public Actor
 {
   // ⬛⬛🚨🚨🚨🚨🚨🚨🚨🚨🚨🚨🚨🚨⬛⬛
   // ⬛🚨⬛⬛⬛⬛⬛⬛⬛⬛⬛⬛⬛⬛🪦⬛
@@ -106,17 +148,20 @@ class Door : public Actor
   // Doors that can be opened by the corresponding coloured lever
  public:
   Door(geometry::Position position, LeverColor color) : Actor(position, geometry::Size(16, 32)), color_(color) {}
+  Door() : Door(geometry::Position(), LeverColor::LEVER_COLOR_R) {}
 
   virtual bool is_solid(const Level& level) const override;
 
-  virtual std::vector<std::pair<geometry::Position, Sprite>> get_sprites(const Level& level) const override;
+  virtual void get_sprites(const Level& level, SpriteSink& sink) const override;
   virtual void update([[maybe_unused]] const geometry::Rectangle& player_rect, [[maybe_unused]] Level& level) override {}
+  virtual void save(Snapshot& snapshot, const Level& level) const override;
+  virtual bool restore(Snapshot::Reader& reader, Level& level) override;
 
  private:
   LeverColor color_;
 };
 
-class Switch : public Actor
+class Switch final : public Actor
 {
   // ⬛⬛⬜⬜⬜⬜⬜⬜⬜⬜⬜⬜⬜⬜⬛⬛
   // ⬛⬜⚪🚨🚨⚪⚪🚨🚨⚪⚪🚨🚨⚪🪦⬛
@@ -135,10 +180,13 @@ class Switch : public Actor
   // Switches that turn things off/on (e.g. moving platforms)
  public:
   Switch(geometry::Position position, Sprite sprite) : Actor(position, geometry::Size(16, 16)), sprite_(sprite) {}
+  Switch() : Switch(geometry::Position(), Sprite::SPRITE_NONE) {}
 
   virtual bool interact(Level& level) override;
-  virtual std::vector<std::pair<geometry::Position, Sprite>> get_sprites(const Level& level) const override;
+  virtual void get_sprites(const Level& level, SpriteSink& sink) const override;
   virtual void update([[maybe_unused]] const geometry::Rectangle& player_rect, [[maybe_unused]] Level& level) override {}
+  virtual void save(Snapshot& snapshot, const Level& level) const override;
+  virtual bool restore(Snapshot::Reader& reader, Level& level) override;
 
  private:
   Sprite sprite_;
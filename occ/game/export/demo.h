@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+#include "exe_data.h"
+#include "game.h"
+#include "geometry.h"
+#include "level_id.h"
+#include "player_input.h"
+
+// A recording of the input given to Game::update, which replays the same game given the same EXE data.
+// Each time a level is (re)started a new segment begins, and the input of each segment is run-length encoded
+// as a player usually holds the same buttons for many ticks.
+class Demo
+{
+ public:
+  struct Run
+  {
+    uint32_t input;
+    uint32_t count;
+  };
+
+  struct Segment
+  {
+    LevelId level;
+    unsigned first_tick;
+    std::vector<Run> runs;
+  };
+
+  // The activity area changes which entities are simulated, so it is part of the recording
+  Demo(const uint64_t seed, const geometry::Size& activity_size, const int activity_radius)
+    : seed_(seed),
+      activity_size_(activity_size),
+      activity_radius_(activity_radius),
+      segments_()
+  {
+  }
+
+  static std::unique_ptr<Demo> load(const std::filesystem::path& path);
+  bool save(const std::filesystem::path& path) const;
+
+  // Recording: call start_level after each Game::init and add before each Game::update
+  void start_level(const LevelId level, const unsigned game_tick);
+  void add(const PlayerInput& player_input);
+
+  // Plays the whole demo on game, which must have been created with get_seed(). Returns false if a level
+  // could not be loaded.
+  bool replay(Game& game, const ExeData& exe_data) const;
+
+  uint64_t get_seed() const { return seed_; }
+  const std::vector<Segment>& get_segments() const { return segments_; }
+  unsigned get_num_ticks() const;
+
+  static uint32_t pack(const PlayerInput& player_input);
+  static PlayerInput unpack(const uint32_t input);
+
+ private:
+  uint64_t seed_;
+  geometry::Size activity_size_;
+  int activity_radius_;
+  std::vector<Segment> segments_;
+};
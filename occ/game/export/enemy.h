@@ -4,6 +4,7 @@
 #include "actor.h"
 #include "geometry.h"
 #include "misc.h"
+#include "snapshot.h"
 #include "sprite.h"
 
 struct Level;
@@ -18,6 +19,8 @@ class Enemy : public Actor
   virtual bool is_alive() const override { return health > 0; }
   virtual int get_points() const override { return points; }
   virtual void on_death([[maybe_unused]] Level& level) {}
+  virtual void save(Snapshot& snapshot, const Level& level) const override;
+  virtual bool restore(Snapshot::Reader& reader, Level& level) override;
 
   int health;
   int points;
@@ -26,7 +29,7 @@ class Enemy : public Actor
   bool should_reverse(const Level& level) const;
 };
 
-class Bigfoot : public Enemy
+class Bigfoot final : public Enemy
 {
   // ⚫⚫⚫⚫⚫⚫🟩🟩🟩⚫⚫⚫⚫⚫⚫⚫
   // ⚫⚫⚫⚫🟩🟩🟢🟢🟢🟢🟢⚫⚫⚫⚫⚫
@@ -61,10 +64,13 @@ class Bigfoot : public Enemy
   // 2-tile tall enemy, runs if they see player
  public:
   Bigfoot(geometry::Position position) : Enemy(position - geometry::Position(0, 16), geometry::Size(16, 32), 5, 5000) {}
+  Bigfoot() : Bigfoot(geometry::Position()) {}
 
   virtual void update(const geometry::Rectangle& player_rect, Level& level) override;
-  virtual std::vector<std::pair<geometry::Position, Sprite>> get_sprites(const Level& level) const override;
-  virtual std::vector<geometry::Rectangle> get_detection_rects(const Level& level) const override
+  virtual void get_sprites(const Level& level, SpriteSink& sink) const override;
+  virtual void save(Snapshot& snapshot, const Level& level) const override;
+  virtual bool restore(Snapshot::Reader& reader, Level& level) override;
+  virtual DetectionRects get_detection_rects(const Level& level) const override
   {
     return create_detection_rects(left_ ? -1 : 1, 0, level);
   }
@@ -75,7 +81,7 @@ class Bigfoot : public Enemy
   int frame_ = 0;
 };
 
-class Hopper : public Enemy
+class Hopper final : public Enemy
 {
   // ⚫⚫⚫⚫⚫⚫⚫⚫⚫⚫⬜🟦⚫⚫⚫⚫
   // ⚫⚫⚫⚫⚫⚫⚫⚫🟢⬜⬜🟦🟦⚫⚫⚫
@@ -89,9 +95,12 @@ class Hopper : public Enemy
   // Moves left and right erratically
  public:
   Hopper(geometry::Position position) : Enemy(position, geometry::Size(16, 16), 1, 100) {}
+  Hopper() : Hopper(geometry::Position()) {}
 
   virtual void update(const geometry::Rectangle& player_rect, Level& level) override;
-  virtual std::vector<std::pair<geometry::Position, Sprite>> get_sprites(const Level& level) const override;
+  virtual void get_sprites(const Level& level, SpriteSink& sink) const override;
+  virtual void save(Snapshot& snapshot, const Level& level) const override;
+  virtual bool restore(Snapshot::Reader& reader, Level& level) override;
 
  private:
   bool left_ = false;
@@ -99,7 +108,7 @@ class Hopper : public Enemy
   int next_reverse_ = 0;
 };
 
-class Slime : public Enemy
+class Slime final : public Enemy
 {
   // ⬛⬛⬛⬛⬛⬛⬛⬛⬛⬛🟩🟩🟩🟩⬛⬛
   // ⬛⬛⬛⬛⬛⬛⬛🟩🟩🟩🟩🦚🦚🦚⬛⬛
@@ -113,9 +122,12 @@ class Slime : public Enemy
   // Flies around, pauses and changes directions erratically
  public:
   Slime(geometry::Position position) : Enemy(position, geometry::Size(16, 16), 1, 100) {}
+  Slime() : Slime(geometry::Position()) {}
 
   virtual void update(const geometry::Rectangle& player_rect, Level& level) override;
-  virtual std::vector<std::pair<geometry::Position, Sprite>> get_sprites(const Level& level) const override;
+  virtual void get_sprites(const Level& level, SpriteSink& sink) const override;
+  virtual void save(Snapshot& snapshot, const Level& level) const override;
+  virtual bool restore(Snapshot::Reader& reader, Level& level) override;
 
  private:
   int dx_ = 1;
@@ -123,7 +135,7 @@ class Slime : public Enemy
   int frame_ = 0;
 };
 
-class Snake : public Enemy
+class Snake final : public Enemy
 {
   // ⚫⚫⚫⚫🟪🟨🟪🟪⚫⚫⚫⚫⚫⚫⚫⚫
   // ⚫⚫⚫🟪🟪🟪🟪🟪🟪🟪⚫⚫⚫⚫⚫⚫
@@ -141,9 +153,12 @@ class Snake : public Enemy
   // Moves left/right, pauses, leaves slime
  public:
   Snake(geometry::Position position) : Enemy(position, geometry::Size(16, 16), 2, 100) {}
+  Snake() : Snake(geometry::Position()) {}
 
   virtual void update(const geometry::Rectangle& player_rect, Level& level) override;
-  virtual std::vector<std::pair<geometry::Position, Sprite>> get_sprites(const Level& level) const override;
+  virtual void get_sprites(const Level& level, SpriteSink& sink) const override;
+  virtual void save(Snapshot& snapshot, const Level& level) const override;
+  virtual bool restore(Snapshot::Reader& reader, Level& level) override;
   virtual void on_death(Level& level) override;
 
  private:
@@ -152,7 +167,7 @@ class Snake : public Enemy
   int frame_ = 0;
 };
 
-class Spider : public Enemy
+class Spider final : public Enemy
 {
   // ⚫🟢🟢⚫⚫⚫🟥⚫⚫🟥⚫⚫⚫🟢🟢⚫
   // ⚫⚫⚫⬜⚫🟥⚫⚫⚫⚫🟥⚫⬜⚫⚫⚫
@@ -171,13 +186,18 @@ class Spider : public Enemy
   // Moves up and down, shoots webs below
  public:
   Spider(geometry::Position position) : Enemy(position, geometry::Size(16, 16), 1, 100) {}
+  Spider() : Spider(geometry::Position()) {}
 
   virtual void update(const geometry::Rectangle& player_rect, Level& level) override;
-  virtual std::vector<std::pair<geometry::Position, Sprite>> get_sprites(const Level& level) const override;
-  virtual std::vector<geometry::Rectangle> get_detection_rects(const Level& level) const override
+  virtual void get_sprites(const Level& level, SpriteSink& sink) const override;
+  virtual void save(Snapshot& snapshot, const Level& level) const override;
+  virtual bool restore(Snapshot::Reader& reader, Level& level) override;
+  virtual DetectionRects get_detection_rects(const Level& level) const override
   {
     return create_detection_rects(0, 1, level);
   }
+  virtual void on_clone(const Level& original, const Level& clone) override;
+  virtual void on_death(Level& level) override;
   void remove_child() { child_ = nullptr; }
 
  private:
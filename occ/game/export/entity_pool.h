@@ -0,0 +1,477 @@
+#pragma once
+
+#include <algorithm>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "snapshot.h"
+
+// Refers to an entity of an EntityPools by the index of its type and its slot in the pool of that type
+// Snapshots store links instead of addresses, so that they can be restored into any copy of the entities.
+struct EntityLink
+{
+  static constexpr uint32_t NONE = UINT32_MAX;
+
+  uint32_t type;
+  uint32_t slot;
+};
+
+// Storage for entities of a single concrete type
+// Entities are stored contiguously in fixed size chunks so that updating all of them walks memory linearly.
+// Entities never move once created, so pointers to them (e.g. in SpatialIndex) stay valid until they are erased.
+// Slots of erased entities are reused by entities created later.
+// Pools are not copyable, use copy_from to copy the entities and relocate to fix up pointers to them.
+template <typename T>
+class EntityPool
+{
+ public:
+  static constexpr std::size_t CHUNK_SIZE = 64;
+  static constexpr uint32_t NO_SLOT = EntityLink::NONE;
+
+  EntityPool() = default;
+  EntityPool(const EntityPool&) = delete;
+  EntityPool& operator=(const EntityPool&) = delete;
+  ~EntityPool() { clear(); }
+
+  template <typename... Args>
+  T& emplace(Args&&... args)
+  {
+    std::size_t index;
+    if (!free_.empty())
+    {
+      index = free_.back();
+      free_.pop_back();
+    }
+    else
+    {
+      index = num_slots_++;
+      if (index / CHUNK_SIZE == chunks_.size())
+      {
+        chunks_.push_back(std::make_unique<Chunk>());
+      }
+    }
+    auto& chunk = *chunks_[index / CHUNK_SIZE];
+    auto* entity = new (&chunk.slots[index % CHUNK_SIZE]) T(std::forward<Args>(args)...);
+    chunk.alive.set(index % CHUNK_SIZE);
+    size_++;
+    return *entity;
+  }
+
+  // Destroys the given entity, which must have been created by this pool
+  void erase(const T* entity)
+  {
+    for (std::size_t chunk_index = 0; chunk_index < chunks_.size(); chunk_index++)
+    {
+      auto& chunk = *chunks_[chunk_index];
+      const auto* first = chunk.get(0);
+      if (entity >= first && entity < first + CHUNK_SIZE)
+      {
+        const auto slot = static_cast<std::size_t>(entity - first);
+        chunk.get(slot)->~T();
+        chunk.alive.reset(slot);
+        free_.push_back((chunk_index * CHUNK_SIZE) + slot);
+        size_--;
+        return;
+      }
+    }
+  }
+
+  void clear()
+  {
+    for (auto& chunk : chunks_)
+    {
+      for (std::size_t slot = 0; slot < CHUNK_SIZE; slot++)
+      {
+        if (chunk->alive.test(slot))
+        {
+          chunk->get(slot)->~T();
+        }
+      }
+    }
+    chunks_.clear();
+    free_.clear();
+    num_slots_ = 0;
+    size_ = 0;
+  }
+
+  // Replaces the entities of this pool with copies of the entities of other, in the same slots
+  void copy_from(const EntityPool& other)
+  {
+    clear();
+    chunks_.reserve(other.chunks_.size());
+    for (const auto& other_chunk : other.chunks_)
+    {
+      auto chunk = std::make_unique<Chunk>();
+      for (std::size_t slot = 0; slot < CHUNK_SIZE; slot++)
+      {
+        if (other_chunk->alive.test(slot))
+        {
+          new (&chunk->slots[slot]) T(*other_chunk->get(slot));
+        }
+      }
+      chunk->alive = other_chunk->alive;
+      chunks_.push_back(std::move(chunk));
+    }
+    free_ = other.free_;
+    num_slots_ = other.num_slots_;
+    size_ = other.size_;
+  }
+
+  // Returns the address in this pool corresponding to pointer in other, where this pool is a copy of other,
+  // or null if pointer does not point into other
+  // pointer may point to a base class subobject of an entity, or to the slot of an erased entity
+  template <typename U>
+  U* relocate(const EntityPool& other, const U* pointer) const
+  {
+    const auto* address = reinterpret_cast<const unsigned char*>(pointer);
+    for (std::size_t chunk_index = 0; chunk_index < other.chunks_.size() && chunk_index < chunks_.size(); chunk_index++)
+    {
+      const auto* first = reinterpret_cast<const unsigned char*>(other.chunks_[chunk_index]->slots);
+      if (address >= first && address < first + sizeof(Chunk::slots))
+      {
+        auto* copy = reinterpret_cast<unsigned char*>(chunks_[chunk_index]->slots);
+        return reinterpret_cast<U*>(copy + (address - first));
+      }
+    }
+    return nullptr;
+  }
+
+  // Returns the slot of the entity pointer points to, or NO_SLOT if it does not point into this pool
+  // pointer may point to a base class subobject of an entity
+  template <typename U>
+  uint32_t find_slot(const U* pointer) const
+  {
+    const auto* address = reinterpret_cast<const unsigned char*>(pointer);
+    for (std::size_t chunk_index = 0; chunk_index < chunks_.size(); chunk_index++)
+    {
+      const auto* first = reinterpret_cast<const unsigned char*>(chunks_[chunk_index]->slots);
+      if (address >= first && address < first + sizeof(Chunk::slots))
+      {
+        return static_cast<uint32_t>((chunk_index * CHUNK_SIZE) + ((address - first) / sizeof(Chunk::slots[0])));
+      }
+    }
+    return NO_SLOT;
+  }
+
+  // Returns the entity in slot, or null if there is none
+  T* get(const uint32_t slot)
+  {
+    if (slot >= num_slots_ || !chunks_[slot / CHUNK_SIZE]->alive.test(slot % CHUNK_SIZE))
+    {
+      return nullptr;
+    }
+    return chunks_[slot / CHUNK_SIZE]->get(slot % CHUNK_SIZE);
+  }
+
+  const T* get(const uint32_t slot) const { return const_cast<EntityPool*>(this)->get(slot); }
+
+  // Appends which slots are used to snapshot, see save_entities
+  void save_slots(Snapshot& snapshot) const
+  {
+    // The free list is padded to the number of slots, so that the data after it stays at the same offset
+    snapshot.write(static_cast<uint64_t>(num_slots_));
+    snapshot.write_vector(free_);
+    snapshot.write_zeros((num_slots_ - free_.size()) * sizeof(free_[0]));
+    for (std::size_t chunk_index = 0; chunk_index * CHUNK_SIZE < num_slots_; chunk_index++)
+    {
+      snapshot.write(static_cast<uint64_t>(chunks_[chunk_index]->alive.to_ullong()));
+    }
+  }
+
+  // Appends the fields of the entities to snapshot, by calling T::save(snapshot, args...) slot by slot
+  // Free slots are written as a default constructed entity, so each slot stays at the same offset.
+  template <typename... Args>
+  void save_entities(Snapshot& snapshot, const Args&... args) const
+  {
+    for (std::size_t index = 0; index < num_slots_; index++)
+    {
+      const auto& chunk = *chunks_[index / CHUNK_SIZE];
+      if (chunk.alive.test(index % CHUNK_SIZE))
+      {
+        chunk.get(index % CHUNK_SIZE)->save(snapshot, args...);
+      }
+      else
+      {
+        T().save(snapshot, args...);
+      }
+    }
+  }
+
+  // Restores the slots saved by save_slots, entities are kept in the slots that are used in both and default
+  // constructed in the others, restore_entities then restores their fields
+  // On failure every used slot still holds a valid entity, but the pool should be discarded.
+  bool restore_slots(Snapshot::Reader& reader)
+  {
+    uint64_t num_slots;
+    if (!reader.read(num_slots) || num_slots > UINT32_MAX || !reader.read_vector(free_) || free_.size() > num_slots ||
+        !reader.skip((num_slots - free_.size()) * sizeof(free_[0])))
+    {
+      return false;
+    }
+    // Checked before allocating any chunks, so that a corrupt number of slots does not allocate
+    const auto num_chunks = static_cast<std::size_t>((num_slots + CHUNK_SIZE - 1u) / CHUNK_SIZE);
+    if (reader.remaining() < num_chunks * sizeof(uint64_t))
+    {
+      return false;
+    }
+    while (chunks_.size() < num_chunks)
+    {
+      chunks_.push_back(std::make_unique<Chunk>());
+    }
+
+    size_ = 0;
+    for (std::size_t chunk_index = 0; chunk_index < chunks_.size(); chunk_index++)
+    {
+      auto& chunk = *chunks_[chunk_index];
+      uint64_t alive = 0u;
+      if (chunk_index < num_chunks)
+      {
+        reader.read(alive);
+      }
+      // Slots past the end are never used
+      const auto end = num_slots - std::min<uint64_t>(num_slots, chunk_index * CHUNK_SIZE);
+      if (end < CHUNK_SIZE)
+      {
+        alive &= (uint64_t(1) << end) - 1u;
+      }
+      for (std::size_t slot = 0; slot < CHUNK_SIZE; slot++)
+      {
+        const bool was_alive = chunk.alive.test(slot);
+        const bool is_alive = ((alive >> slot) & 1u) != 0u;
+        if (was_alive && !is_alive)
+        {
+          chunk.get(slot)->~T();
+        }
+        else if (!was_alive && is_alive)
+        {
+          new (&chunk.slots[slot]) T();
+        }
+      }
+      chunk.alive = std::bitset<CHUNK_SIZE>(alive);
+      size_ += chunk.alive.count();
+    }
+    num_slots_ = num_slots;
+
+    // Each free slot must be listed exactly once, so that emplace never constructs an entity over another one
+    // The listed slots are marked as used while checking, to find duplicates without allocating
+    if (free_.size() != num_slots_ - size_)
+    {
+      return false;
+    }
+    std::size_t num_checked = 0;
+    for (; num_checked < free_.size(); num_checked++)
+    {
+      const auto index = free_[num_checked];
+      if (index >= num_slots_ || chunks_[index / CHUNK_SIZE]->alive.test(index % CHUNK_SIZE))
+      {
+        break;
+      }
+      chunks_[index / CHUNK_SIZE]->alive.set(index % CHUNK_SIZE);
+    }
+    for (std::size_t i = 0; i < num_checked; i++)
+    {
+      chunks_[free_[i] / CHUNK_SIZE]->alive.reset(free_[i] % CHUNK_SIZE);
+    }
+    return num_checked == free_.size();
+  }
+
+  // Restores the fields saved by save_entities, by calling T::restore(reader, args...) slot by slot
+  template <typename... Args>
+  bool restore_entities(Snapshot::Reader& reader, Args&... args)
+  {
+    for (std::size_t index = 0; index < num_slots_; index++)
+    {
+      auto& chunk = *chunks_[index / CHUNK_SIZE];
+      if (chunk.alive.test(index % CHUNK_SIZE))
+      {
+        if (!chunk.get(index % CHUNK_SIZE)->restore(reader, args...))
+        {
+          return false;
+        }
+      }
+      else if (!T().restore(reader, args...))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void swap(EntityPool& other)
+  {
+    chunks_.swap(other.chunks_);
+    free_.swap(other.free_);
+    std::swap(num_slots_, other.num_slots_);
+    std::swap(size_, other.size_);
+  }
+
+  std::size_t size() const { return size_; }
+
+  // Calls f for each entity, in slot order
+  // f may create and erase entities, entities created in a new slot are visited in the same call
+  template <typename F>
+  void for_each(F&& f)
+  {
+    for (std::size_t index = 0; index < num_slots_; index++)
+    {
+      auto& chunk = *chunks_[index / CHUNK_SIZE];
+      if (chunk.alive.test(index % CHUNK_SIZE))
+      {
+        f(*chunk.get(index % CHUNK_SIZE));
+      }
+    }
+  }
+
+  template <typename F>
+  void for_each(F&& f) const
+  {
+    for (std::size_t index = 0; index < num_slots_; index++)
+    {
+      const auto& chunk = *chunks_[index / CHUNK_SIZE];
+      if (chunk.alive.test(index % CHUNK_SIZE))
+      {
+        f(*chunk.get(index % CHUNK_SIZE));
+      }
+    }
+  }
+
+ private:
+  static_assert(CHUNK_SIZE <= 64, "The alive bits of a chunk are saved as a 64-bit integer");
+
+  struct Chunk
+  {
+    T* get(const std::size_t slot) { return std::launder(reinterpret_cast<T*>(&slots[slot])); }
+    const T* get(const std::size_t slot) const { return std::launder(reinterpret_cast<const T*>(&slots[slot])); }
+
+    std::aligned_storage_t<sizeof(T), alignof(T)> slots[CHUNK_SIZE];
+    std::bitset<CHUNK_SIZE> alive;
+  };
+
+  std::vector<std::unique_ptr<Chunk>> chunks_;
+  std::vector<std::size_t> free_;
+  std::size_t num_slots_ = 0;
+  std::size_t size_ = 0;
+};
+
+// One EntityPool per concrete type
+// for_each visits the pools in the order the types are listed, and calls f with the concrete type so that
+// calls to final member functions are resolved at compile time.
+template <typename... Ts>
+class EntityPools
+{
+ public:
+  template <typename T>
+  EntityPool<T>& get()
+  {
+    return std::get<EntityPool<T>>(pools_);
+  }
+
+  template <typename T>
+  const EntityPool<T>& get() const
+  {
+    return std::get<EntityPool<T>>(pools_);
+  }
+
+  template <typename F>
+  void for_each(F&& f)
+  {
+    std::apply([&f](auto&... pools) { (pools.for_each(f), ...); }, pools_);
+  }
+
+  template <typename F>
+  void for_each(F&& f) const
+  {
+    std::apply([&f](const auto&... pools) { (pools.for_each(f), ...); }, pools_);
+  }
+
+  void clear()
+  {
+    std::apply([](auto&... pools) { (pools.clear(), ...); }, pools_);
+  }
+
+  void copy_from(const EntityPools& other) { (get<Ts>().copy_from(other.get<Ts>()), ...); }
+
+  // See EntityPool::save_slots and EntityPool::save_entities
+  // The slots of all pools of a level are saved before their entities, so that an entity referring to an entity in a
+  // later pool can be restored.
+  void save_slots(Snapshot& snapshot) const { (get<Ts>().save_slots(snapshot), ...); }
+
+  template <typename... Args>
+  void save_entities(Snapshot& snapshot, const Args&... args) const
+  {
+    (get<Ts>().save_entities(snapshot, args...), ...);
+  }
+
+  bool restore_slots(Snapshot::Reader& reader)
+  {
+    return (get<Ts>().restore_slots(reader) && ...);
+  }
+
+  template <typename... Args>
+  bool restore_entities(Snapshot::Reader& reader, Args&... args)
+  {
+    return (get<Ts>().restore_entities(reader, args...) && ...);
+  }
+
+  // Returns the link to the entity pointer points to, or a link of type EntityLink::NONE if there is none
+  template <typename U>
+  EntityLink find_link(const U* pointer) const
+  {
+    EntityLink link = {EntityLink::NONE, EntityLink::NONE};
+    uint32_t type = 0u;
+    const auto find_in = [&link, &type, pointer](const auto& pool)
+    {
+      const auto slot = link.type == EntityLink::NONE ? pool.find_slot(pointer) : EntityLink::NONE;
+      if (slot != EntityLink::NONE)
+      {
+        link = {type, slot};
+      }
+      type++;
+    };
+    std::apply([&find_in](const auto&... pools) { (find_in(pools), ...); }, pools_);
+    return link;
+  }
+
+  // Returns the entity link refers to as U*, or null if there is none
+  template <typename U>
+  U* get_linked(const EntityLink& link)
+  {
+    U* entity = nullptr;
+    uint32_t type = 0u;
+    const auto get_in = [&entity, &type, &link](auto& pool)
+    {
+      if (type++ == link.type)
+      {
+        entity = pool.get(link.slot);
+      }
+    };
+    std::apply([&get_in](auto&... pools) { (get_in(pools), ...); }, pools_);
+    return entity;
+  }
+
+  // Same as EntityPool::relocate, for a pointer into any of the pools
+  template <typename U>
+  U* relocate(const EntityPools& other, const U* pointer) const
+  {
+    U* result = nullptr;
+    ((result = result ? result : get<Ts>().relocate(other.get<Ts>(), pointer)), ...);
+    return result;
+  }
+
+  void swap(EntityPools& other) { (get<Ts>().swap(other.get<Ts>()), ...); }
+
+  std::size_t size() const
+  {
+    return std::apply([](const auto&... pools) { return (pools.size() + ... + 0); }, pools_);
+  }
+
+ private:
+  std::tuple<EntityPool<Ts>...> pools_;
+};
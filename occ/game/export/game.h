@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -11,20 +12,40 @@
 #include "object.h"
 #include "player.h"
 #include "player_input.h"
+#include "snapshot.h"
 #include "tile.h"
 
+class LevelCache;
 struct Level;
 
+// The game is updated every MS_PER_UPDATE milliseconds (17.5~ ticks per second)
+static constexpr unsigned MS_PER_UPDATE = 57;
+
 class Game
 {
  public:
-  static std::unique_ptr<Game> create();
+  // Levels are loaded and simulated with random generators seeded from seed, so games with the same seed and
+  // the same input play out the same
+  // Levels are loaded into level_cache, which games (e.g. many games simulated in parallel) can share so that each level
+  // is only loaded once, a game creates its own if it is not set.
+  static std::unique_ptr<Game> create(const uint64_t seed = 0u, std::shared_ptr<LevelCache> level_cache = nullptr);
 
   virtual ~Game() = default;
 
+  virtual uint64_t get_seed() const = 0;
+
   virtual bool init(const ExeData& exe_data, const LevelId level) = 0;
+  // Starts the game in an already created and finalized level (e.g. a generated level for tests and benchmarks)
+  virtual bool init(std::unique_ptr<Level> level) = 0;
   virtual void update(unsigned game_tick, const PlayerInput& player_input) = 0;
 
+  // Replaces the contents of snapshot with the state of the game (player, entities, items, score, ...), reusing
+  // its memory. A snapshot can be restored any number of times into any game playing the same level, restore
+  // returns false and leaves the game unchanged for snapshots of other levels or corrupt snapshots.
+  // Note: restore replaces the level, so references returned by get_level are invalidated.
+  virtual void snapshot(Snapshot& snapshot) const = 0;
+  virtual bool restore(const Snapshot& snapshot) = 0;
+
   virtual const Player& get_player() const = 0;
 
   virtual const Level& get_level() const = 0;
@@ -38,6 +59,16 @@ class Game
 
   virtual const std::vector<Object>& get_objects() const = 0;
 
+  // Only entities within radius pixels of an area of the given size centered on the player (e.g. the camera)
+  // are simulated, the others sleep until they are within it again. A negative radius simulates all entities.
+  virtual void set_activity_area(const geometry::Size& size, const int radius) = 0;
+  // Returns the number of enemies, hazards, actors and moving platforms simulated in the last update
+  virtual unsigned get_num_simulated() const = 0;
+  // Levels behind entrances (and the main level behind the exit) within distance tiles of the player, and the
+  // current level for restarts, are prepared on a worker thread so that init does not have to load them.
+  // A negative distance (the default) disables this.
+  virtual void set_prefetch_distance(const int distance) = 0;
+
   virtual unsigned get_score() const = 0;
   virtual unsigned get_num_ammo() const = 0;
   virtual unsigned get_num_lives() const = 0;
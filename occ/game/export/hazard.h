@@ -4,6 +4,7 @@
 #include "actor.h"
 #include "geometry.h"
 #include "misc.h"
+#include "snapshot.h"
 #include "sprite.h"
 
 struct Level;
@@ -14,9 +15,12 @@ class Hazard : public Actor
  public:
   Hazard(geometry::Position position) : Actor(position, geometry::Size(16, 16)) {}
   virtual ~Hazard() = default;
+
+  // Hazards outside the activity area sleep unless this returns false
+  virtual bool can_sleep() const { return true; }
 };
 
-class AirTank : public Hazard
+class AirTank final : public Hazard
 {
   // ⬛⬜⬛⬛⬛⬛⬛⬛⬛⬛⬛⬛⬛⬛⬜⬛
   // ⬜⬛⚪⚪⚪⚪⚪⚪⚪⚪⚪⚪⚪⚪⬛🪦
@@ -37,9 +41,12 @@ class AirTank : public Hazard
   // Die if shot
  public:
   AirTank(geometry::Position position, bool top) : Hazard(position), top_(top) {}
+  AirTank() : AirTank(geometry::Position(), false) {}
 
   virtual void update(const geometry::Rectangle& player_rect, Level& level) override;
-  virtual std::vector<std::pair<geometry::Position, Sprite>> get_sprites(const Level& level) const override;
+  virtual void get_sprites(const Level& level, SpriteSink& sink) const override;
+  virtual void save(Snapshot& snapshot, const Level& level) const override;
+  virtual bool restore(Snapshot::Reader& reader, Level& level) override;
 
  private:
   bool top_;
@@ -48,7 +55,7 @@ class AirTank : public Hazard
 
 class LaserBeam;
 
-class Laser : public Hazard
+class Laser final : public Hazard
 {
   // ⚫🩵🩵⚫⚫⚫⚫⚫⚫⚫⚫⚫⚫⚫⚫⚫
   // ⚫🔴🟥🩵🩵⚫⚫⚫⚫⚫⚫⚫⚫⚫⚫⚫
@@ -65,24 +72,28 @@ class Laser : public Hazard
   // Faces left/right, fires slow laser at player when they enter line
  public:
   Laser(geometry::Position position, bool left) : Hazard(position), left_(left) {}
+  Laser() : Laser(geometry::Position(), false) {}
 
   virtual void update(const geometry::Rectangle& player_rect, Level& level) override;
-  virtual std::vector<std::pair<geometry::Position, Sprite>> get_sprites([[maybe_unused]] const Level& level) const override
+  virtual void get_sprites([[maybe_unused]] const Level& level, SpriteSink& sink) const override
   {
-    return {std::make_pair(position, left_ ? Sprite::SPRITE_LASER_L : Sprite::SPRITE_LASER_R)};
+    sink.add(position, left_ ? Sprite::SPRITE_LASER_L : Sprite::SPRITE_LASER_R);
   }
-  virtual std::vector<geometry::Rectangle> get_detection_rects(const Level& level) const override
+  virtual DetectionRects get_detection_rects(const Level& level) const override
   {
     return create_detection_rects(left_ ? -1 : 1, 0, level);
   }
+  virtual void on_clone(const Level& original, const Level& clone) override;
   void remove_child() { child_ = nullptr; }
+  virtual void save(Snapshot& snapshot, const Level& level) const override;
+  virtual bool restore(Snapshot::Reader& reader, Level& level) override;
 
  private:
   bool left_;
   LaserBeam* child_ = nullptr;
 };
 
-class LaserBeam : public Hazard
+class LaserBeam final : public Hazard
 {
   // 🟥⬛⬛⬛⬛⬛⬛⬛⬛⬛⬛⬛⬛⬛⬛🟥
   // ⬛🟥🚨🚨⬛⬛🟥⬛🚨⬛🟥🟥🟥⬛🟥⬛
@@ -91,23 +102,29 @@ class LaserBeam : public Hazard
   // ⬛⬛⬛⬛⬛🚨⬛⬛⬛⬛⬛⬛🚨🚨⬛⬛
   // Moves left/right, disappear on collide or out of frame
  public:
-  LaserBeam(geometry::Position position, bool left, Laser& parent) : Hazard(position), left_(left), parent_(parent) {}
+  LaserBeam(geometry::Position position, bool left, Laser& parent) : Hazard(position), left_(left), parent_(&parent) {}
+  LaserBeam() : Hazard(geometry::Position()), left_(false), parent_(nullptr) {}
 
   virtual void update(const geometry::Rectangle& player_rect, Level& level) override;
-  virtual std::vector<std::pair<geometry::Position, Sprite>> get_sprites([[maybe_unused]] const Level& level) const override
+  virtual void get_sprites([[maybe_unused]] const Level& level, SpriteSink& sink) const override
   {
-    return {std::make_pair(position, frame_ == 0 ? Sprite::SPRITE_LASER_BEAM_1 : Sprite::SPRITE_LASER_BEAM_2)};
+    sink.add(position, frame_ == 0 ? Sprite::SPRITE_LASER_BEAM_1 : Sprite::SPRITE_LASER_BEAM_2);
   }
   virtual bool is_alive() const override { return alive_; }
+  // Keeps moving until it hits something, as the parent can not fire again until then
+  virtual bool can_sleep() const override { return false; }
+  virtual void on_clone(const Level& original, const Level& clone) override;
+  virtual void save(Snapshot& snapshot, const Level& level) const override;
+  virtual bool restore(Snapshot::Reader& reader, Level& level) override;
 
  private:
   bool left_;
   int frame_ = 0;
-  Laser& parent_;
+  Laser* parent_;
   bool alive_ = true;
 };
 
-class Thorn : public Hazard
+class Thorn final : public Hazard
 {
   // ⬛⬛⬛⬛⬛⬛⬛🦚⬛⬛⬛⬛⬛⬛⬛⬛
   // ⬛⬛⬛⬛⬛⬛⬛🦚⬛⬛⬛⬛⬛⬛⬛⬛
@@ -122,22 +139,25 @@ class Thorn : public Hazard
   // Thrusts up when player is above
  public:
   Thorn(geometry::Position position) : Hazard(position) {}
+  Thorn() : Thorn(geometry::Position()) {}
 
   virtual void update(const geometry::Rectangle& player_rect, Level& level) override;
-  virtual std::vector<std::pair<geometry::Position, Sprite>> get_sprites([[maybe_unused]] const Level& level) const override
+  virtual void get_sprites([[maybe_unused]] const Level& level, SpriteSink& sink) const override
   {
-    return {std::make_pair(position, static_cast<Sprite>(static_cast<int>(Sprite::SPRITE_THORN_1) + frame_))};
+    sink.add(position, static_cast<Sprite>(static_cast<int>(Sprite::SPRITE_THORN_1) + frame_));
   }
-  virtual std::vector<geometry::Rectangle> get_detection_rects(const Level& level) const override
+  virtual DetectionRects get_detection_rects(const Level& level) const override
   {
     return create_detection_rects(0, -1, level, true);
   }
+  virtual void save(Snapshot& snapshot, const Level& level) const override;
+  virtual bool restore(Snapshot::Reader& reader, Level& level) override;
 
  private:
   int frame_ = 0;
 };
 
-class SpiderWeb : public Hazard
+class SpiderWeb final : public Hazard
 {
   // ⬛⚪⬛⬛⬛⬛⬛⚪⬛⬛⬛⬛⬛⬛⚪⬛
   // ⬛⚪⬜⬜⬛⬛⬛⚪⬛⬛⬛⬛⬛⬛⚪⬛
@@ -155,22 +175,30 @@ class SpiderWeb : public Hazard
   // ⬛⚪⬜⬜⬛⬛⬛⬛⚪⬛⬛⬜⬜⚪⬛⬛
   // Moves down, disappear on collide or out of frame
  public:
-  SpiderWeb(geometry::Position position, Spider& parent) : Hazard(position), parent_(parent) {}
+  SpiderWeb(geometry::Position position, Spider& parent) : Hazard(position), parent_(&parent) {}
+  SpiderWeb() : Hazard(geometry::Position()), parent_(nullptr) {}
 
   virtual void update(const geometry::Rectangle& player_rect, Level& level) override;
-  virtual std::vector<std::pair<geometry::Position, Sprite>> get_sprites([[maybe_unused]] const Level& level) const override
+  virtual void get_sprites([[maybe_unused]] const Level& level, SpriteSink& sink) const override
   {
-    return {std::make_pair(position, Sprite::SPRITE_SPIDER_WEB)};
+    sink.add(position, Sprite::SPRITE_SPIDER_WEB);
   }
   virtual bool is_alive() const override { return alive_; }
+  // Keeps moving until it hits something, as the parent can not fire again until then
+  virtual bool can_sleep() const override { return false; }
+  virtual void on_clone(const Level& original, const Level& clone) override;
+  virtual void save(Snapshot& snapshot, const Level& level) const override;
+  virtual bool restore(Snapshot::Reader& reader, Level& level) override;
+  // Called when the parent dies, the web keeps falling on its own
+  void remove_parent() { parent_ = nullptr; }
 
  private:
-  Spider& parent_;
+  Spider* parent_;
   bool alive_ = true;
 };
 
 
-class CorpseSlime : public Hazard
+class CorpseSlime final : public Hazard
 {
   // ⬛⬛⬛⬛⬛⬛⬛⬛⬛🟪🟪🟪🟪⬛⬛⬛
   // ⬛⬛🟪🟪🟪🟪🟪🟪🟪🟣🟣🟣🟣🟪⬛⬛
@@ -182,12 +210,15 @@ class CorpseSlime : public Hazard
   // Hurts player if they step on it; created by dead snake/tentacle
  public:
   CorpseSlime(geometry::Position position, Sprite sprite) : Hazard(position), sprite_(sprite) {}
+  CorpseSlime() : CorpseSlime(geometry::Position(), Sprite::SPRITE_NONE) {}
 
   virtual void update(const geometry::Rectangle& player_rect, Level& level) override;
-  virtual std::vector<std::pair<geometry::Position, Sprite>> get_sprites([[maybe_unused]] const Level& level) const override
+  virtual void get_sprites([[maybe_unused]] const Level& level, SpriteSink& sink) const override
   {
-    return {std::make_pair(position, sprite_)};
+    sink.add(position, sprite_);
   }
+  virtual void save(Snapshot& snapshot, const Level& level) const override;
+  virtual bool restore(Snapshot::Reader& reader, Level& level) override;
 
  private:
   Sprite sprite_;
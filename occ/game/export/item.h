@@ -16,9 +16,9 @@ enum class ItemType : int
 class Item
 {
  public:
-  Item() : valid_(false), sprite_(Sprite::SPRITE_NONE), type_(ItemType::ITEM_TYPE_CRYSTAL), amount_(0) {}
+  constexpr Item() : valid_(false), sprite_(Sprite::SPRITE_NONE), type_(ItemType::ITEM_TYPE_CRYSTAL), amount_(0) {}
 
-  Item(Sprite sprite, ItemType type, int amount) : valid_(true), sprite_(sprite), type_(type), amount_(amount) {}
+  constexpr Item(Sprite sprite, ItemType type, int amount) : valid_(true), sprite_(sprite), type_(type), amount_(amount) {}
 
   bool valid() const { return valid_; }
   void invalidate() { valid_ = false; }
@@ -27,6 +27,7 @@ class Item
   ItemType get_type() const { return type_; }
   int get_amount() const { return amount_; }
 
+  // Returned for items outside the level, see INVALID below
   static const Item INVALID;
 
  private:
@@ -35,3 +36,6 @@ class Item
   ItemType type_;
   int amount_;
 };
+
+// Constant initialized like Tile::INVALID
+inline constexpr Item Item::INVALID{};
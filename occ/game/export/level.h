@@ -0,0 +1,179 @@
+#pragma once
+
+#include <bitset>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "enemy.h"
+#include "entity_pool.h"
+#include "entrance.h"
+#include "exit.h"
+#include "geometry.h"
+#include "hazard.h"
+#include "item.h"
+#include "level_id.h"
+#include "moving_platform.h"
+#include "random.h"
+#include "snapshot.h"
+#include "spatial_index.h"
+#include "sprite.h"
+#include "tile.h"
+#include "tile_masks.h"
+
+struct Level
+{
+  LevelId level_id;
+
+  int width;
+  int height;
+
+  geometry::Position player_spawn;
+
+  const Tile& get_tile(const int x, const int y) const;
+  int get_bg(const int x, const int y) const;
+  const Item& get_item(const int x, const int y) const;
+  void remove_item(const int x, const int y);
+  bool collides_solid(const geometry::Position& position, const geometry::Size& size, const bool is_slime = false) const;
+  // Returns true if any tile covered by the rectangle has any of the given TileFlags
+  bool collides_tile(const geometry::Position& position, const geometry::Size& size, const int flags) const;
+
+  // Builds the tile masks from the tiles and sizes the spatial indexes to the level
+  // Call once width, height and tiles are set, before the level is played. Entities can be added before or after.
+  void finalize();
+
+  // Returns a deep copy of the level, entities in the copy refer to each other instead of to the entities of this level
+  // Note: must be updated when adding members
+  std::unique_ptr<Level> clone() const;
+
+  // Saves the state that changes while the level is played (entities, items, switches, ...) to snapshot
+  // Entities refer to each other by slot in the snapshot, so it can be restored into any copy of the level it was
+  // saved from. If restore fails the level is left partially restored and must be discarded, see GameImpl::restore.
+  // Note: must be updated when adding members
+  void save(Snapshot& snapshot) const;
+  bool restore(Snapshot::Reader& reader);
+
+  // Used by entities to save and restore pointers to other entities, see Actor::save
+  // A pointer to the slot of an erased entity is saved as no link, as there is nothing to restore it to.
+  template <typename T>
+  void save_link(Snapshot& snapshot, const T* entity) const
+  {
+    const auto slot = entity ? get_pool<T>().find_slot(entity) : EntityLink::NONE;
+    snapshot.write(slot != EntityLink::NONE && get_pool<T>().get(slot) ? slot : EntityLink::NONE);
+  }
+
+  template <typename T>
+  bool restore_link(Snapshot::Reader& reader, T*& entity)
+  {
+    uint32_t slot;
+    if (!reader.read(slot))
+    {
+      return false;
+    }
+    entity = slot == EntityLink::NONE ? nullptr : get_pool<T>().get(slot);
+    return slot == EntityLink::NONE || entity;
+  }
+
+  // Returns the copy in this level of an entity of original, where this level is a clone of original
+  template <typename T>
+  T* relocate(const Level& original, const T* entity) const
+  {
+    if (auto* copy = enemies.relocate(original.enemies, entity))
+    {
+      return copy;
+    }
+    if (auto* copy = hazards.relocate(original.hazards, entity))
+    {
+      return copy;
+    }
+    return actors.relocate(original.actors, entity);
+  }
+
+  // Creates an entity in its pool and inserts it into the spatial index
+  template <typename T, typename... Args>
+  T& add_enemy(Args&&... args)
+  {
+    return add(enemies.get<T>(), enemy_index, std::forward<Args>(args)...);
+  }
+  template <typename T, typename... Args>
+  T& add_hazard(Args&&... args)
+  {
+    return add(hazards.get<T>(), hazard_index, std::forward<Args>(args)...);
+  }
+  template <typename T, typename... Args>
+  T& add_actor(Args&&... args)
+  {
+    return add(actors.get<T>(), actor_index, std::forward<Args>(args)...);
+  }
+
+  // Removes an entity from the spatial index and destroys it
+  template <typename T>
+  void remove_enemy(T& enemy)
+  {
+    enemy_index.remove(&enemy);
+    enemies.get<T>().erase(&enemy);
+  }
+  template <typename T>
+  void remove_hazard(T& hazard)
+  {
+    hazard_index.remove(&hazard);
+    hazards.get<T>().erase(&hazard);
+  }
+
+  std::vector<int> bgs;
+  std::vector<Tile> tiles;
+  std::vector<Item> items;
+  // Built from tiles by finalize
+  TileMasks tile_masks;
+
+  // Hazards spawned by other entities are listed after their spawner so that they are updated in the same tick
+  EntityPools<Bigfoot, Hopper, Slime, Snake, Spider> enemies;
+  EntityPools<AirTank, Laser, LaserBeam, Thorn, SpiderWeb, CorpseSlime> hazards;
+  EntityPools<Lever, Door, Switch> actors;
+  SpatialIndex enemy_index;
+  SpatialIndex hazard_index;
+  SpatialIndex actor_index;
+  std::vector<MovingPlatform> moving_platforms;
+  std::vector<Entrance> entrances;
+  std::unique_ptr<Exit> exit;
+  bool has_earth = false;
+  bool has_moon = false;
+  bool switch_on = false;
+  std::bitset<3> lever_on = {0};
+  // Used by the loader and by enemies, so that a level plays out the same for the same seed
+  Random random;
+
+ private:
+  template <typename T>
+  EntityPool<T>& get_pool()
+  {
+    if constexpr (std::is_base_of<Enemy, T>::value)
+    {
+      return enemies.get<T>();
+    }
+    else if constexpr (std::is_base_of<Hazard, T>::value)
+    {
+      return hazards.get<T>();
+    }
+    else
+    {
+      return actors.get<T>();
+    }
+  }
+
+  template <typename T>
+  const EntityPool<T>& get_pool() const
+  {
+    return const_cast<Level*>(this)->get_pool<T>();
+  }
+
+  template <typename T, typename... Args>
+  static T& add(EntityPool<T>& pool, SpatialIndex& index, Args&&... args)
+  {
+    auto& entity = pool.emplace(std::forward<Args>(args)...);
+    index.insert(&entity);
+    return entity;
+  }
+};
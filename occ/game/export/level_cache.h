@@ -0,0 +1,40 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "exe_data.h"
+#include "level.h"
+#include "level_id.h"
+#include "level_loader.h"
+
+// Fully loaded levels, one per LevelId, that are never modified
+// Starting a level again (e.g. after dying) only needs a clone of its prototype instead of loading it from the EXE data again.
+// The prototypes do not depend on the seed, only their clones are randomized (see LevelLoader::randomize), so one cache
+// can be shared by any number of games on any threads, see Game::create.
+class LevelCache
+{
+ public:
+  static constexpr int NUM_LEVELS = static_cast<int>(LevelId::LEVEL_16) + 1;
+
+  // Returns a clone of the level, loading its prototype the first time, or nullptr if the level could not be loaded
+  // The clone is randomized with seed
+  std::unique_ptr<Level> get(const ExeData& exe_data, const LevelId level_id, const uint64_t seed);
+
+  void clear();
+
+ private:
+  struct Prototype
+  {
+    std::unique_ptr<const Level> level;
+    std::vector<LevelLoader::RandomBackground> random_bgs;
+  };
+
+  std::mutex mutex_;
+  const ExeData* exe_data_ = nullptr;
+  // Shared with the threads cloning them, so that clearing the cache does not destroy a prototype being cloned
+  std::array<std::shared_ptr<const Prototype>, NUM_LEVELS> prototypes_;
+};
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "exe_data.h"
+#include "sprite.h"
+
+enum class LevelId;
+struct Level;
+
+namespace LevelLoader
+{
+
+// A background tile that is picked at random from sprites, see randomize
+struct RandomBackground
+{
+  int index;
+  const std::vector<Sprite>* sprites;
+};
+
+// The random generator of the level is seeded from seed and the level id, and also picks the star and horizon backgrounds
+std::unique_ptr<Level> load(const ExeData& exe_data, const LevelId level_id, const uint64_t seed);
+
+// Loads the level without seeding its random generator and without picking its random backgrounds, which are
+// added to random_bgs instead, so that the level can be shared by games with any seed (see LevelCache)
+std::unique_ptr<Level> load(const ExeData& exe_data, const LevelId level_id, std::vector<RandomBackground>& random_bgs);
+
+// Seeds the random generator of a level and picks its random backgrounds, as load with a seed does
+void randomize(Level& level, const std::vector<RandomBackground>& random_bgs, const uint64_t seed);
+
+}
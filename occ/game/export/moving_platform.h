@@ -1,6 +1,7 @@
 #pragma once
 
 #include "geometry.h"
+#include "snapshot.h"
 #include "vector.h"
 
 struct Level;
@@ -12,6 +13,10 @@ struct MovingPlatform
   void update(const Level& level);
   bool is_reverse() const { return velocity.x() > 0 || velocity.y() > 0; }
 
+  // Saves the fields that change while the level is played to snapshot and restores them, see Level::save
+  void save(Snapshot& snapshot) const;
+  bool restore(Snapshot::Reader& reader);
+
   geometry::Position position;
   const int sprite_id;
   const int num_sprites;  // >1 is animated
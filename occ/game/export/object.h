@@ -1,4 +1,10 @@
+#pragma once
+
+#include <vector>
+
 #include "geometry.h"
+#include "snapshot.h"
+#include "sprite.h"
 
 struct Object
 {
@@ -16,8 +22,35 @@ struct Object
     return (reverse ? num_sprites - 1 - d : d) + sprite_id;
   }
 
+  // Saved field by field, so that the padding after reverse is not part of the snapshot
+  void save(Snapshot& snapshot) const
+  {
+    snapshot.write(position);
+    snapshot.write(sprite_id);
+    snapshot.write(num_sprites);
+    snapshot.write(reverse);
+  }
+
+  bool restore(Snapshot::Reader& reader)
+  {
+    return reader.read(position) && reader.read(sprite_id) && reader.read(num_sprites) && reader.read(reverse);
+  }
+
   geometry::Position position;
   int sprite_id;
   int num_sprites;
   bool reverse;
 };
+
+// Appends the sprites of actors and other level objects to the object list of the current tick
+// The list keeps its capacity between ticks, so adding sprites does not allocate once the game is running
+class SpriteSink
+{
+ public:
+  explicit SpriteSink(std::vector<Object>& objects) : objects_(objects) {}
+
+  void add(const geometry::Position& position, const Sprite sprite) { objects_.emplace_back(position, static_cast<int>(sprite), 1, false); }
+
+ private:
+  std::vector<Object>& objects_;
+};
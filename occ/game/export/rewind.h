@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "game.h"
+#include "snapshot.h"
+
+// The last REWIND_TICKS ticks (about 30 seconds) are kept for rewinding, in a buffer of REWIND_BUFFER_SIZE bytes.
+// Every REWIND_KEYFRAME_INTERVAL ticks the whole game state is stored, and the other ticks as differences to it.
+static constexpr std::size_t REWIND_TICKS = 30 * 1000 / MS_PER_UPDATE;
+static constexpr std::size_t REWIND_BUFFER_SIZE = 2 * 1024 * 1024;
+static constexpr unsigned REWIND_KEYFRAME_INTERVAL = 32;
+
+// History of the last ticks of a game in a buffer of fixed size, for stepping the game backwards
+// Each tick is stored either as a keyframe (a whole snapshot) or as its difference to the last keyframe: the
+// snapshots XORed together and run-length encoded by 64-bit words, which is mostly runs of zero words as little
+// changes between ticks.
+// When the buffer is full the oldest keyframe and the ticks stored as differences to it are dropped.
+class Rewind
+{
+ public:
+  // capacity is the size of the buffer in bytes, and at most max_ticks ticks are kept
+  Rewind(const std::size_t capacity, const std::size_t max_ticks, const unsigned keyframe_interval);
+
+  // Call after each Game::update
+  void capture(const Game& game);
+  // Restores game to the tick before the last captured one, which is then forgotten
+  // Returns false if there is no earlier tick.
+  bool step_back(Game& game);
+  // Forgets all ticks, e.g. when another level is started as the snapshots can not be restored into it
+  void clear();
+
+  std::size_t get_num_ticks() const { return num_frames_; }
+  std::size_t get_bytes_used() const { return bytes_used_; }
+  std::size_t get_capacity() const { return buffer_.size(); }
+
+ private:
+  struct Frame
+  {
+    std::size_t offset;
+    std::size_t size;
+    bool keyframe;
+  };
+
+  Frame& get_frame(const std::size_t index) { return frames_[(first_frame_ + index) % frames_.size()]; }
+  const Frame& get_frame(const std::size_t index) const { return frames_[(first_frame_ + index) % frames_.size()]; }
+  // Returns the index of the keyframe of the frame at index
+  std::size_t get_keyframe(std::size_t index) const;
+
+  void encode(const Frame& keyframe);
+  void decode(const std::size_t index);
+  // Returns false if the frame could not be stored without dropping the keyframe it is a difference to
+  bool store(const unsigned char* data, const std::size_t size, const bool keyframe);
+  void drop_oldest();
+
+  std::vector<unsigned char> buffer_;
+  std::vector<Frame> frames_;
+  std::size_t first_frame_;
+  std::size_t num_frames_;
+  std::size_t bytes_used_;
+  unsigned keyframe_interval_;
+
+  // Reused between ticks so that capturing does not allocate
+  Snapshot snapshot_;
+  std::vector<uint64_t> xor_;
+  std::vector<unsigned char> scratch_;
+};
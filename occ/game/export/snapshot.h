@@ -0,0 +1,133 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+// Flat byte buffer holding the mutable state of a game, see Game::snapshot
+// The buffer holds no pointers into itself, so it can be copied, moved and compared bytewise.
+// Its memory is kept when it is cleared, so taking a snapshot every tick does not allocate.
+class Snapshot
+{
+ public:
+  class Reader
+  {
+   public:
+    explicit Reader(const Snapshot& snapshot) : snapshot_(snapshot), offset_(0u) {}
+
+    // Returns false if the snapshot is too short
+    bool read_bytes(void* data, const std::size_t size)
+    {
+      if (snapshot_.size_ - offset_ < size)
+      {
+        return false;
+      }
+      if (size == 0u)
+      {
+        return true;
+      }
+      std::memcpy(data, snapshot_.data_.data() + offset_, size);
+      offset_ += size;
+      return true;
+    }
+
+    // Skips padding written by write_zeros
+    bool skip(const std::size_t size)
+    {
+      if (snapshot_.size_ - offset_ < size)
+      {
+        return false;
+      }
+      offset_ += size;
+      return true;
+    }
+
+    template <typename T>
+    bool read(T& value)
+    {
+      static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values can be read");
+      return read_bytes(&value, sizeof(T));
+    }
+
+    // Types without a default constructor can only be read into a vector of the same size
+    template <typename T>
+    bool read_vector(std::vector<T>& values)
+    {
+      static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values can be read");
+      uint64_t size;
+      if (!read(size))
+      {
+        return false;
+      }
+      if constexpr (std::is_default_constructible<T>::value)
+      {
+        values.resize(size);
+      }
+      else if (values.size() != size)
+      {
+        return false;
+      }
+      return read_bytes(values.data(), size * sizeof(T));
+    }
+
+    std::size_t remaining() const { return snapshot_.size_ - offset_; }
+    bool at_end() const { return offset_ == snapshot_.size_; }
+
+   private:
+    const Snapshot& snapshot_;
+    std::size_t offset_;
+  };
+
+  void clear() { size_ = 0u; }
+
+  void write_bytes(const void* data, const std::size_t size)
+  {
+    // Snapshots are mostly written as many small values, so the buffer is grown by hand instead of by insert
+    if (size_ + size > data_.size())
+    {
+      data_.resize(std::max(size_ + size, 2u * data_.size()));
+    }
+    if (size > 0u)
+    {
+      std::memcpy(data_.data() + size_, data, size);
+    }
+    size_ += size;
+  }
+
+  // Used to pad sections that vary in size, so that the data after them stays at the same offset between snapshots
+  // and the snapshots differ in fewer bytes (see Rewind)
+  void write_zeros(const std::size_t size)
+  {
+    if (size_ + size > data_.size())
+    {
+      data_.resize(std::max(size_ + size, 2u * data_.size()));
+    }
+    std::memset(data_.data() + size_, 0, size);
+    size_ += size;
+  }
+
+  template <typename T>
+  void write(const T& value)
+  {
+    static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values can be written");
+    write_bytes(&value, sizeof(T));
+  }
+
+  template <typename T>
+  void write_vector(const std::vector<T>& values)
+  {
+    static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values can be written");
+    write(static_cast<uint64_t>(values.size()));
+    write_bytes(values.data(), values.size() * sizeof(T));
+  }
+
+  const unsigned char* data() const { return data_.data(); }
+  std::size_t size() const { return size_; }
+
+ private:
+  std::vector<unsigned char> data_;
+  std::size_t size_ = 0u;
+};
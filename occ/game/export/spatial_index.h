@@ -0,0 +1,203 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "actor.h"
+#include "entity_pool.h"
+#include "geometry.h"
+#include "snapshot.h"
+
+// Uniform grid broadphase for actors
+// Each bucket covers BUCKET_TILES x BUCKET_TILES tiles, and an actor is stored in every bucket
+// its rectangle overlaps. Actors that move must be updated after each move.
+// The buckets share one array, where each bucket has room for a number of entries that grows when it is full, and
+// entries refer to actors by the index of their record, so the whole index can be copied with a few bulk copies.
+class SpatialIndex
+{
+ public:
+  static constexpr int BUCKET_TILES = 2;
+  static constexpr int BUCKET_SIZE = BUCKET_TILES * 16;
+  static constexpr std::size_t BUCKET_CAPACITY = 4;
+
+  // Clears the index and resizes it to cover a level of the given size (in tiles)
+  void reset(const int width, const int height);
+  // Resizes the index to cover a level of the given size (in tiles), keeping the inserted actors
+  // Until the index is sized, actors can be inserted but queries find nothing.
+  void resize(const int width, const int height);
+
+  void insert(Actor* actor);
+  void remove(const Actor* actor);
+  void update(Actor* actor);
+
+  // Replaces this index with a copy of other, where relocate returns the copy of an actor of other
+  template <typename F>
+  void copy_from(const SpatialIndex& other, F relocate)
+  {
+    columns_ = other.columns_;
+    rows_ = other.rows_;
+    next_order_ = other.next_order_;
+    size_ = other.size_;
+    bucket_starts_ = other.bucket_starts_;
+    bucket_sizes_ = other.bucket_sizes_;
+    entries_ = other.entries_;
+    records_ = other.records_;
+    free_records_ = other.free_records_;
+    for (auto& record : records_)
+    {
+      if (record.actor)
+      {
+        record.actor = relocate(record.actor);
+      }
+    }
+  }
+
+  // Saves the index to snapshot, with the actors saved as their link in pools (see EntityLink)
+  template <typename Pools>
+  void save(Snapshot& snapshot, const Pools& pools) const
+  {
+    save_buckets(snapshot);
+    snapshot.write(static_cast<uint64_t>(records_.size()));
+    for (const auto& record : records_)
+    {
+      snapshot.write(record.actor ? pools.find_link(record.actor) : EntityLink{EntityLink::NONE, EntityLink::NONE});
+      snapshot.write(record.order);
+      snapshot.write(record.range);
+    }
+    snapshot.write_vector(free_records_);
+  }
+
+  // Restores an index saved by save into an index of the same size, with the actors looked up in pools
+  template <typename Pools>
+  bool restore(Snapshot::Reader& reader, Pools& pools)
+  {
+    uint64_t num_records;
+    if (!restore_buckets(reader) || !reader.read(num_records) ||
+        reader.remaining() / (sizeof(EntityLink) + sizeof(unsigned) + sizeof(Range)) < num_records)
+    {
+      return false;
+    }
+    records_.resize(num_records);
+    for (uint32_t index = 0u; index < records_.size(); index++)
+    {
+      auto& record = records_[index];
+      EntityLink link;
+      reader.read(link);
+      reader.read(record.order);
+      reader.read(record.range);
+      record.actor = link.type == EntityLink::NONE ? nullptr : pools.template get_linked<Actor>(link);
+      if (link.type != EntityLink::NONE && !record.actor)
+      {
+        return false;
+      }
+      if (record.actor)
+      {
+        record.actor->index_record = index;
+      }
+    }
+    return reader.read_vector(free_records_) && is_consistent();
+  }
+
+  std::size_t size() const { return size_; }
+
+  // Returns the first inserted actor colliding with rect for which pred returns true, or null if none found
+  template <typename Pred>
+  Actor* find_first(const geometry::Rectangle& rect, Pred pred) const
+  {
+    const auto range = get_range(rect);
+    const Record* found = nullptr;
+    for (int y = range.min_y; y <= range.max_y; y++)
+    {
+      for (int x = range.min_x; x <= range.max_x; x++)
+      {
+        const auto bucket = (y * columns_) + x;
+        for (auto i = bucket_starts_[bucket]; i < bucket_starts_[bucket] + bucket_sizes_[bucket]; i++)
+        {
+          const auto& record = records_[entries_[i]];
+          if ((!found || record.order < found->order) &&
+              geometry::isColliding(rect, geometry::Rectangle(record.actor->position, record.actor->size)) && pred(*record.actor))
+          {
+            found = &record;
+          }
+        }
+      }
+    }
+    return found ? found->actor : nullptr;
+  }
+
+  Actor* find_first(const geometry::Rectangle& rect) const
+  {
+    return find_first(rect, []([[maybe_unused]] const Actor& actor) { return true; });
+  }
+
+  // Calls f for each actor colliding with rect
+  // Note: an actor spanning multiple buckets may be visited more than once
+  template <typename F>
+  void for_each(const geometry::Rectangle& rect, F f) const
+  {
+    const auto range = get_range(rect);
+    for (int y = range.min_y; y <= range.max_y; y++)
+    {
+      for (int x = range.min_x; x <= range.max_x; x++)
+      {
+        const auto bucket = (y * columns_) + x;
+        for (auto i = bucket_starts_[bucket]; i < bucket_starts_[bucket] + bucket_sizes_[bucket]; i++)
+        {
+          auto* actor = records_[entries_[i]].actor;
+          if (geometry::isColliding(rect, geometry::Rectangle(actor->position, actor->size)))
+          {
+            f(*actor);
+          }
+        }
+      }
+    }
+  }
+
+ private:
+  struct Range
+  {
+    int min_x;
+    int min_y;
+    int max_x;
+    int max_y;
+
+    bool operator==(const Range& other) const
+    {
+      return min_x == other.min_x && min_y == other.min_y && max_x == other.max_x && max_y == other.max_y;
+    }
+  };
+
+  struct Record
+  {
+    // Null once the actor is removed, the record is then reused by the next inserted actor
+    Actor* actor;
+    unsigned order;
+    Range range;
+  };
+
+  void save_buckets(Snapshot& snapshot) const;
+  bool restore_buckets(Snapshot::Reader& reader);
+  // Returns true if the restored buckets and records refer to each other correctly
+  bool is_consistent() const;
+
+  // Returns the index of the record of actor, or Actor::NOT_INDEXED if it is not inserted
+  uint32_t find_record(const Actor* actor) const;
+  Range get_range(const geometry::Rectangle& rect) const;
+  void add_to_buckets(const Range& range, const uint32_t record);
+  void remove_from_buckets(const Range& range, const uint32_t record);
+  // Makes room for more entries in bucket, by moving the entries of the buckets after it
+  void grow_bucket(const int bucket);
+
+  int columns_ = 0;
+  int rows_ = 0;
+  unsigned next_order_ = 0u;
+  std::size_t size_ = 0u;
+  // Bucket i has room for the entries from bucket_starts_[i] up to bucket_starts_[i + 1], of which the first
+  // bucket_sizes_[i] are used
+  std::vector<uint32_t> bucket_starts_;
+  std::vector<uint32_t> bucket_sizes_;
+  std::vector<uint32_t> entries_;
+  // Records are reused instead of erased, so that inserting actors spawned during the game does not allocate
+  std::vector<Record> records_;
+  std::vector<uint32_t> free_records_;
+};
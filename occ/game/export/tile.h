@@ -14,14 +14,15 @@ enum TileFlags
 class Tile
 {
  public:
-  Tile() : valid_(false), sprite_(-1), sprite_count_(0), flags_(0) {}
+  constexpr Tile() : valid_(false), sprite_(-1), sprite_count_(0), flags_(0) {}
 
-  Tile(int sprite, int sprite_count, int flags) : valid_(true), sprite_(sprite), sprite_count_(sprite_count), flags_(flags) {}
+  constexpr Tile(int sprite, int sprite_count, int flags) : valid_(true), sprite_(sprite), sprite_count_(sprite_count), flags_(flags) {}
 
   bool valid() const { return valid_; }
 
   int get_sprite() const { return sprite_; }
   int get_sprite_count() const { return sprite_count_; }
+  int get_flags() const { return flags_; }
 
   bool is_solid() const { return !!(flags_ & TILE_SOLID); }
   bool is_solid_top() const { return (flags_ & 0x02) != 0; }
@@ -31,6 +32,7 @@ class Tile
   bool is_render_in_front() const { return (flags_ & 0x20) != 0; }
   bool is_solid_for_slime() const { return !!(flags_ & (TILE_BLOCKS_SLIME | TILE_SOLID)); }
 
+  // Returned for tiles outside the level, see INVALID below
   static const Tile INVALID;
 
  private:
@@ -39,3 +41,7 @@ class Tile
   int sprite_count_;
   int flags_;
 };
+
+// Constant initialized, so it is read-only and never depends on static initialization order, e.g. when games run
+// on several threads
+inline constexpr Tile Tile::INVALID{};
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "tile.h"
+
+// Packed per-row bitsets of the tile flags used for collision queries
+// (TILE_SOLID, TILE_SOLID_TOP, TILE_DAMAGE, TILE_DEATH and TILE_BLOCKS_SLIME)
+class TileMasks
+{
+ public:
+  void build(const std::vector<Tile>& tiles, const int width, const int height);
+
+  // Returns true if any tile in the given inclusive tile range has any of the given TileFlags
+  // The range is clipped to the level, tiles outside of the level have no flags
+  bool any(int min_x, int min_y, int max_x, int max_y, const int flags) const;
+
+ private:
+  static constexpr std::array<int, 5> MASK_FLAGS = {TILE_SOLID, TILE_SOLID_TOP, TILE_DAMAGE, TILE_DEATH, TILE_BLOCKS_SLIME};
+
+  int width_ = 0;
+  int height_ = 0;
+  int words_per_row_ = 0;
+  std::array<std::vector<std::uint64_t>, MASK_FLAGS.size()> masks_;
+};
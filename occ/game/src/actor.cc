@@ -2,14 +2,11 @@
 
 #include "level.h"
 
-std::vector<geometry::Rectangle> Actor::create_detection_rects(const int dx,
-                                                               const int dy,
-                                                               const Level& level,
-                                                               const bool include_self) const
+DetectionRects Actor::create_detection_rects(const int dx, const int dy, const Level& level, const bool include_self) const
 {
   // Create rectangles originating from this actor extending toward a cardinal direction,
   // until there is a solid collision.
-  std::vector<geometry::Rectangle> rects;
+  DetectionRects rects;
   if (dx == 1)
   {
     // right
@@ -108,6 +105,24 @@ std::vector<geometry::Rectangle> Actor::create_detection_rects(const int dx,
   return rects;
 }
 
+void Actor::save(Snapshot& snapshot, [[maybe_unused]] const Level& level) const
+{
+  // index_record is restored by SpatialIndex::restore
+  snapshot.write(position);
+  snapshot.write(size);
+}
+
+bool Actor::restore(Snapshot::Reader& reader, [[maybe_unused]] Level& level)
+{
+  return reader.read(position) && reader.read(size);
+}
+
+// Lever colors index Level::lever_on
+static bool is_valid(const LeverColor color)
+{
+  return color == LeverColor::LEVER_COLOR_R || color == LeverColor::LEVER_COLOR_B || color == LeverColor::LEVER_COLOR_G;
+}
+
 bool Lever::interact(Level& level)
 {
   if (!level.lever_on.test(static_cast<size_t>(color_)))
@@ -119,11 +134,22 @@ bool Lever::interact(Level& level)
   return false;
 }
 
-std::vector<std::pair<geometry::Position, Sprite>> Lever::get_sprites(const Level& level) const
+void Lever::get_sprites(const Level& level, SpriteSink& sink) const
 {
   const int sprite =
     static_cast<int>(Sprite::SPRITE_LEVER_R_OFF) + level.lever_on.test(static_cast<size_t>(color_)) + 2 * static_cast<int>(color_);
-  return {{position, static_cast<Sprite>(sprite)}};
+  sink.add(position, static_cast<Sprite>(sprite));
+}
+
+void Lever::save(Snapshot& snapshot, const Level& level) const
+{
+  Actor::save(snapshot, level);
+  snapshot.write(color_);
+}
+
+bool Lever::restore(Snapshot::Reader& reader, Level& level)
+{
+  return Actor::restore(reader, level) && reader.read(color_) && is_valid(color_);
 }
 
 bool Door::is_solid(const Level& level) const
@@ -131,28 +157,35 @@ bool Door::is_solid(const Level& level) const
   return !level.lever_on.test(static_cast<size_t>(color_));
 }
 
-std::vector<std::pair<geometry::Position, Sprite>> Door::get_sprites(const Level& level) const
+void Door::get_sprites(const Level& level, SpriteSink& sink) const
 {
   if (level.lever_on.test(static_cast<size_t>(color_)))
   {
     // Open
     const int sprite = static_cast<int>(Sprite::SPRITE_DOOR_OPEN_R_1) + 2 * static_cast<int>(color_);
-    return {
-      {position, static_cast<Sprite>(sprite)},
-      {position + geometry::Position(0, 16), static_cast<Sprite>(sprite + 1)},
-    };
+    sink.add(position, static_cast<Sprite>(sprite));
+    sink.add(position + geometry::Position(0, 16), static_cast<Sprite>(sprite + 1));
   }
   else
   {
     // Closed
     const int sprite = static_cast<int>(Sprite::SPRITE_DOOR_CLOSED_R_1) + static_cast<int>(color_);
-    return {
-      {position, static_cast<Sprite>(sprite)},
-      {position + geometry::Position(0, 16), static_cast<Sprite>(sprite + 4)},
-    };
+    sink.add(position, static_cast<Sprite>(sprite));
+    sink.add(position + geometry::Position(0, 16), static_cast<Sprite>(sprite + 4));
   }
 }
 
+void Door::save(Snapshot& snapshot, const Level& level) const
+{
+  Actor::save(snapshot, level);
+  snapshot.write(color_);
+}
+
+bool Door::restore(Snapshot::Reader& reader, Level& level)
+{
+  return Actor::restore(reader, level) && reader.read(color_) && is_valid(color_);
+}
+
 bool Switch::interact(Level& level)
 {
   level.switch_on = !level.switch_on;
@@ -160,7 +193,18 @@ bool Switch::interact(Level& level)
   return true;
 }
 
-std::vector<std::pair<geometry::Position, Sprite>> Switch::get_sprites(const Level& level) const
+void Switch::get_sprites(const Level& level, SpriteSink& sink) const
+{
+  sink.add(position, static_cast<Sprite>(static_cast<int>(sprite_) + static_cast<int>(level.switch_on)));
+}
+
+void Switch::save(Snapshot& snapshot, const Level& level) const
+{
+  Actor::save(snapshot, level);
+  snapshot.write(sprite_);
+}
+
+bool Switch::restore(Snapshot::Reader& reader, Level& level)
 {
-  return {{position, static_cast<Sprite>(static_cast<int>(sprite_) + static_cast<int>(level.switch_on))}};
+  return Actor::restore(reader, level) && reader.read(sprite_);
 }
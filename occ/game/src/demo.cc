@@ -0,0 +1,232 @@
+#include "demo.h"
+
+#include <cstring>
+#include <fstream>
+
+#include "logger.h"
+#include "mapped_file.h"
+
+namespace
+{
+// File layout: DemoHeader, then for each segment a SegmentHeader followed by its runs
+constexpr char DEMO_MAGIC[4] = {'O', 'C', 'C', 'D'};
+constexpr uint32_t DEMO_VERSION = 1u;
+
+struct DemoHeader
+{
+  char magic[4];
+  uint32_t version;
+  uint64_t seed;
+  int32_t activity_width;
+  int32_t activity_height;
+  int32_t activity_radius;
+  uint32_t num_segments;
+};
+
+struct SegmentHeader
+{
+  int32_t level;
+  uint32_t first_tick;
+  uint32_t num_runs;
+};
+
+// Bit i of a packed input is fields[i]
+constexpr bool PlayerInput::*fields[] = {
+  &PlayerInput::left,
+  &PlayerInput::right,
+  &PlayerInput::up,
+  &PlayerInput::down,
+  &PlayerInput::jump,
+  &PlayerInput::shoot,
+  &PlayerInput::left_pressed,
+  &PlayerInput::right_pressed,
+  &PlayerInput::up_pressed,
+  &PlayerInput::down_pressed,
+  &PlayerInput::jump_pressed,
+  &PlayerInput::shoot_pressed,
+  &PlayerInput::noclip_pressed,
+  &PlayerInput::ammo_pressed,
+  &PlayerInput::godmode_pressed,
+  &PlayerInput::reverse_gravity_pressed,
+  &PlayerInput::level_warp_pressed,
+};
+static_assert(sizeof(fields) / sizeof(fields[0]) <= 32u, "PlayerInput does not fit in a packed input");
+}
+
+std::unique_ptr<Demo> Demo::load(const std::filesystem::path& path)
+{
+  const auto file = MappedFile::open(path);
+  if (!file)
+  {
+    LOG_ERROR("Could not open demo '%s'", path.string().c_str());
+    return nullptr;
+  }
+
+  std::size_t offset = 0u;
+  const auto read = [&file, &offset](void* dest, const std::size_t size)
+  {
+    if (file->size() - offset < size)
+    {
+      return false;
+    }
+    std::memcpy(dest, file->data() + offset, size);
+    offset += size;
+    return true;
+  };
+
+  DemoHeader header;
+  if (!read(&header, sizeof(header)) || std::memcmp(header.magic, DEMO_MAGIC, sizeof(DEMO_MAGIC)) != 0 ||
+      header.version != DEMO_VERSION)
+  {
+    LOG_ERROR("'%s' is not a demo or has an unsupported version", path.string().c_str());
+    return nullptr;
+  }
+
+  auto demo = std::make_unique<Demo>(
+    header.seed, geometry::Size(header.activity_width, header.activity_height), header.activity_radius);
+  for (uint32_t i = 0u; i < header.num_segments; i++)
+  {
+    SegmentHeader segment_header;
+    if (!read(&segment_header, sizeof(segment_header)) || file->size() - offset < segment_header.num_runs * sizeof(Run))
+    {
+      LOG_ERROR("Demo '%s' is truncated", path.string().c_str());
+      return nullptr;
+    }
+    // The level is used to index the EXE data and the level cache when replaying
+    if (segment_header.level < static_cast<int32_t>(LevelId::INTRO) || segment_header.level > static_cast<int32_t>(LevelId::LEVEL_16))
+    {
+      LOG_ERROR("Demo '%s' has an invalid level %d", path.string().c_str(), static_cast<int>(segment_header.level));
+      return nullptr;
+    }
+    Segment segment{static_cast<LevelId>(segment_header.level), segment_header.first_tick, {}};
+    segment.runs.resize(segment_header.num_runs);
+    read(segment.runs.data(), segment.runs.size() * sizeof(Run));
+    demo->segments_.push_back(std::move(segment));
+  }
+  LOG_DEBUG("Loaded demo '%s' (%u segments, %u ticks)", path.string().c_str(), header.num_segments, demo->get_num_ticks());
+  return demo;
+}
+
+bool Demo::save(const std::filesystem::path& path) const
+{
+  DemoHeader header;
+  std::memcpy(header.magic, DEMO_MAGIC, sizeof(DEMO_MAGIC));
+  header.version = DEMO_VERSION;
+  header.seed = seed_;
+  header.activity_width = activity_size_.x();
+  header.activity_height = activity_size_.y();
+  header.activity_radius = activity_radius_;
+  header.num_segments = static_cast<uint32_t>(segments_.size());
+
+  std::ofstream output{path, std::ios::binary | std::ios::trunc};
+  output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  for (const auto& segment : segments_)
+  {
+    const SegmentHeader segment_header{
+      static_cast<int32_t>(segment.level), segment.first_tick, static_cast<uint32_t>(segment.runs.size())};
+    output.write(reinterpret_cast<const char*>(&segment_header), sizeof(segment_header));
+    output.write(reinterpret_cast<const char*>(segment.runs.data()), segment.runs.size() * sizeof(Run));
+  }
+  if (!output)
+  {
+    LOG_ERROR("Could not write demo '%s'", path.string().c_str());
+    return false;
+  }
+  return true;
+}
+
+void Demo::start_level(const LevelId level, const unsigned game_tick)
+{
+  // A level that was restarted before any update does not need a segment of its own
+  if (!segments_.empty() && segments_.back().runs.empty())
+  {
+    segments_.pop_back();
+  }
+  segments_.push_back({level, game_tick, {}});
+}
+
+void Demo::add(const PlayerInput& player_input)
+{
+  if (segments_.empty())
+  {
+    LOG_ERROR("Demo input added before start_level");
+    return;
+  }
+  auto& runs = segments_.back().runs;
+  const auto input = pack(player_input);
+  if (!runs.empty() && runs.back().input == input)
+  {
+    runs.back().count += 1u;
+  }
+  else
+  {
+    runs.push_back({input, 1u});
+  }
+}
+
+bool Demo::replay(Game& game, const ExeData& exe_data) const
+{
+  if (game.get_seed() != seed_)
+  {
+    LOG_ERROR("Demo was recorded with seed %llu but the game has seed %llu",
+              static_cast<unsigned long long>(seed_),
+              static_cast<unsigned long long>(game.get_seed()));
+    return false;
+  }
+  game.set_activity_area(activity_size_, activity_radius_);
+  for (const auto& segment : segments_)
+  {
+    if (!game.init(exe_data, segment.level))
+    {
+      LOG_ERROR("Could not initialize level %d for demo", static_cast<int>(segment.level));
+      return false;
+    }
+    auto game_tick = segment.first_tick;
+    for (const auto& run : segment.runs)
+    {
+      const auto player_input = unpack(run.input);
+      for (uint32_t i = 0u; i < run.count; i++)
+      {
+        game.update(game_tick, player_input);
+        game_tick += 1u;
+      }
+    }
+  }
+  return true;
+}
+
+unsigned Demo::get_num_ticks() const
+{
+  unsigned num_ticks = 0u;
+  for (const auto& segment : segments_)
+  {
+    for (const auto& run : segment.runs)
+    {
+      num_ticks += run.count;
+    }
+  }
+  return num_ticks;
+}
+
+uint32_t Demo::pack(const PlayerInput& player_input)
+{
+  uint32_t input = 0u;
+  for (std::size_t i = 0u; i < sizeof(fields) / sizeof(fields[0]); i++)
+  {
+    if (player_input.*fields[i])
+    {
+      input |= 1u << i;
+    }
+  }
+  return input;
+}
+
+PlayerInput Demo::unpack(const uint32_t input)
+{
+  PlayerInput player_input;
+  for (std::size_t i = 0u; i < sizeof(fields) / sizeof(fields[0]); i++)
+  {
+    player_input.*fields[i] = (input & (1u << i)) != 0u;
+  }
+  return player_input;
+}
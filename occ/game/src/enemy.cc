@@ -13,6 +13,18 @@ bool Enemy::should_reverse(const Level& level) const
     !level.collides_solid(position + geometry::Position(size.x() - 1, 1), geometry::Size(1, size.y()));
 }
 
+void Enemy::save(Snapshot& snapshot, const Level& level) const
+{
+  Actor::save(snapshot, level);
+  snapshot.write(health);
+  snapshot.write(points);
+}
+
+bool Enemy::restore(Snapshot::Reader& reader, Level& level)
+{
+  return Actor::restore(reader, level) && reader.read(health) && reader.read(points);
+}
+
 void Bigfoot::update(const geometry::Rectangle& player_rect, Level& level)
 {
   frame_++;
@@ -36,7 +48,7 @@ void Bigfoot::update(const geometry::Rectangle& player_rect, Level& level)
   }
 }
 
-std::vector<std::pair<geometry::Position, Sprite>> Bigfoot::get_sprites([[maybe_unused]] const Level& level) const
+void Bigfoot::get_sprites([[maybe_unused]] const Level& level, SpriteSink& sink) const
 {
   Sprite s = Sprite::SPRITE_BIGFOOT_HEAD_R_1;
   if (left_)
@@ -44,10 +56,21 @@ std::vector<std::pair<geometry::Position, Sprite>> Bigfoot::get_sprites([[maybe_
     s = Sprite::SPRITE_BIGFOOT_HEAD_L_1;
   }
   const auto frame = running_ ? frame_ % 4 : frame_ / 2;
-  return {
-    std::make_pair(position, static_cast<Sprite>(static_cast<int>(s) + frame)),
-    std::make_pair(position + geometry::Position(0, 16), static_cast<Sprite>(static_cast<int>(s) + 4 + frame)),
-  };
+  sink.add(position, static_cast<Sprite>(static_cast<int>(s) + frame));
+  sink.add(position + geometry::Position(0, 16), static_cast<Sprite>(static_cast<int>(s) + 4 + frame));
+}
+
+void Bigfoot::save(Snapshot& snapshot, const Level& level) const
+{
+  Enemy::save(snapshot, level);
+  snapshot.write(left_);
+  snapshot.write(running_);
+  snapshot.write(frame_);
+}
+
+bool Bigfoot::restore(Snapshot::Reader& reader, Level& level)
+{
+  return Enemy::restore(reader, level) && reader.read(left_) && reader.read(running_) && reader.read(frame_);
 }
 
 void Hopper::update([[maybe_unused]] const geometry::Rectangle& player_rect, Level& level)
@@ -68,14 +91,27 @@ void Hopper::update([[maybe_unused]] const geometry::Rectangle& player_rect, Lev
     left_ = !left_;
     position -= d;
     // Change directions every 1-20 seconds
-    next_reverse_ = 17 * (1 + static_cast<int>(rand() % 19));
+    next_reverse_ = 17 * level.random.range<int>(1, 19);
   }
   next_reverse_--;
 }
 
-std::vector<std::pair<geometry::Position, Sprite>> Hopper::get_sprites([[maybe_unused]] const Level& level) const
+void Hopper::get_sprites([[maybe_unused]] const Level& level, SpriteSink& sink) const
 {
-  return {std::make_pair(position, static_cast<Sprite>(static_cast<int>(Sprite::SPRITE_HOPPER_1) + frame_))};
+  sink.add(position, static_cast<Sprite>(static_cast<int>(Sprite::SPRITE_HOPPER_1) + frame_));
+}
+
+void Hopper::save(Snapshot& snapshot, const Level& level) const
+{
+  Enemy::save(snapshot, level);
+  snapshot.write(left_);
+  snapshot.write(frame_);
+  snapshot.write(next_reverse_);
+}
+
+bool Hopper::restore(Snapshot::Reader& reader, Level& level)
+{
+  return Enemy::restore(reader, level) && reader.read(left_) && reader.read(frame_) && reader.read(next_reverse_);
 }
 
 void Slime::update([[maybe_unused]] const geometry::Rectangle& player_rect, Level& level)
@@ -89,7 +125,7 @@ void Slime::update([[maybe_unused]] const geometry::Rectangle& player_rect, Leve
   if (level.collides_solid(position + d, size, true))
   {
     // Randomly change direction
-    switch (misc::random<int>(0, 4))
+    switch (level.random.range<int>(0, 4))
     {
       case 0:
         dx_ = 1;
@@ -117,7 +153,7 @@ void Slime::update([[maybe_unused]] const geometry::Rectangle& player_rect, Leve
   }
 }
 
-std::vector<std::pair<geometry::Position, Sprite>> Slime::get_sprites([[maybe_unused]] const Level& level) const
+void Slime::get_sprites([[maybe_unused]] const Level& level, SpriteSink& sink) const
 {
   Sprite s = Sprite::SPRITE_SLIME_R_1;
   if (dx_ == 1)
@@ -136,7 +172,20 @@ std::vector<std::pair<geometry::Position, Sprite>> Slime::get_sprites([[maybe_un
   {
     s = Sprite::SPRITE_SLIME_U_1;
   }
-  return {std::make_pair(position, static_cast<Sprite>(static_cast<int>(s) + frame_))};
+  sink.add(position, static_cast<Sprite>(static_cast<int>(s) + frame_));
+}
+
+void Slime::save(Snapshot& snapshot, const Level& level) const
+{
+  Enemy::save(snapshot, level);
+  snapshot.write(dx_);
+  snapshot.write(dy_);
+  snapshot.write(frame_);
+}
+
+bool Slime::restore(Snapshot::Reader& reader, Level& level)
+{
+  return Enemy::restore(reader, level) && reader.read(dx_) && reader.read(dy_) && reader.read(frame_);
 }
 
 void Snake::update([[maybe_unused]] const geometry::Rectangle& player_rect, Level& level)
@@ -169,20 +218,33 @@ void Snake::update([[maybe_unused]] const geometry::Rectangle& player_rect, Leve
   }
 }
 
-std::vector<std::pair<geometry::Position, Sprite>> Snake::get_sprites([[maybe_unused]] const Level& level) const
+void Snake::get_sprites([[maybe_unused]] const Level& level, SpriteSink& sink) const
 {
   const auto s = paused_ ? Sprite::SPRITE_SNAKE_PAUSE_1 : (left_ ? Sprite::SPRITE_SNAKE_WALK_L_1 : Sprite::SPRITE_SNAKE_WALK_R_1);
   const int frame = frame_ % (paused_ ? 7 : 9);
-  return {std::make_pair(position, static_cast<Sprite>(static_cast<int>(s) + frame))};
+  sink.add(position, static_cast<Sprite>(static_cast<int>(s) + frame));
 }
 
 void Snake::on_death(Level& level)
 {
   // Create a corpse
-  level.hazards.emplace_back(new CorpseSlime(position, Sprite::SPRITE_SNAKE_SLIME));
+  level.add_hazard<CorpseSlime>(position, Sprite::SPRITE_SNAKE_SLIME);
   // TODO: authentic mode, align corpse to tile coord
 }
 
+void Snake::save(Snapshot& snapshot, const Level& level) const
+{
+  Enemy::save(snapshot, level);
+  snapshot.write(left_);
+  snapshot.write(paused_);
+  snapshot.write(frame_);
+}
+
+bool Snake::restore(Snapshot::Reader& reader, Level& level)
+{
+  return Enemy::restore(reader, level) && reader.read(left_) && reader.read(paused_) && reader.read(frame_);
+}
+
 void Spider::update([[maybe_unused]] const geometry::Rectangle& player_rect, [[maybe_unused]] Level& level)
 {
   frame_++;
@@ -200,13 +262,41 @@ void Spider::update([[maybe_unused]] const geometry::Rectangle& player_rect, [[m
   // fire webs
   if (child_ == nullptr && geometry::is_any_colliding(get_detection_rects(level), player_rect))
   {
-    child_ = new SpiderWeb(position, *this);
-    level.hazards.emplace_back(child_);
+    child_ = &level.add_hazard<SpiderWeb>(position, *this);
+  }
+}
+
+void Spider::on_clone(const Level& original, const Level& clone)
+{
+  if (child_)
+  {
+    child_ = clone.relocate(original, child_);
   }
 }
 
-std::vector<std::pair<geometry::Position, Sprite>> Spider::get_sprites([[maybe_unused]] const Level& level) const
+void Spider::on_death([[maybe_unused]] Level& level)
+{
+  // The web is not removed with the spider, so it must not refer back to it
+  if (child_)
+  {
+    child_->remove_parent();
+  }
+}
+
+void Spider::get_sprites([[maybe_unused]] const Level& level, SpriteSink& sink) const
+{
+  sink.add(position, static_cast<Sprite>(static_cast<int>(up_ ? Sprite::SPRITE_SPIDER_UP_1 : Sprite::SPRITE_SPIDER_DOWN_1) + frame_));
+}
+
+void Spider::save(Snapshot& snapshot, const Level& level) const
+{
+  Enemy::save(snapshot, level);
+  snapshot.write(up_);
+  snapshot.write(frame_);
+  level.save_link(snapshot, child_);
+}
+
+bool Spider::restore(Snapshot::Reader& reader, Level& level)
 {
-  return {std::make_pair(position,
-                         static_cast<Sprite>(static_cast<int>(up_ ? Sprite::SPRITE_SPIDER_UP_1 : Sprite::SPRITE_SPIDER_DOWN_1) + frame_))};
+  return Enemy::restore(reader, level) && reader.read(up_) && reader.read(frame_) && level.restore_link(reader, child_);
 }
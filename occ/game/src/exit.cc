@@ -8,10 +8,8 @@ void Exit::update()
   }
 }
 
-std::vector<std::pair<geometry::Position, Sprite>> Exit::get_sprites() const
+void Exit::get_sprites(SpriteSink& sink) const
 {
-  return {
-    {position, static_cast<Sprite>(static_cast<int>(Sprite::SPRITE_EXIT_TOP_LEFT_1) + counter)},
-    {position + geometry::Position(0, 16), static_cast<Sprite>(static_cast<int>(Sprite::SPRITE_EXIT_BOTTOM_LEFT_1) + counter)},
-  };
+  sink.add(position, static_cast<Sprite>(static_cast<int>(Sprite::SPRITE_EXIT_TOP_LEFT_1) + counter));
+  sink.add(position + geometry::Position(0, 16), static_cast<Sprite>(static_cast<int>(Sprite::SPRITE_EXIT_BOTTOM_LEFT_1) + counter));
 }
@@ -3,23 +3,42 @@
 #include <array>
 #include <cstdint>
 #include <sstream>
+#include <type_traits>
+#include <utility>
 
-#include "level_loader.h"
 #include "logger.h"
 #include "misc.h"
+#include "movement.h"
+#include "occ_math.h"
 
 static constexpr auto gravity = 8u;
 static constexpr auto jump_velocity = misc::make_array<int>(0, -8, -8, -8, -4, -4, -2, -2, -2, -2, 2, 2, 2, 2, 4, 4);
 static constexpr auto jump_velocity_fall_index = 10u;
 
-std::unique_ptr<Game> Game::create()
+std::unique_ptr<Game> Game::create(const uint64_t seed, std::shared_ptr<LevelCache> level_cache)
 {
-  return std::make_unique<GameImpl>();
+  return std::make_unique<GameImpl>(seed, std::move(level_cache));
 }
 
 bool GameImpl::init(const ExeData& exe_data, const LevelId level)
 {
-  level_ = LevelLoader::load(exe_data, level);
+  if (!init(level_prefetcher_.take(exe_data, level, seed_)))
+  {
+    return false;
+  }
+  exe_data_ = &exe_data;
+  if (prefetch_distance_ >= 0)
+  {
+    // For when the level is restarted
+    level_prefetcher_.prefetch(exe_data, level, seed_);
+  }
+  return true;
+}
+
+bool GameImpl::init(std::unique_ptr<Level> level)
+{
+  exe_data_ = nullptr;
+  level_ = std::move(level);
   if (!level_)
   {
     return false;
@@ -27,7 +46,7 @@ bool GameImpl::init(const ExeData& exe_data, const LevelId level)
 
   player_ = Player();
   player_.position = level_->player_spawn;
-  entering_level = level;
+  entering_level = level_->level_id;
 
   score_ = 0u;
   num_ammo_ = 5u;
@@ -36,6 +55,8 @@ bool GameImpl::init(const ExeData& exe_data, const LevelId level)
 
   missile_.alive = false;
 
+  // A copy of the previous level can not be restored into
+  restore_level_.reset();
   return true;
 }
 
@@ -45,9 +66,12 @@ void GameImpl::update(unsigned game_tick, const PlayerInput& player_input)
 
   // Clear objects_
   objects_.clear();
+  num_simulated_ = 0u;
+
+  // Entities off screen are not updated, see set_activity_area()
+  update_activity_area();
 
   // Update the level (e.g. moving platforms and other objects)
-  // TODO: don't update enemies off screen
   update_level();
   update_actors();
   update_player(player_input);
@@ -57,6 +81,101 @@ void GameImpl::update(unsigned game_tick, const PlayerInput& player_input)
   update_hazards();
 }
 
+void GameImpl::snapshot(Snapshot& snapshot) const
+{
+  snapshot.clear();
+  snapshot.write(level_->level_id);
+  snapshot.write(level_->width);
+  snapshot.write(level_->height);
+  snapshot.write(player_);
+  snapshot.write(entering_level);
+  snapshot.write(score_);
+  snapshot.write(num_ammo_);
+  snapshot.write(num_lives_);
+  snapshot.write(has_key_);
+  snapshot.write(missile_);
+  particles_.save_slots(snapshot);
+  particles_.save_entities(snapshot);
+  snapshot.write(num_simulated_);
+  level_->save(snapshot);
+  // Last, as the number of objects changes often and everything after them would move
+  snapshot.write(static_cast<uint64_t>(objects_.size()));
+  for (const auto& object : objects_)
+  {
+    object.save(snapshot);
+  }
+}
+
+bool GameImpl::restore(const Snapshot& snapshot)
+{
+  Snapshot::Reader reader(snapshot);
+  LevelId level_id;
+  int width;
+  int height;
+  if (!reader.read(level_id) || !reader.read(width) || !reader.read(height) || level_id != level_->level_id ||
+      width != level_->width || height != level_->height)
+  {
+    LOG_ERROR("Snapshot is not of this level");
+    return false;
+  }
+
+  // The whole snapshot is read into locals and the restore_ members before anything is swapped in
+  if (!restore_level_)
+  {
+    restore_level_ = level_->clone();
+  }
+  Player player;
+  LevelId level_entering;
+  unsigned score;
+  unsigned num_ammo;
+  unsigned num_lives;
+  bool has_key;
+  Missile missile;
+  unsigned num_simulated;
+  uint64_t num_objects;
+  if (!reader.read(player) || !reader.read(level_entering) || !reader.read(score) || !reader.read(num_ammo) ||
+      !reader.read(num_lives) || !reader.read(has_key) || !reader.read(missile) ||
+      !restore_particles_.restore_slots(reader) || !restore_particles_.restore_entities(reader) ||
+      !reader.read(num_simulated) || !restore_level_->restore(reader) || !reader.read(num_objects))
+  {
+    LOG_ERROR("Snapshot is corrupt");
+    return false;
+  }
+  // Object has no default constructor, so objects are read one by one into the reused list
+  restore_objects_.clear();
+  bool objects_valid = true;
+  for (uint64_t i = 0u; objects_valid && i < num_objects; i++)
+  {
+    restore_objects_.emplace_back(geometry::Position(0, 0), 0, 1, false);
+    objects_valid = restore_objects_.back().restore(reader);
+  }
+  if (!objects_valid || !reader.at_end())
+  {
+    LOG_ERROR("Snapshot is corrupt");
+    return false;
+  }
+
+  player_ = player;
+  entering_level = level_entering;
+  score_ = score;
+  num_ammo_ = num_ammo;
+  num_lives_ = num_lives;
+  has_key_ = has_key;
+  missile_ = missile;
+  particles_.swap(restore_particles_);
+  num_simulated_ = num_simulated;
+  // The previous state of the level is kept to restore into next time
+  std::swap(level_, restore_level_);
+  objects_.swap(restore_objects_);
+  return true;
+}
+
+void GameImpl::set_activity_area(const geometry::Size& size, const int radius)
+{
+  activity_size_ = size;
+  activity_radius_ = radius;
+}
+
 int GameImpl::get_bg_sprite(const int x, const int y) const
 {
   return level_->get_bg(x, y);
@@ -85,6 +204,7 @@ std::wstring GameImpl::get_debug_info() const
   oss << L"player shooting: " << (player_.shooting ? L"true" : L"false") << "\n";
   oss << L"missile alive: " << (missile_.alive ? L"true" : L"false") << L"\n";
   oss << L"missile position: (" << missile_.position.x() << L", " << missile_.position.y() << L")\n";
+  oss << L"simulated entities: " << num_simulated_ << L"\n";
 
   return oss.str();
 }
@@ -94,6 +214,12 @@ void GameImpl::update_level()
   // Update all MovingPlatforms
   for (auto& platform : level_->moving_platforms)
   {
+    if (!is_active(platform.position, geometry::Size(16, 16)))
+    {
+      continue;
+    }
+    num_simulated_++;
+
     // Update platform
     const auto player_on_platform = (player_.position.y() + player_.size.y() == platform.position.y()) &&
       (player_.position.x() < platform.position.x() + 16) && (player_.position.x() + player_.size.x() > platform.position.x());
@@ -115,7 +241,10 @@ void GameImpl::update_level()
   // Add moving platforms to objects_
   for (auto& platform : level_->moving_platforms)
   {
-    objects_.emplace_back(platform.position, platform.sprite_id, platform.num_sprites, platform.is_reverse());
+    if (is_active(platform.position, geometry::Size(16, 16)))
+    {
+      objects_.emplace_back(platform.position, platform.sprite_id, platform.num_sprites, platform.is_reverse());
+    }
   }
 
   // Add entrances
@@ -129,6 +258,7 @@ void GameImpl::update_level()
       {
         entering_level = static_cast<LevelId>(entrance.level);
       }
+      prefetch_if_near(entrance.position, geometry::Size(16, 16), static_cast<LevelId>(entrance.level));
     }
     entrance.update();
     objects_.emplace_back(entrance.position, entrance.get_sprite(), 1, false);
@@ -145,12 +275,11 @@ void GameImpl::update_level()
         // TODO: play sound
         entering_level = static_cast<LevelId>(LevelId::MAIN_LEVEL);
       }
+      prefetch_if_near(level_->exit->position, geometry::Size(16, 32), LevelId::MAIN_LEVEL);
     }
     level_->exit->update();
-    for (const auto& sprite_pos : level_->exit->get_sprites())
-    {
-      objects_.emplace_back(sprite_pos.first, static_cast<int>(sprite_pos.second), 1, false);
-    }
+    SpriteSink sink(objects_);
+    level_->exit->get_sprites(sink);
   }
 }
 
@@ -263,14 +392,14 @@ void GameImpl::update_player(const PlayerInput& player_input)
   if (player_input.shoot)
   {
     const auto rect = geometry::Rectangle(player_.position, player_.size);
-    for (auto&& a : level_->actors)
+    const auto interact = [this, &rect, &interacted](auto& a)
     {
-      if (geometry::isColliding(rect, geometry::Rectangle(a->position, a->size)) && a->interact(*level_))
+      if (!interacted && geometry::isColliding(rect, geometry::Rectangle(a.position, a.size)) && a.interact(*level_))
       {
         interacted = true;
-        break;
       }
-    }
+    };
+    level_->actors.for_each(interact);
   }
   if (!interacted)
   {
@@ -323,40 +452,23 @@ void GameImpl::update_player(const PlayerInput& player_input)
 
   player_.collide_x = false;
   player_.collide_y = false;
-  const auto destination = player_.position + player_.velocity;
 
-  // Move on x axis
-  const auto step_x = destination.x() > player_.position.x() ? 1 : -1;
-  while (player_.position.x() != destination.x())
+  if (player_.noclip)
   {
-    const auto new_player_pos = player_.position + geometry::Position(step_x, 0);
-
-    if (!player_.noclip &&
-        (level_->collides_solid(new_player_pos, player_.size) ||
-         // collide with world edges
-         new_player_pos.x() < 0 || new_player_pos.x() >= level_->width * 16 - player_.size.x()))
-    {
-      player_.collide_x = true;
-      break;
-    }
-
-    player_.position = new_player_pos;
+    player_.position += player_.velocity;
   }
-
-  // Move on y axis
-  const auto step_y = destination.y() > player_.position.y() ? 1 : -1;
-  while (player_.position.y() != destination.y())
+  else
   {
-    const auto new_player_pos = player_.position + geometry::Position(0, step_y);
-
-    // If player is falling down (step_y == 1) we need to check for collision with platforms
-    if (!player_.noclip && (level_->collides_solid(new_player_pos, player_.size) || (step_y == 1 && player_on_platform(new_player_pos))))
-    {
-      player_.collide_y = true;
-      break;
-    }
+    // Move on x axis
+    const auto move_x = Movement::move_x(*level_, player_.position, player_.size, player_.velocity.x());
+    player_.position += geometry::Position(player_.velocity.x() > 0 ? move_x.distance : -move_x.distance, 0);
+    player_.collide_x = move_x.collided;
 
-    player_.position = new_player_pos;
+    // Move on y axis
+    // If player is falling down we also collide with platforms
+    const auto move_y = Movement::move_y(*level_, player_.position, player_.size, player_.velocity.y());
+    player_.position += geometry::Position(0, player_.velocity.y() > 0 ? move_y.distance : -move_y.distance);
+    player_.collide_y = move_y.collided;
   }
 
   /**
@@ -456,21 +568,20 @@ void GameImpl::update_items()
 void GameImpl::update_missile()
 {
   // Update particles (explosions etc.)
-  for (auto it = particles_.begin(); it != particles_.end();)
-  {
-    auto p = it->get();
-    p->update();
-
-    if (!p->is_alive())
+  particles_.for_each(
+    [this](auto& p)
     {
-      it = particles_.erase(it);
-    }
-    else
-    {
-      objects_.emplace_back(p->position, p->get_sprite(), 1, false);
-      it++;
-    }
-  }
+      p.update();
+
+      if (!p.is_alive())
+      {
+        particles_.get<std::decay_t<decltype(p)>>().erase(&p);
+      }
+      else
+      {
+        objects_.emplace_back(p.position, p.get_sprite(), 1, false);
+      }
+    });
 
   // Move the missile if it's alive
   if (missile_.alive)
@@ -485,7 +596,7 @@ void GameImpl::update_missile()
       {
         missile_.alive = false;
         missile_.set_cooldown();
-        particles_.emplace_back(new Explosion(missile_.position));
+        particles_.get<Explosion>().emplace(missile_.position);
         break;
       }
 
@@ -539,20 +650,28 @@ void GameImpl::update_missile()
 
 void GameImpl::update_enemies()
 {
-  for (auto it = level_->enemies.begin(); it != level_->enemies.end();)
+  const geometry::Rectangle player_rect(player_.position, player_.size);
+  SpriteSink sink(objects_);
+  const auto update_enemy = [this, &player_rect, &sink](auto& e)
   {
-    auto e = it->get();
+    if (!is_active(e.position, e.size))
+    {
+      return;
+    }
+    num_simulated_++;
+
     // TODO: When enemy getting hit and not dying the enemy sprite should turn white for
     //       some time. All colors except black in the sprite should become white.
     //       This is applicable for when the player gets hit as well
     //       Modify the sprite on the fly / some kind of filter, or pre-create white sprites
     //       for all player and enemy sprite when loading sprites?
-    e->update({player_.position, player_.size}, *level_);
+    e.update(player_rect, *level_);
+    level_->enemy_index.update(&e);
 
     // Check if enemy died
-    if (!e->is_alive())
+    if (!e.is_alive())
     {
-      e->on_death(*level_);
+      e.on_death(*level_);
 
       // TODO: When an enemy dies there should be another type of explosion
       //       or bones spawning. The explosion/bones should move during animation
@@ -560,109 +679,115 @@ void GameImpl::update_enemies()
       // Create explosion where enemy is
       // explosion_.alive = true;
       // explosion_.frame = 0;
-      // explosion_.position = e->position;
+      // explosion_.position = e.position;
 
       // Give score
-      score_ += e->get_points();
+      score_ += e.get_points();
       // Don't even bother showing score particle unless it is high enough (>= 1000?)
-      if (e->get_points() >= 1000)
+      if (e.get_points() >= 1000)
       {
-        particles_.emplace_back(new ScoreParticle(e->position, e->get_points()));
+        particles_.get<ScoreParticle>().emplace(e.position, e.get_points());
       }
 
       // Remove enemy
-      it = level_->enemies.erase(it);
+      level_->remove_enemy(e);
     }
     else
     {
-      for (const auto& sprite_pos : e->get_sprites(*level_))
-      {
-        objects_.emplace_back(sprite_pos.first, static_cast<int>(sprite_pos.second), 1, false);
-      }
-      it++;
+      e.get_sprites(*level_, sink);
     }
-  }
+  };
+  level_->enemies.for_each(update_enemy);
 }
 
 void GameImpl::update_hazards()
 {
-  for (auto it = level_->hazards.begin(); it != level_->hazards.end();)
+  const geometry::Rectangle player_rect(player_.position, player_.size);
+  SpriteSink sink(objects_);
+  const auto update_hazard = [this, &player_rect, &sink](auto& h)
   {
-    auto h = it->get();
-    h->update({player_.position, player_.size}, *level_);
+    if (h.can_sleep() && !is_active(h.position, h.size))
+    {
+      return;
+    }
+    num_simulated_++;
+
+    h.update(player_rect, *level_);
+    level_->hazard_index.update(&h);
 
     // Check if hazard died
-    if (!h->is_alive())
+    if (!h.is_alive())
     {
-      it = level_->hazards.erase(it);
+      level_->remove_hazard(h);
     }
     else
     {
-      for (const auto& sprite_pos : h->get_sprites(*level_))
-      {
-        objects_.emplace_back(sprite_pos.first, static_cast<int>(sprite_pos.second), 1, false);
-      }
-      it++;
+      h.get_sprites(*level_, sink);
     }
-  }
+  };
+  level_->hazards.for_each(update_hazard);
 }
 
 void GameImpl::update_actors()
 {
-  for (auto&& a : level_->actors)
+  const geometry::Rectangle player_rect(player_.position, player_.size);
+  SpriteSink sink(objects_);
+  const auto update_actor = [this, &player_rect, &sink](auto& a)
   {
-    a->update({player_.position, player_.size}, *level_);
-    for (const auto& sprite_pos : a->get_sprites(*level_))
+    if (!is_active(a.position, a.size))
     {
-      objects_.emplace_back(sprite_pos.first, static_cast<int>(sprite_pos.second), 1, false);
+      return;
     }
-  }
+    num_simulated_++;
+
+    a.update(player_rect, *level_);
+    level_->actor_index.update(&a);
+    a.get_sprites(*level_, sink);
+  };
+  level_->actors.for_each(update_actor);
 }
 
-/**
- * Checks if given position and size collides with any enemy.
- *
- * Returns the first colliding enemy, or null if none found.
- */
-Enemy* GameImpl::collides_enemy(const geometry::Position& position, const geometry::Size& size)
+void GameImpl::update_activity_area()
 {
-  const auto rect = geometry::Rectangle(position, size);
-  for (auto&& enemy : level_->enemies)
+  if (activity_radius_ < 0)
   {
-    if (geometry::isColliding(rect, geometry::Rectangle(enemy->position, enemy->size)))
-    {
-      return enemy.get();
-    }
+    return;
   }
-  return nullptr;
+
+  // Center the area on the player, but keep it inside the level like the camera
+  const auto center = player_.position + (player_.size / 2);
+  const auto position = geometry::Position(math::clamp(center.x() - (activity_size_.x() / 2), 0, (level_->width * 16) - activity_size_.x()),
+                                           math::clamp(center.y() - (activity_size_.y() / 2), 0, (level_->height * 16) - activity_size_.y()));
+  activity_area_ = geometry::Rectangle(position - geometry::Position(activity_radius_, activity_radius_),
+                                       activity_size_ + geometry::Size(activity_radius_ * 2, activity_radius_ * 2));
 }
 
-bool GameImpl::player_on_platform(const geometry::Position& player_position)
+bool GameImpl::is_active(const geometry::Position& position, const geometry::Size& size) const
 {
-  // Need to check both static platforms (e.g. foreground items with SOLID_TOP)
-  // and moving platforms
+  return activity_radius_ < 0 || geometry::isColliding(activity_area_, {position, size});
+}
 
-  // Standing on a static platform requires the player to stand on the edge of a tile
-  if ((player_position.y() + player_.size.y() - 1) % 16 == 0)
+void GameImpl::prefetch_if_near(const geometry::Position& position, const geometry::Size& size, const LevelId level_id)
+{
+  if (!exe_data_ || prefetch_distance_ < 0 || level_prefetcher_.is_prefetching(level_id))
   {
-    // Player can be on either 1 or 2 tiles, check both (or same...)
-    if (get_tile(player_position.x() / 16, (player_position.y() + player_.size.y() - 1) / 16).is_solid_top() ||
-        get_tile((player_position.x() + player_.size.x()) / 16, (player_position.y() + player_.size.y() - 1) / 16).is_solid_top())
-    {
-      return true;
-    }
+    return;
   }
-
-  // Check moving platforms
-  for (const auto& platform : level_->moving_platforms)
+  const auto distance = prefetch_distance_ * 16;
+  const auto near_area = geometry::Rectangle(player_.position - geometry::Position(distance, distance),
+                                             player_.size + geometry::Size(distance * 2, distance * 2));
+  if (geometry::isColliding(near_area, {position, size}))
   {
-    // Player only collides if standing exactly on top of the platform, just like with static platforms
-    if ((player_position.y() + player_.size.y() - 1 == platform.position.y()) && (player_position.x() < platform.position.x() + 16) &&
-        (player_position.x() + player_.size.x() > platform.position.x()))
-    {
-      return true;
-    }
+    level_prefetcher_.prefetch(*exe_data_, level_id, seed_);
   }
+}
 
-  return false;
+/**
+ * Checks if given position and size collides with any enemy.
+ *
+ * Returns the first colliding enemy, or null if none found.
+ */
+Enemy* GameImpl::collides_enemy(const geometry::Position& position, const geometry::Size& size)
+{
+  return static_cast<Enemy*>(level_->enemy_index.find_first({position, size}));
 }
@@ -2,25 +2,59 @@
 
 #include "game.h"
 
+#include <cstdint>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "enemy.h"
+#include "entity_pool.h"
 #include "hazard.h"
 #include "level.h"
+#include "level_cache.h"
+#include "level_prefetcher.h"
 #include "missile.h"
 #include "particle.h"
 #include "player.h"
 #include "player_input.h"
+#include "snapshot.h"
 
 class GameImpl : public Game
 {
  public:
-  GameImpl() : player_(), level_(), objects_(), score_(0u), num_ammo_(0u), num_lives_(0u), has_key_(false), missile_(), particles_() {}
+  explicit GameImpl(const uint64_t seed = 0u, std::shared_ptr<LevelCache> level_cache = nullptr)
+    : seed_(seed),
+      player_(),
+      level_(),
+      objects_(),
+      score_(0u),
+      num_ammo_(0u),
+      num_lives_(0u),
+      has_key_(false),
+      missile_(),
+      particles_(),
+      restore_level_(),
+      restore_particles_(),
+      restore_objects_(),
+      activity_size_(),
+      activity_radius_(-1),
+      activity_area_(),
+      num_simulated_(0u),
+      exe_data_(nullptr),
+      prefetch_distance_(-1),
+      level_prefetcher_(level_cache ? std::move(level_cache) : std::make_shared<LevelCache>())
+  {
+  }
+
+  uint64_t get_seed() const override { return seed_; }
 
   bool init(const ExeData& exe_data, const LevelId level) override;
+  bool init(std::unique_ptr<Level> level) override;
   void update(unsigned game_tick, const PlayerInput& player_input) override;
 
+  void snapshot(Snapshot& snapshot) const override;
+  bool restore(const Snapshot& snapshot) override;
+
   const Player& get_player() const override { return player_; }
 
   const Level& get_level() const override { return *level_; }
@@ -34,6 +68,10 @@ class GameImpl : public Game
 
   const std::vector<Object>& get_objects() const override { return objects_; }
 
+  void set_activity_area(const geometry::Size& size, const int radius) override;
+  unsigned get_num_simulated() const override { return num_simulated_; }
+  void set_prefetch_distance(const int distance) override { prefetch_distance_ = distance; }
+
   unsigned get_score() const override { return score_; }
   unsigned get_num_ammo() const override { return num_ammo_; }
   unsigned get_num_lives() const override { return num_lives_; }
@@ -49,10 +87,14 @@ class GameImpl : public Game
   void update_enemies();
   void update_hazards();
   void update_actors();
+  void update_activity_area();
+  bool is_active(const geometry::Position& position, const geometry::Size& size) const;
+  void prefetch_if_near(const geometry::Position& position, const geometry::Size& size, const LevelId level_id);
 
   Enemy* collides_enemy(const geometry::Position& position, const geometry::Size& size);
-  bool player_on_platform(const geometry::Position& player_position);
 
+  // Passed to LevelCache::get
+  uint64_t seed_;
   Player player_;
   std::unique_ptr<Level> level_;
   std::vector<Object> objects_;
@@ -63,5 +105,21 @@ class GameImpl : public Game
   bool has_key_;
 
   Missile missile_;
-  std::vector<std::unique_ptr<Particle>> particles_;
+  EntityPools<Explosion, ScoreParticle> particles_;
+
+  // Snapshots are restored into these and then swapped in, so that a failed restore leaves the game unchanged
+  // restore_level_ is a copy of level_, kept between restores so that restoring does not copy the level every time.
+  std::unique_ptr<Level> restore_level_;
+  EntityPools<Explosion, ScoreParticle> restore_particles_;
+  std::vector<Object> restore_objects_;
+
+  geometry::Size activity_size_;
+  int activity_radius_;
+  geometry::Rectangle activity_area_;
+  unsigned num_simulated_;
+
+  // Only set when the level was loaded from EXE data
+  const ExeData* exe_data_;
+  int prefetch_distance_;
+  LevelPrefetcher level_prefetcher_;
 };
@@ -12,10 +12,21 @@ void AirTank::update([[maybe_unused]] const geometry::Rectangle& player_rect, [[
   }
 }
 
-std::vector<std::pair<geometry::Position, Sprite>> AirTank::get_sprites([[maybe_unused]] const Level& level) const
+void AirTank::get_sprites([[maybe_unused]] const Level& level, SpriteSink& sink) const
 {
-  return {std::make_pair(
-    position, top_ ? static_cast<Sprite>(static_cast<int>(Sprite::SPRITE_AIR_TANK_TOP_1) + frame_) : Sprite::SPRITE_AIR_TANK_BOTTOM)};
+  sink.add(position, top_ ? static_cast<Sprite>(static_cast<int>(Sprite::SPRITE_AIR_TANK_TOP_1) + frame_) : Sprite::SPRITE_AIR_TANK_BOTTOM);
+}
+
+void AirTank::save(Snapshot& snapshot, const Level& level) const
+{
+  Hazard::save(snapshot, level);
+  snapshot.write(top_);
+  snapshot.write(frame_);
+}
+
+bool AirTank::restore(Snapshot::Reader& reader, Level& level)
+{
+  return Hazard::restore(reader, level) && reader.read(top_) && reader.read(frame_);
 }
 
 void Laser::update(const geometry::Rectangle& player_rect, Level& level)
@@ -23,11 +34,30 @@ void Laser::update(const geometry::Rectangle& player_rect, Level& level)
   if (child_ == nullptr && geometry::is_any_colliding(get_detection_rects(level), player_rect))
   {
     geometry::Position child_pos = position + geometry::Position(left_ ? -12 : 12, -1);
-    child_ = new LaserBeam(child_pos, left_, *this);
-    level.hazards.emplace_back(child_);
+    child_ = &level.add_hazard<LaserBeam>(child_pos, left_, *this);
+  }
+}
+
+void Laser::on_clone(const Level& original, const Level& clone)
+{
+  if (child_)
+  {
+    child_ = clone.relocate(original, child_);
   }
 }
 
+void Laser::save(Snapshot& snapshot, const Level& level) const
+{
+  Hazard::save(snapshot, level);
+  snapshot.write(left_);
+  level.save_link(snapshot, child_);
+}
+
+bool Laser::restore(Snapshot::Reader& reader, Level& level)
+{
+  return Hazard::restore(reader, level) && reader.read(left_) && level.restore_link(reader, child_);
+}
+
 void LaserBeam::update([[maybe_unused]] const geometry::Rectangle& player_rect, Level& level)
 {
   frame_ = 1 - frame_;
@@ -35,10 +65,32 @@ void LaserBeam::update([[maybe_unused]] const geometry::Rectangle& player_rect,
   if (level.collides_solid(position + geometry::Position(0, 1), geometry::Size(16, 16)))
   {
     alive_ = false;
-    parent_.remove_child();
+    if (parent_)
+    {
+      parent_->remove_child();
+    }
   }
 }
 
+void LaserBeam::on_clone(const Level& original, const Level& clone)
+{
+  parent_ = clone.relocate(original, parent_);
+}
+
+void LaserBeam::save(Snapshot& snapshot, const Level& level) const
+{
+  Hazard::save(snapshot, level);
+  snapshot.write(left_);
+  snapshot.write(frame_);
+  level.save_link(snapshot, parent_);
+  snapshot.write(alive_);
+}
+
+bool LaserBeam::restore(Snapshot::Reader& reader, Level& level)
+{
+  return Hazard::restore(reader, level) && reader.read(left_) && reader.read(frame_) && level.restore_link(reader, parent_) && reader.read(alive_);
+}
+
 void Thorn::update(const geometry::Rectangle& player_rect, Level& level)
 {
   if (geometry::is_any_colliding(get_detection_rects(level), player_rect))
@@ -54,19 +106,64 @@ void Thorn::update(const geometry::Rectangle& player_rect, Level& level)
   }
 }
 
+void Thorn::save(Snapshot& snapshot, const Level& level) const
+{
+  Hazard::save(snapshot, level);
+  snapshot.write(frame_);
+}
+
+bool Thorn::restore(Snapshot::Reader& reader, Level& level)
+{
+  return Hazard::restore(reader, level) && reader.read(frame_);
+}
+
 void SpiderWeb::update([[maybe_unused]] const geometry::Rectangle& player_rect, Level& level)
 {
   position += geometry::Position(0, 4);
   if (level.collides_solid(position + geometry::Position(0, -6), geometry::Size(16, 16)))
   {
     alive_ = false;
-    parent_.remove_child();
+    if (parent_)
+    {
+      parent_->remove_child();
+    }
   }
 
   // TODO: hurt player
 }
 
+void SpiderWeb::on_clone(const Level& original, const Level& clone)
+{
+  if (parent_)
+  {
+    parent_ = clone.relocate(original, parent_);
+  }
+}
+
+void SpiderWeb::save(Snapshot& snapshot, const Level& level) const
+{
+  Hazard::save(snapshot, level);
+  level.save_link(snapshot, parent_);
+  snapshot.write(alive_);
+}
+
+bool SpiderWeb::restore(Snapshot::Reader& reader, Level& level)
+{
+  return Hazard::restore(reader, level) && level.restore_link(reader, parent_) && reader.read(alive_);
+}
+
 void CorpseSlime::update([[maybe_unused]] const geometry::Rectangle& player_rect, [[maybe_unused]] Level& level)
 {
   // TODO: hurt player
 }
+
+void CorpseSlime::save(Snapshot& snapshot, const Level& level) const
+{
+  Hazard::save(snapshot, level);
+  snapshot.write(sprite_);
+}
+
+bool CorpseSlime::restore(Snapshot::Reader& reader, Level& level)
+{
+  return Hazard::restore(reader, level) && reader.read(sprite_);
+}
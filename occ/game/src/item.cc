@@ -1,3 +0,0 @@
-#include "item.h"
-
-const Item Item::INVALID;
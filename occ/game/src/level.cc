@@ -1,5 +1,107 @@
 #include "level.h"
 
+void Level::finalize()
+{
+  tile_masks.build(tiles, width, height);
+  enemy_index.resize(width, height);
+  hazard_index.resize(width, height);
+  actor_index.resize(width, height);
+}
+
+std::unique_ptr<Level> Level::clone() const
+{
+  auto level = std::make_unique<Level>();
+  level->level_id = level_id;
+  level->width = width;
+  level->height = height;
+  level->player_spawn = player_spawn;
+  level->bgs = bgs;
+  level->tiles = tiles;
+  level->items = items;
+  level->tile_masks = tile_masks;
+
+  // The pools are copied slot by slot, so pointers to entities are fixed up by offsetting them to the copied chunks
+  level->enemies.copy_from(enemies);
+  level->hazards.copy_from(hazards);
+  level->actors.copy_from(actors);
+  const auto relocate = [this, &level](const Actor* actor) { return level->relocate(*this, actor); };
+  level->enemy_index.copy_from(enemy_index, relocate);
+  level->hazard_index.copy_from(hazard_index, relocate);
+  level->actor_index.copy_from(actor_index, relocate);
+  const auto on_clone = [this, &level](auto& entity) { entity.on_clone(*this, *level); };
+  level->enemies.for_each(on_clone);
+  level->hazards.for_each(on_clone);
+  level->actors.for_each(on_clone);
+
+  // MovingPlatform has const members so it can only be copy-constructed, not copy-assigned
+  level->moving_platforms = std::vector<MovingPlatform>(moving_platforms);
+  level->entrances = entrances;
+  level->exit = exit ? std::make_unique<Exit>(*exit) : nullptr;
+  level->has_earth = has_earth;
+  level->has_moon = has_moon;
+  level->switch_on = switch_on;
+  level->lever_on = lever_on;
+  level->random = random;
+  return level;
+}
+
+void Level::save(Snapshot& snapshot) const
+{
+  // Tiles, backgrounds and tile masks never change after loading
+  snapshot.write_vector(items);
+  // All slots come before the entities, so that the entities they refer to exist when entities are restored
+  enemies.save_slots(snapshot);
+  hazards.save_slots(snapshot);
+  actors.save_slots(snapshot);
+  enemies.save_entities(snapshot, *this);
+  hazards.save_entities(snapshot, *this);
+  actors.save_entities(snapshot, *this);
+  enemy_index.save(snapshot, enemies);
+  hazard_index.save(snapshot, hazards);
+  actor_index.save(snapshot, actors);
+  // Moving platforms are never added or removed, and only their position and velocity change
+  for (const auto& platform : moving_platforms)
+  {
+    platform.save(snapshot);
+  }
+  snapshot.write_vector(entrances);
+  if (exit)
+  {
+    snapshot.write(*exit);
+  }
+  snapshot.write(switch_on);
+  snapshot.write(static_cast<uint32_t>(lever_on.to_ulong()));
+  snapshot.write(random);
+}
+
+bool Level::restore(Snapshot::Reader& reader)
+{
+  const auto num_entrances = entrances.size();
+  uint32_t lever_bits;
+  if (!reader.read_vector(items) || items.size() != tiles.size() || !enemies.restore_slots(reader) ||
+      !hazards.restore_slots(reader) || !actors.restore_slots(reader) || !enemies.restore_entities(reader, *this) ||
+      !hazards.restore_entities(reader, *this) || !actors.restore_entities(reader, *this) ||
+      !enemy_index.restore(reader, enemies) || !hazard_index.restore(reader, hazards) ||
+      !actor_index.restore(reader, actors))
+  {
+    return false;
+  }
+  for (auto& platform : moving_platforms)
+  {
+    if (!platform.restore(reader))
+    {
+      return false;
+    }
+  }
+  if (!reader.read_vector(entrances) || entrances.size() != num_entrances || (exit && !reader.read(*exit)) ||
+      !reader.read(switch_on) || !reader.read(lever_bits) || !reader.read(random))
+  {
+    return false;
+  }
+  lever_on = lever_bits;
+  return true;
+}
+
 const Tile& Level::get_tile(const int x, const int y) const
 {
   if (x < 0 || x >= width || y < 0 || y >= height)
@@ -34,29 +136,21 @@ void Level::remove_item(const int x, const int y)
 
 bool Level::collides_solid(const geometry::Position& position, const geometry::Size& size, const bool is_slime) const
 {
-  // Note: this function only works with size x and y <= 16
-  // With size 16x16 the object can cover at maximum 4 tiles
-  // Check all 4 tiles, even though we might check the same tile multiple times
-  const std::array<geometry::Position, 4> positions = {
-    geometry::Position((position.x() + 0) / 16, (position.y() + 0) / 16),
-    geometry::Position((position.x() + size.x() - 1) / 16, (position.y() + 0) / 16),
-    geometry::Position((position.x() + 0) / 16, (position.y() + size.y() - 1) / 16),
-    geometry::Position((position.x() + size.x() - 1) / 16, (position.y() + size.y() - 1) / 16)};
-  for (const auto& p : positions)
-  {
-    const auto& tile = get_tile(p.x(), p.y());
-    if (is_slime ? tile.is_solid_for_slime() : tile.is_solid())
-    {
-      return true;
-    }
-  }
-  // Check colliding solid actors (closed doors)
-  for (const auto& a : actors)
+  if (collides_tile(position, size, is_slime ? (TILE_SOLID | TILE_BLOCKS_SLIME) : TILE_SOLID))
   {
-    if (a->is_solid(*this) && geometry::isColliding(geometry::Rectangle(a->position, a->size), {position, size}))
-    {
-      return true;
-    }
+    return true;
   }
-  return false;
+  // Check colliding solid actors (closed doors)
+  return actor_index.find_first({position, size}, [this](const Actor& a) { return a.is_solid(*this); }) != nullptr;
+}
+
+bool Level::collides_tile(const geometry::Position& position, const geometry::Size& size, const int flags) const
+{
+  // Note: tile coordinates are truncated towards zero, so positions up to 15 pixels left of / above
+  // the level still count as being in the first column / row
+  return tile_masks.any(position.x() / 16,
+                        position.y() / 16,
+                        (position.x() + size.x() - 1) / 16,
+                        (position.y() + size.y() - 1) / 16,
+                        flags);
 }
@@ -0,0 +1,48 @@
+#include "level_cache.h"
+
+#include "logger.h"
+
+std::unique_ptr<Level> LevelCache::get(const ExeData& exe_data, const LevelId level_id, const uint64_t seed)
+{
+  const auto index = static_cast<int>(level_id);
+  if (index < 0 || index >= NUM_LEVELS)
+  {
+    LOG_ERROR("Invalid level %d", index);
+    return nullptr;
+  }
+
+  std::shared_ptr<const Prototype> prototype;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // The prototypes are only valid for the EXE data they were loaded from
+    if (exe_data_ != &exe_data)
+    {
+      prototypes_ = {};
+      exe_data_ = &exe_data;
+    }
+
+    // Loaded while holding the lock, so that games entering the same level at the same time load it only once
+    if (!prototypes_[index])
+    {
+      auto loaded = std::make_shared<Prototype>();
+      loaded->level = LevelLoader::load(exe_data, level_id, loaded->random_bgs);
+      if (!loaded->level)
+      {
+        return nullptr;
+      }
+      prototypes_[index] = std::move(loaded);
+    }
+    prototype = prototypes_[index];
+  }
+
+  auto level = prototype->level->clone();
+  LevelLoader::randomize(*level, prototype->random_bgs, seed);
+  return level;
+}
+
+void LevelCache::clear()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  exe_data_ = nullptr;
+  prototypes_ = {};
+}
@@ -16,31 +16,6 @@ namespace LevelLoader
 
 // https://moddingwiki.shikadi.net/wiki/Crystal_Caves_Map_Format
 
-constexpr int levelLoc = 0x8CE0;
-constexpr int levelRows[] = {
-  // intro
-  5,
-  // finale
-  6,
-  // main
-  25,
-  24,
-  24,
-  24,
-  24,
-  24,
-  24,
-  23,
-  23,
-  24,
-  24,
-  24,
-  24,
-  24,
-  23,
-  24,
-  24,
-};
 const std::pair<Sprite, geometry::Size> levelBGs[] = {
   // intro
   {Sprite::SPRITE_STARS_1, {6, 1}},
@@ -65,6 +40,7 @@ const std::pair<Sprite, geometry::Size> levelBGs[] = {
   {Sprite::SPRITE_METAL_BARS_1, {2, 2}},
   {Sprite::SPRITE_BLUE_DIAMOND_1, {2, 2}},
 };
+static_assert(sizeof(levelBGs) / sizeof(levelBGs[0]) == static_cast<std::size_t>(LevelId::LEVEL_16) + 1u, "One background per level");
 // Different levels use different block colours
 const Sprite blockColors[] = {
   // Intro 1-2
@@ -89,7 +65,9 @@ const Sprite blockColors[] = {
   Sprite::SPRITE_BLOCK_GREEN_NW,
   Sprite::SPRITE_BLOCK_PEBBLE_NW,
   Sprite::SPRITE_BLOCK_METAL_NW,
+  Sprite::SPRITE_BLOCK_PEBBLE_NW,
 };
+static_assert(sizeof(blockColors) / sizeof(blockColors[0]) == static_cast<std::size_t>(LevelId::LEVEL_16) + 1u, "One block colour per level");
 std::vector<Sprite> STARS{
   // The sprite with the bright star (3) seems to be less common...
   Sprite::SPRITE_STARS_1, Sprite::SPRITE_STARS_1, Sprite::SPRITE_STARS_1, Sprite::SPRITE_STARS_1, Sprite::SPRITE_STARS_2,
@@ -118,49 +96,64 @@ enum class TileMode
   EXIT,
 };
 
-std::unique_ptr<Level> load(const ExeData& exe_data, const LevelId level_id)
+std::unique_ptr<Level> load(const ExeData& exe_data, const LevelId level_id, const uint64_t seed)
+{
+  std::vector<RandomBackground> random_bgs;
+  auto level = load(exe_data, level_id, random_bgs);
+  if (level)
+  {
+    randomize(*level, random_bgs, seed);
+  }
+  return level;
+}
+
+void randomize(Level& level, const std::vector<RandomBackground>& random_bgs, const uint64_t seed)
+{
+  level.random.seed(seed + static_cast<uint64_t>(level.level_id));
+  // In the order they were loaded in, so that a level is the same whether it was randomized right away or cloned
+  for (const auto& random_bg : random_bgs)
+  {
+    level.bgs[random_bg.index] = static_cast<int>((*random_bg.sprites)[level.random.range<std::size_t>(0u, random_bg.sprites->size() - 1u)]);
+  }
+}
+
+std::unique_ptr<Level> load(const ExeData& exe_data, const LevelId level_id, std::vector<RandomBackground>& random_bgs)
 {
   LOG_INFO("Loading level %d", static_cast<int>(level_id));
   // Find the location in exe data of the level
-  const char* ptr = exe_data.data.c_str() + levelLoc;
-  int l;
-  for (l = static_cast<int>(LevelId::INTRO); l <= static_cast<int>(LevelId::LEVEL_16); l++)
+  if (static_cast<std::size_t>(level_id) >= exe_data.levels.size())
   {
-    if (l == static_cast<int>(level_id))
-    {
-      break;
-    }
-    // Skip this level's rows
-    for (int row = 0; row < levelRows[l]; row++)
-    {
-      const size_t len = *ptr;
-      ptr++;
-      ptr += len;
-    }
+    LOG_ERROR("Level %d not found in EXE data", static_cast<int>(level_id));
+    return nullptr;
   }
+  const auto& level_entry = exe_data.levels[static_cast<int>(level_id)];
+  const char* ptr = exe_data.data.data() + level_entry.offset;
 
   auto level = std::make_unique<Level>();
+  // The background is picked by randomize, some tiles are picked twice
+  random_bgs.clear();
+  const auto random_bg = [&random_bgs](const int index, const std::vector<Sprite>& sprites)
+  {
+    random_bgs.push_back({index, &sprites});
+    return static_cast<int>(sprites.front());
+  };
 
   // Read the tile ids of the level
   std::vector<int> tile_ids;
-  level->width = 0;
-  for (int row = 0; row < levelRows[l]; row++)
+  tile_ids.reserve(level_entry.width * level_entry.height);
+  level->width = level_entry.width;
+  for (int row = 0; row < level_entry.height; row++)
   {
-    const int len = *ptr;
-    if (level->width == 0)
-    {
-      level->width = len;
-    }
+    const int len = static_cast<uint8_t>(*ptr);
     ptr++;
-    const auto row_str = std::string(ptr).substr(0, len);
-    LOG_DEBUG("%s", row_str.c_str());
+    LOG_DEBUG("%.*s", len, ptr);
     for (int i = 0; i < len; i++, ptr++)
     {
       tile_ids.push_back(static_cast<int>(*ptr));
     }
   }
   level->level_id = level_id;
-  level->height = levelRows[static_cast<int>(level_id)];
+  level->height = level_entry.height;
   const auto background = levelBGs[static_cast<int>(level_id)];
   const auto block_sprite = blockColors[static_cast<int>(level_id)];
 
@@ -187,11 +180,11 @@ std::unique_ptr<Level> load(const ExeData& exe_data, const LevelId level_id)
     int bg = static_cast<int>(background.first);
     if (is_stars_row)
     {
-      bg = static_cast<int>(STARS[rand() % STARS.size()]);
+      bg = random_bg(i, STARS);
     }
     else if (is_horizon_row)
     {
-      bg = static_cast<int>(HORIZON[rand() % HORIZON.size()]);
+      bg = random_bg(i, HORIZON);
     }
     else if (background.first != Sprite::SPRITE_NONE)
     {
@@ -319,11 +312,11 @@ std::unique_ptr<Level> load(const ExeData& exe_data, const LevelId level_id)
             break;
           case '#':
             // Spider
-            level->enemies.emplace_back(new Spider(geometry::Position{x * 16, y * 16}));
+            level->add_enemy<Spider>(geometry::Position{x * 16, y * 16});
             break;
           case '$':
             // Air tank (top)
-            level->hazards.emplace_back(new AirTank(geometry::Position{x * 16, y * 16}, true));
+            level->add_hazard<AirTank>(geometry::Position{x * 16, y * 16}, true);
             break;
             // Crystals
           case '+':
@@ -397,14 +390,14 @@ std::unique_ptr<Level> load(const ExeData& exe_data, const LevelId level_id)
             break;
           case 'A':
             // Green slime
-            level->enemies.emplace_back(new Slime(geometry::Position{x * 16, y * 16}));
+            level->add_enemy<Slime>(geometry::Position{x * 16, y * 16});
             break;
           case 'H':
             level->moving_platforms.push_back({geometry::Position{x * 16, y * 16}, true, false});
             break;
           case 'I':
             // Thorn
-            level->hazards.emplace_back(new Thorn(geometry::Position{x * 16, y * 16}));
+            level->add_hazard<Thorn>(geometry::Position{x * 16, y * 16});
             break;
           case 'k':
             sprite = static_cast<int>(Sprite::SPRITE_CONCRETE_V);
@@ -443,7 +436,7 @@ std::unique_ptr<Level> load(const ExeData& exe_data, const LevelId level_id)
                 break;
               case '$':
                 // Air tank (bottom)
-                level->hazards.emplace_back(new AirTank(geometry::Position{x * 16, y * 16}, false));
+                level->add_hazard<AirTank>(geometry::Position{x * 16, y * 16}, false);
                 break;
               case 'X':
                 // Bottom-left of exit
@@ -474,7 +467,7 @@ std::unique_ptr<Level> load(const ExeData& exe_data, const LevelId level_id)
             break;
           case 'S':
             // Snake
-            level->enemies.emplace_back(new Snake(geometry::Position{x * 16, y * 16}));
+            level->add_enemy<Snake>(geometry::Position{x * 16, y * 16});
             break;
           case 'u':
             // TODO: volcano spawn point?
@@ -485,13 +478,13 @@ std::unique_ptr<Level> load(const ExeData& exe_data, const LevelId level_id)
             break;
           case 'v':
             // Horizontal toggle switch
-            level->actors.emplace_back(new Switch(geometry::Position{x * 16, y * 16}, Sprite::SPRITE_SWITCH_OFF));
+            level->add_actor<Switch>(geometry::Position{x * 16, y * 16}, Sprite::SPRITE_SWITCH_OFF);
             break;
           case 'V':
             level->moving_platforms.push_back({geometry::Position{x * 16, y * 16}, false, false});
             break;
           case 'w':
-            level->hazards.emplace_back(new Laser(geometry::Position{x * 16, y * 16}, false));
+            level->add_hazard<Laser>(geometry::Position{x * 16, y * 16}, false);
             break;
           case 'x':
             // TODO: remember completion state
@@ -518,13 +511,13 @@ std::unique_ptr<Level> load(const ExeData& exe_data, const LevelId level_id)
             if (is_horizon_row || (x == 0 && tile_ids[i + 1] == 'Z'))
             {
               // Random horizon tile
-              bg = static_cast<int>(HORIZON[rand() % HORIZON.size()]);
+              bg = random_bg(i, HORIZON);
               is_horizon_row = true;
             }
             else
             {
               // Random star tile
-              bg = static_cast<int>(STARS[rand() % STARS.size()]);
+              bg = random_bg(i, STARS);
               is_stars_row = true;
             }
             break;
@@ -567,7 +560,7 @@ std::unique_ptr<Level> load(const ExeData& exe_data, const LevelId level_id)
             }
             break;
           case '/':
-            level->enemies.emplace_back(new Hopper(geometry::Position{x * 16, y * 16}));
+            level->add_enemy<Hopper>(geometry::Position{x * 16, y * 16});
             break;
           case '_':
             sprite = static_cast<int>(Sprite::SPRITE_PLATFORM_BLUE);
@@ -595,7 +588,7 @@ std::unique_ptr<Level> load(const ExeData& exe_data, const LevelId level_id)
             break;
           case -14:
             // Tall Green Monster
-            level->enemies.emplace_back(new Bigfoot(geometry::Position{x * 16, y * 16}));
+            level->add_enemy<Bigfoot>(geometry::Position{x * 16, y * 16});
             break;
           case -16:
             if (tile_ids[i + 1] == 'n')
@@ -664,19 +657,19 @@ std::unique_ptr<Level> load(const ExeData& exe_data, const LevelId level_id)
             break;
           case -91:
             // Top of blue door
-            level->actors.emplace_back(new Door(geometry::Position{x * 16, y * 16}, LeverColor::LEVER_COLOR_B));
+            level->add_actor<Door>(geometry::Position{x * 16, y * 16}, LeverColor::LEVER_COLOR_B);
             break;
           case -92:
             // Top of green door
-            level->actors.emplace_back(new Door(geometry::Position{x * 16, y * 16}, LeverColor::LEVER_COLOR_G));
+            level->add_actor<Door>(geometry::Position{x * 16, y * 16}, LeverColor::LEVER_COLOR_G);
             break;
           case -94:
             // Blue lever
-            level->actors.emplace_back(new Lever(geometry::Position{x * 16, y * 16}, LeverColor::LEVER_COLOR_B));
+            level->add_actor<Lever>(geometry::Position{x * 16, y * 16}, LeverColor::LEVER_COLOR_B);
             break;
           case -95:
             // Green lever
-            level->actors.emplace_back(new Lever(geometry::Position{x * 16, y * 16}, LeverColor::LEVER_COLOR_G));
+            level->add_actor<Lever>(geometry::Position{x * 16, y * 16}, LeverColor::LEVER_COLOR_G);
             break;
           case -113:
             if (tile_ids[i + 1] == 'n')
@@ -717,6 +710,7 @@ std::unique_ptr<Level> load(const ExeData& exe_data, const LevelId level_id)
     level->bgs.push_back(bg);
     level->items.push_back(item);
   }
+  level->finalize();
 
   return level;
 }
@@ -0,0 +1,67 @@
+#include "level_prefetcher.h"
+
+#include <utility>
+
+LevelPrefetcher::LevelPrefetcher(std::shared_ptr<LevelCache> cache)
+  : mutex_(),
+    exe_data_(nullptr),
+    seed_(0u),
+    generation_(0u),
+    cache_(std::move(cache)),
+    pending_(),
+    pool_()
+{
+}
+
+void LevelPrefetcher::prefetch(const ExeData& exe_data, const LevelId level_id, const uint64_t seed)
+{
+  set_source(exe_data, seed);
+  if (is_prefetching(level_id))
+  {
+    return;
+  }
+  if (!pool_)
+  {
+    pool_ = std::make_unique<ThreadPool>(1u);
+  }
+  // The task does not refer to the EXE data itself, as it may be gone by the time a task of an old source runs
+  const auto generation = generation_;
+  pending_.emplace(level_id, pool_->submit([this, level_id, generation]() { return prepare(level_id, generation); }));
+}
+
+std::unique_ptr<Level> LevelPrefetcher::take(const ExeData& exe_data, const LevelId level_id, const uint64_t seed)
+{
+  set_source(exe_data, seed);
+  const auto it = pending_.find(level_id);
+  if (it == pending_.end())
+  {
+    return prepare(level_id, generation_);
+  }
+  auto future = std::move(it->second);
+  pending_.erase(it);
+  return future.get();
+}
+
+std::unique_ptr<Level> LevelPrefetcher::prepare(const LevelId level_id, const unsigned generation)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (generation != generation_)
+  {
+    return nullptr;
+  }
+  return cache_->get(*exe_data_, level_id, seed_);
+}
+
+void LevelPrefetcher::set_source(const ExeData& exe_data, const uint64_t seed)
+{
+  // Levels being prepared from other EXE data or with another seed are not wanted anymore
+  if (exe_data_ != &exe_data || seed_ != seed)
+  {
+    pending_.clear();
+    // Waits for a task that is loading from the old source
+    std::lock_guard<std::mutex> lock(mutex_);
+    exe_data_ = &exe_data;
+    seed_ = seed;
+    generation_++;
+  }
+}
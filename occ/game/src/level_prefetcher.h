@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include "exe_data.h"
+#include "level.h"
+#include "level_cache.h"
+#include "level_id.h"
+#include "thread_pool.h"
+
+// Prepares levels on a worker thread before they are entered, e.g. when the player gets near an entrance,
+// so that entering a level only needs to take the prepared level instead of loading it on the game thread
+// Levels are cloned from a LevelCache, which may be shared with other games, so each level is only loaded from the
+// EXE data once.
+class LevelPrefetcher
+{
+ public:
+  explicit LevelPrefetcher(std::shared_ptr<LevelCache> cache);
+
+  // Starts preparing the level on the worker thread, unless it is already being prepared
+  // seed is passed to LevelCache::get
+  void prefetch(const ExeData& exe_data, const LevelId level_id, const uint64_t seed);
+
+  // Returns the level, waiting for it if it is being prepared, or preparing it on the calling thread if not
+  std::unique_ptr<Level> take(const ExeData& exe_data, const LevelId level_id, const uint64_t seed);
+
+  bool is_prefetching(const LevelId level_id) const { return pending_.count(level_id) != 0; }
+
+ private:
+  // Returns nullptr if the source has changed since generation, the level is not wanted anymore then
+  std::unique_ptr<Level> prepare(const LevelId level_id, const unsigned generation);
+  void set_source(const ExeData& exe_data, const uint64_t seed);
+
+  // The source is only changed by the game thread, and read by tasks while holding mutex_
+  std::mutex mutex_;
+  const ExeData* exe_data_ = nullptr;
+  uint64_t seed_ = 0u;
+  unsigned generation_ = 0u;
+  std::shared_ptr<LevelCache> cache_;
+  std::map<LevelId, std::future<std::unique_ptr<Level>>> pending_;
+  // Created by the first prefetch, so that games that never prefetch (e.g. thousands of games simulated in parallel)
+  // do not each have a thread
+  // Destroyed first so that no task is running when the cache is destroyed
+  std::unique_ptr<ThreadPool> pool_;
+};
@@ -0,0 +1,202 @@
+#include "movement.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "level.h"
+
+namespace Movement
+{
+
+namespace
+{
+
+// Returns the number of steps (of size 1 in the given direction) from v until the tile index of v changes
+// Note: tile indices are truncated towards zero, just like in Level::collides_tile
+int steps_to_next_tile(const int v, const int step)
+{
+  const int tile = v / 16;
+  if (step > 0)
+  {
+    const int next = tile >= 0 ? (tile + 1) * 16 : (tile * 16) + 1;
+    return next - v;
+  }
+  const int next = tile > 0 ? (tile * 16) - 1 : (tile - 1) * 16;
+  return v - next;
+}
+
+// Returns the first step k in [1, max_steps] at which [c + k * step, c + k * step + extent) overlaps
+// [lo, lo + length), or max_steps + 1 if it never does
+int first_overlap(const int c, const int extent, const int step, const int lo, const int length, const int max_steps)
+{
+  const int k_min = std::max(step > 0 ? lo - extent - c + 1 : c - lo - length + 1, 1);
+  const int k_max = step > 0 ? lo + length - c - 1 : c + extent - lo - 1;
+  if (k_min > k_max || k_min > max_steps)
+  {
+    return max_steps + 1;
+  }
+  return k_min;
+}
+
+// Returns the first step at which the box collides with solid tiles or solid actors, or max_steps + 1 if it never does
+int first_solid_contact(const Level& level,
+                        const geometry::Position& position,
+                        const geometry::Size& size,
+                        const bool horizontal,
+                        const int step,
+                        const int max_steps)
+{
+  const auto offset = [horizontal, step](const int k) { return horizontal ? geometry::Position(k * step, 0) : geometry::Position(0, k * step); };
+  const int lo = horizontal ? position.x() : position.y();
+  const int hi = lo + (horizontal ? size.x() : size.y()) - 1;
+  int contact = max_steps + 1;
+
+  // The set of covered tiles only changes when the leading or trailing edge enters a new tile,
+  // so only those steps need to be tested
+  for (int k = 1; k <= max_steps;)
+  {
+    if (level.collides_tile(position + offset(k), size, TILE_SOLID))
+    {
+      contact = k;
+      break;
+    }
+    k += std::min(steps_to_next_tile(lo + (k * step), step), steps_to_next_tile(hi + (k * step), step));
+  }
+
+  // Solid actors (closed doors) overlapping the swept area
+  const auto first = position + offset(1);
+  const auto last = position + offset(max_steps);
+  const auto swept = geometry::Rectangle(std::min(first.x(), last.x()),
+                                         std::min(first.y(), last.y()),
+                                         size + geometry::Size(std::abs(last.x() - first.x()), std::abs(last.y() - first.y())));
+  level.actor_index.for_each(swept,
+                             [&](const Actor& a)
+                             {
+                               if (a.is_solid(level))
+                               {
+                                 contact = std::min(contact,
+                                                    horizontal ? first_overlap(position.x(), size.x(), step, a.position.x(), a.size.x(), max_steps) :
+                                                                 first_overlap(position.y(), size.y(), step, a.position.y(), a.size.y(), max_steps));
+                               }
+                             });
+
+  return contact;
+}
+
+// Returns the first step (moving down) at which the box lands on a platform, or max_steps + 1 if it never does
+int first_platform_contact(const Level& level, const geometry::Position& position, const geometry::Size& size, const int max_steps)
+{
+  int contact = max_steps + 1;
+
+  // Static platforms can only be landed on when the bottom edge is on the top edge of a tile
+  const int bottom = position.y() + size.y() - 1;
+  const int first_edge = 16 - (((bottom % 16) + 16) % 16);
+  for (int k = first_edge; k <= max_steps; k += 16)
+  {
+    if (on_platform(level, position + geometry::Position(0, k), size))
+    {
+      contact = k;
+      break;
+    }
+  }
+
+  // Moving platforms
+  for (const auto& platform : level.moving_platforms)
+  {
+    const int k = platform.position.y() - bottom;
+    if (k >= 1 && k < contact && position.x() < platform.position.x() + 16 && position.x() + size.x() > platform.position.x())
+    {
+      contact = k;
+    }
+  }
+
+  return contact;
+}
+
+Result to_result(const int contact, const int max_steps)
+{
+  if (contact <= max_steps)
+  {
+    return {contact - 1, true};
+  }
+  return {max_steps, false};
+}
+
+}  // namespace
+
+Result move_x(const Level& level, const geometry::Position& position, const geometry::Size& size, const int velocity)
+{
+  if (velocity == 0)
+  {
+    return {0, false};
+  }
+  const int step = velocity > 0 ? 1 : -1;
+  const int max_steps = std::abs(velocity);
+  int contact = first_solid_contact(level, position, size, true, step, max_steps);
+
+  // Collide with world edges, x must stay within [0, level.width * 16 - size.x())
+  const int min_x = 0;
+  const int max_x = (level.width * 16) - size.x() - 1;
+  const int first_x = position.x() + step;
+  if (first_x < min_x || first_x > max_x)
+  {
+    contact = 1;
+  }
+  else
+  {
+    contact = std::min(contact, step < 0 ? first_x - min_x + 2 : max_x - first_x + 2);
+  }
+
+  return to_result(contact, max_steps);
+}
+
+Result move_y(const Level& level, const geometry::Position& position, const geometry::Size& size, const int velocity)
+{
+  if (velocity == 0)
+  {
+    return {0, false};
+  }
+  const int step = velocity > 0 ? 1 : -1;
+  const int max_steps = std::abs(velocity);
+  int contact = first_solid_contact(level, position, size, false, step, max_steps);
+
+  // If moving down we need to check for collision with platforms
+  if (step > 0)
+  {
+    contact = std::min(contact, first_platform_contact(level, position, size, max_steps));
+  }
+
+  return to_result(contact, max_steps);
+}
+
+bool on_platform(const Level& level, const geometry::Position& position, const geometry::Size& size)
+{
+  // Need to check both static platforms (e.g. foreground items with SOLID_TOP)
+  // and moving platforms
+
+  // Standing on a static platform requires the box to stand on the edge of a tile
+  if ((position.y() + size.y() - 1) % 16 == 0)
+  {
+    // Box can be on either 1 or 2 tiles, check both (or same...)
+    // Note: the right edge is position.x() + size.x(), not - 1
+    if (level.collides_tile(position + geometry::Position(0, size.y() - 1), geometry::Size(size.x() + 1, 1), TILE_SOLID_TOP))
+    {
+      return true;
+    }
+  }
+
+  // Check moving platforms
+  for (const auto& platform : level.moving_platforms)
+  {
+    // Box only collides if standing exactly on top of the platform, just like with static platforms
+    if ((position.y() + size.y() - 1 == platform.position.y()) && (position.x() < platform.position.x() + 16) &&
+        (position.x() + size.x() > platform.position.x()))
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "geometry.h"
+
+struct Level;
+
+// Swept collision for boxes moving through a level
+// Instead of moving one pixel at a time and testing for collision at each step, the time of first
+// contact is computed against the tile grid, solid actors and platforms directly. The result is
+// identical to stepping one pixel at a time and stopping before the first colliding position.
+namespace Movement
+{
+
+struct Result
+{
+  int distance;   // Number of pixels moved (always >= 0)
+  bool collided;  // True if the movement was stopped before the full velocity
+};
+
+// Moves along the x axis, colliding with solid tiles, solid actors and the world edges
+Result move_x(const Level& level, const geometry::Position& position, const geometry::Size& size, const int velocity);
+
+// Moves along the y axis, colliding with solid tiles and solid actors
+// When moving down the box also lands on platforms (solid top tiles and moving platforms)
+Result move_y(const Level& level, const geometry::Position& position, const geometry::Size& size, const int velocity);
+
+// Returns true if a box at position is standing exactly on top of a platform
+bool on_platform(const Level& level, const geometry::Position& position, const geometry::Size& size);
+
+}
@@ -27,6 +27,16 @@ void MovingPlatform::update(const Level& level)
   }
 }
 
+void MovingPlatform::save(Snapshot& snapshot) const
+{
+  snapshot.write(position);
+  snapshot.write(velocity);
+}
+
+bool MovingPlatform::restore(Snapshot::Reader& reader)
+{
+  return reader.read(position) && reader.read(velocity);
+}
 
 Vector<int> MovingPlatform::get_velocity(const Level& level) const
 {
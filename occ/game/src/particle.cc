@@ -1,5 +1,15 @@
 #include "particle.h"
 
+void Particle::save(Snapshot& snapshot) const
+{
+  snapshot.write(position);
+}
+
+bool Particle::restore(Snapshot::Reader& reader)
+{
+  return reader.read(position);
+}
+
 ScoreParticle::ScoreParticle(geometry::Position position, int score) : Particle(position)
 {
   switch (score)
@@ -51,6 +61,18 @@ bool ScoreParticle::is_alive() const
   return frame_ < 16;
 }
 
+void ScoreParticle::save(Snapshot& snapshot) const
+{
+  Particle::save(snapshot);
+  snapshot.write(frame_);
+  snapshot.write(sprite_);
+}
+
+bool ScoreParticle::restore(Snapshot::Reader& reader)
+{
+  return Particle::restore(reader) && reader.read(frame_) && reader.read(sprite_);
+}
+
 constexpr decltype(Explosion::sprites_) Explosion::sprites_;
 
 void Explosion::update()
@@ -68,3 +90,15 @@ bool Explosion::is_alive() const
 {
   return frame_ < sprites_.size();
 }
+
+void Explosion::save(Snapshot& snapshot) const
+{
+  Particle::save(snapshot);
+  snapshot.write(frame_);
+}
+
+bool Explosion::restore(Snapshot::Reader& reader)
+{
+  // frame_ indexes sprites_ while the explosion is alive
+  return Particle::restore(reader) && reader.read(frame_) && frame_ <= sprites_.size();
+}
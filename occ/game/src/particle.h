@@ -2,6 +2,7 @@
 
 #include "geometry.h"
 #include "misc.h"
+#include "snapshot.h"
 #include "sprite.h"
 
 class Particle
@@ -13,6 +14,9 @@ class Particle
   virtual void update() = 0;
   virtual int get_sprite() const = 0;
   virtual bool is_alive() const = 0;
+  // Saves the fields of the particle to snapshot and restores them, see EntityPool::save_entities
+  virtual void save(Snapshot& snapshot) const;
+  virtual bool restore(Snapshot::Reader& reader);
 
   geometry::Position position;
 };
@@ -21,10 +25,13 @@ class Explosion : public Particle
 {
  public:
   Explosion(geometry::Position position) : Particle(position) {}
+  Explosion() : Explosion(geometry::Position()) {}
 
   virtual void update() override;
   virtual int get_sprite() const override;
   virtual bool is_alive() const override;
+  virtual void save(Snapshot& snapshot) const override;
+  virtual bool restore(Snapshot::Reader& reader) override;
 
  private:
   unsigned frame_ = 0;
@@ -35,10 +42,13 @@ class ScoreParticle : public Particle
 {
  public:
   ScoreParticle(geometry::Position position, int score);
+  ScoreParticle() : ScoreParticle(geometry::Position(), 0) {}
 
   virtual void update() override;
   virtual int get_sprite() const override;
   virtual bool is_alive() const override;
+  virtual void save(Snapshot& snapshot) const override;
+  virtual bool restore(Snapshot::Reader& reader) override;
 
  private:
   unsigned frame_ = 0;
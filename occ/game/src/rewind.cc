@@ -0,0 +1,254 @@
+#include "rewind.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include "logger.h"
+
+namespace
+{
+void write_varint(std::vector<unsigned char>& output, std::size_t value)
+{
+  while (value >= 0x80u)
+  {
+    output.push_back(static_cast<unsigned char>(value | 0x80u));
+    value >>= 7;
+  }
+  output.push_back(static_cast<unsigned char>(value));
+}
+
+std::size_t read_varint(const unsigned char*& input)
+{
+  std::size_t value = 0u;
+  int shift = 0;
+  while (*input & 0x80u)
+  {
+    value |= static_cast<std::size_t>(*input++ & 0x7Fu) << shift;
+    shift += 7;
+  }
+  value |= static_cast<std::size_t>(*input++) << shift;
+  return value;
+}
+}
+
+Rewind::Rewind(const std::size_t capacity, const std::size_t max_ticks, const unsigned keyframe_interval)
+  : buffer_(capacity),
+    frames_(std::max<std::size_t>(1u, max_ticks)),
+    first_frame_(0u),
+    num_frames_(0u),
+    bytes_used_(0u),
+    keyframe_interval_(keyframe_interval),
+    snapshot_(),
+    xor_(),
+    scratch_()
+{
+}
+
+void Rewind::capture(const Game& game)
+{
+  game.snapshot(snapshot_);
+  if (num_frames_ > 0u)
+  {
+    const auto keyframe = get_keyframe(num_frames_ - 1u);
+    if (num_frames_ - keyframe < keyframe_interval_)
+    {
+      encode(get_frame(keyframe));
+      // A difference as big as the snapshot (e.g. after lots of entities were created) is not worth it
+      if (scratch_.size() < snapshot_.size() && store(scratch_.data(), scratch_.size(), false))
+      {
+        return;
+      }
+    }
+  }
+  if (!store(snapshot_.data(), snapshot_.size(), true))
+  {
+    LOG_ERROR("Rewind buffer of %zu bytes is too small for a snapshot of %zu bytes", buffer_.size(), snapshot_.size());
+  }
+}
+
+bool Rewind::step_back(Game& game)
+{
+  if (num_frames_ < 2u)
+  {
+    return false;
+  }
+  bytes_used_ -= get_frame(num_frames_ - 1u).size;
+  num_frames_--;
+  decode(num_frames_ - 1u);
+  if (!game.restore(snapshot_))
+  {
+    clear();
+    return false;
+  }
+  return true;
+}
+
+void Rewind::clear()
+{
+  first_frame_ = 0u;
+  num_frames_ = 0u;
+  bytes_used_ = 0u;
+}
+
+std::size_t Rewind::get_keyframe(std::size_t index) const
+{
+  // The oldest frame is always a keyframe
+  while (!get_frame(index).keyframe)
+  {
+    index--;
+  }
+  return index;
+}
+
+void Rewind::encode(const Frame& keyframe)
+{
+  const auto* reference = buffer_.data() + keyframe.offset;
+  const auto reference_size = std::min(keyframe.size, snapshot_.size());
+  const auto* current = snapshot_.data();
+  const auto size = snapshot_.size();
+
+  // XOR the whole snapshot first, bytes past the end of the keyframe are XORed with zeros, so the run-length
+  // encoding below only has to look for zero words
+  const auto num_words = (size + sizeof(uint64_t) - 1u) / sizeof(uint64_t);
+  xor_.resize(num_words);
+  if (num_words > 0u)
+  {
+    xor_.back() = 0u;
+  }
+  std::memcpy(xor_.data(), current, size);
+  const auto num_reference_words = reference_size / sizeof(uint64_t);
+  for (std::size_t i = 0u; i < num_reference_words; i++)
+  {
+    uint64_t word;
+    std::memcpy(&word, reference + (i * sizeof(uint64_t)), sizeof(word));
+    xor_[i] ^= word;
+  }
+  auto* difference = reinterpret_cast<unsigned char*>(xor_.data());
+  for (auto i = num_reference_words * sizeof(uint64_t); i < reference_size; i++)
+  {
+    difference[i] ^= reference[i];
+  }
+
+  scratch_.clear();
+  write_varint(scratch_, size);
+  std::size_t word = 0u;
+  while (word < num_words)
+  {
+    const auto zeros_start = word;
+    while (word < num_words && xor_[word] == 0u)
+    {
+      word++;
+    }
+    // A single unchanged word costs less to store than starting a new run
+    const auto literal_start = word;
+    while (word < num_words && (xor_[word] != 0u || (word + 1u < num_words && xor_[word + 1u] != 0u)))
+    {
+      word++;
+    }
+    if (literal_start == num_words)
+    {
+      break;
+    }
+
+    write_varint(scratch_, literal_start - zeros_start);
+    write_varint(scratch_, word - literal_start);
+    const auto literal_size = (word - literal_start) * sizeof(uint64_t);
+    const auto offset = scratch_.size();
+    scratch_.resize(offset + literal_size);
+    std::memcpy(scratch_.data() + offset, xor_.data() + literal_start, literal_size);
+  }
+}
+
+void Rewind::decode(const std::size_t index)
+{
+  const auto& frame = get_frame(index);
+  const auto& keyframe = get_frame(get_keyframe(index));
+  snapshot_.clear();
+  if (frame.keyframe)
+  {
+    snapshot_.write_bytes(buffer_.data() + frame.offset, frame.size);
+    return;
+  }
+
+  const auto* input = buffer_.data() + frame.offset;
+  const auto* end = input + frame.size;
+  const auto size = read_varint(input);
+  xor_.assign((size + sizeof(uint64_t) - 1u) / sizeof(uint64_t), 0u);
+  auto* data = reinterpret_cast<unsigned char*>(xor_.data());
+  std::memcpy(data, buffer_.data() + keyframe.offset, std::min(size, keyframe.size));
+  std::size_t word = 0u;
+  while (input < end)
+  {
+    word += read_varint(input);
+    const auto num_literals = read_varint(input);
+    for (std::size_t i = 0u; i < num_literals; i++, word++)
+    {
+      uint64_t literal;
+      std::memcpy(&literal, input, sizeof(literal));
+      input += sizeof(literal);
+      xor_[word] ^= literal;
+    }
+  }
+  snapshot_.write_bytes(data, size);
+}
+
+bool Rewind::store(const unsigned char* data, const std::size_t size, const bool keyframe)
+{
+  if (size > buffer_.size())
+  {
+    clear();
+    return false;
+  }
+
+  // Frames are stored one after another, wrapping around to the start of the buffer when they do not fit at the end
+  std::size_t offset = 0u;
+  bool wrapped = false;
+  if (num_frames_ > 0u)
+  {
+    const auto& newest = get_frame(num_frames_ - 1u);
+    offset = newest.offset + newest.size;
+    if (offset + size > buffer_.size())
+    {
+      offset = 0u;
+      wrapped = true;
+    }
+  }
+  // The oldest frames are the ones following the newest in the buffer, so they are the ones overwritten
+  // When wrapping around, the frames between the newest and the end of the buffer are older than the ones at the
+  // start of it, so they are dropped first even if they are not overwritten themselves.
+  while (num_frames_ > 0u)
+  {
+    const auto& oldest = get_frame(0u);
+    const auto& newest = get_frame(num_frames_ - 1u);
+    const bool overwritten = (oldest.offset < offset + size && offset < oldest.offset + oldest.size) ||
+                             (wrapped && oldest.offset > newest.offset);
+    if (num_frames_ < frames_.size() && !overwritten)
+    {
+      break;
+    }
+    if (!keyframe && get_keyframe(num_frames_ - 1u) == 0u)
+    {
+      // The difference would overwrite its own keyframe
+      return false;
+    }
+    drop_oldest();
+  }
+
+  std::memcpy(buffer_.data() + offset, data, size);
+  get_frame(num_frames_) = {offset, size, keyframe};
+  num_frames_++;
+  bytes_used_ += size;
+  return true;
+}
+
+void Rewind::drop_oldest()
+{
+  // Differences can not be restored without their keyframe, so they are dropped together
+  do
+  {
+    bytes_used_ -= get_frame(0u).size;
+    first_frame_ = (first_frame_ + 1u) % frames_.size();
+    num_frames_--;
+  } while (num_frames_ > 0u && !get_frame(0u).keyframe);
+}
@@ -0,0 +1,269 @@
+#include "spatial_index.h"
+
+#include <algorithm>
+
+#include "occ_math.h"
+
+namespace
+{
+// Division rounding towards negative infinity, so that actors partially outside the level end up in the edge buckets
+int floor_div(const int n, const int d)
+{
+  return n >= 0 ? n / d : ((n + 1) / d) - 1;
+}
+}
+
+void SpatialIndex::reset(const int width, const int height)
+{
+  next_order_ = 0u;
+  size_ = 0u;
+  records_.clear();
+  free_records_.clear();
+  resize(width, height);
+}
+
+void SpatialIndex::resize(const int width, const int height)
+{
+  columns_ = std::max(1, (width + BUCKET_TILES - 1) / BUCKET_TILES);
+  rows_ = std::max(1, (height + BUCKET_TILES - 1) / BUCKET_TILES);
+  // Room for a few actors per bucket so that actors moving around do not allocate
+  const auto num_buckets = static_cast<std::size_t>(columns_ * rows_);
+  bucket_starts_.resize(num_buckets + 1u);
+  for (std::size_t i = 0; i <= num_buckets; i++)
+  {
+    bucket_starts_[i] = static_cast<uint32_t>(i * BUCKET_CAPACITY);
+  }
+  bucket_sizes_.assign(num_buckets, 0u);
+  entries_.resize(num_buckets * BUCKET_CAPACITY);
+
+  // Records are in the order the actors were inserted unless some were removed, so the buckets end up the same as
+  // if the actors had been inserted after resizing
+  for (uint32_t index = 0u; index < records_.size(); index++)
+  {
+    auto& record = records_[index];
+    if (record.actor)
+    {
+      record.range = get_range(geometry::Rectangle(record.actor->position, record.actor->size));
+      add_to_buckets(record.range, index);
+    }
+  }
+}
+
+void SpatialIndex::insert(Actor* actor)
+{
+  const auto range = get_range(geometry::Rectangle(actor->position, actor->size));
+  const auto order = next_order_++;
+  auto index = find_record(actor);
+  if (index != Actor::NOT_INDEXED)
+  {
+    remove_from_buckets(records_[index].range, index);
+  }
+  else
+  {
+    if (!free_records_.empty())
+    {
+      index = free_records_.back();
+      free_records_.pop_back();
+    }
+    else
+    {
+      index = static_cast<uint32_t>(records_.size());
+      records_.emplace_back();
+    }
+    actor->index_record = index;
+    size_++;
+  }
+  records_[index] = {actor, order, range};
+  add_to_buckets(range, index);
+}
+
+void SpatialIndex::remove(const Actor* actor)
+{
+  const auto index = find_record(actor);
+  if (index == Actor::NOT_INDEXED)
+  {
+    return;
+  }
+  remove_from_buckets(records_[index].range, index);
+  records_[index].actor = nullptr;
+  free_records_.push_back(index);
+  size_--;
+}
+
+void SpatialIndex::update(Actor* actor)
+{
+  const auto index = find_record(actor);
+  if (index == Actor::NOT_INDEXED)
+  {
+    return;
+  }
+  auto& record = records_[index];
+  const auto range = get_range(geometry::Rectangle(actor->position, actor->size));
+  if (range == record.range)
+  {
+    return;
+  }
+  remove_from_buckets(record.range, index);
+  add_to_buckets(range, index);
+  // add_to_buckets does not touch records_, so record is still valid
+  record.range = range;
+}
+
+void SpatialIndex::save_buckets(Snapshot& snapshot) const
+{
+  snapshot.write(columns_);
+  snapshot.write(rows_);
+  snapshot.write(next_order_);
+  snapshot.write(static_cast<uint64_t>(size_));
+  // The sizes of all buckets come first, so that an actor moving between buckets only moves the entries between
+  // the two buckets instead of everything after them
+  snapshot.write_vector(bucket_sizes_);
+  for (std::size_t bucket = 0; bucket < bucket_sizes_.size(); bucket++)
+  {
+    snapshot.write_bytes(entries_.data() + bucket_starts_[bucket], bucket_sizes_[bucket] * sizeof(entries_[0]));
+  }
+}
+
+bool SpatialIndex::restore_buckets(Snapshot::Reader& reader)
+{
+  int columns;
+  int rows;
+  uint64_t size;
+  if (!reader.read(columns) || !reader.read(rows) || columns != columns_ || rows != rows_ ||
+      !reader.read(next_order_) || !reader.read(size) || !reader.read_vector(bucket_sizes_) ||
+      bucket_sizes_.size() != static_cast<std::size_t>(columns_ * rows_))
+  {
+    return false;
+  }
+  size_ = size;
+
+  // The buckets keep their room unless the snapshot has more entries in them
+  uint64_t num_entries = 0u;
+  bool fits = bucket_starts_.size() == bucket_sizes_.size() + 1u && entries_.size() == bucket_starts_.back();
+  for (std::size_t bucket = 0; bucket < bucket_sizes_.size(); bucket++)
+  {
+    num_entries += bucket_sizes_[bucket];
+    fits = fits && bucket_sizes_[bucket] <= bucket_starts_[bucket + 1u] - bucket_starts_[bucket];
+  }
+  if (reader.remaining() / sizeof(entries_[0]) < num_entries)
+  {
+    return false;
+  }
+  if (!fits)
+  {
+    bucket_starts_.resize(bucket_sizes_.size() + 1u);
+    uint32_t start = 0u;
+    for (std::size_t bucket = 0; bucket < bucket_sizes_.size(); bucket++)
+    {
+      bucket_starts_[bucket] = start;
+      start += std::max(static_cast<uint32_t>(BUCKET_CAPACITY), bucket_sizes_[bucket]);
+    }
+    bucket_starts_.back() = start;
+    entries_.resize(start);
+  }
+  for (std::size_t bucket = 0; bucket < bucket_sizes_.size(); bucket++)
+  {
+    reader.read_bytes(entries_.data() + bucket_starts_[bucket], bucket_sizes_[bucket] * sizeof(entries_[0]));
+  }
+  return true;
+}
+
+bool SpatialIndex::is_consistent() const
+{
+  std::size_t num_actors = 0u;
+  for (const auto& record : records_)
+  {
+    if (record.actor)
+    {
+      const auto& range = record.range;
+      if (range.min_x < 0 || range.min_x > range.max_x || range.max_x >= columns_ || range.min_y < 0 ||
+          range.min_y > range.max_y || range.max_y >= rows_)
+      {
+        return false;
+      }
+      num_actors++;
+    }
+  }
+  if (num_actors != size_ || free_records_.size() != records_.size() - num_actors)
+  {
+    return false;
+  }
+  for (const auto index : free_records_)
+  {
+    if (index >= records_.size() || records_[index].actor)
+    {
+      return false;
+    }
+  }
+  for (std::size_t bucket = 0; bucket < bucket_sizes_.size(); bucket++)
+  {
+    for (auto i = bucket_starts_[bucket]; i < bucket_starts_[bucket] + bucket_sizes_[bucket]; i++)
+    {
+      if (entries_[i] >= records_.size() || !records_[entries_[i]].actor)
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+uint32_t SpatialIndex::find_record(const Actor* actor) const
+{
+  const auto index = actor->index_record;
+  return index < records_.size() && records_[index].actor == actor ? index : Actor::NOT_INDEXED;
+}
+
+SpatialIndex::Range SpatialIndex::get_range(const geometry::Rectangle& rect) const
+{
+  if (columns_ == 0)
+  {
+    // Not reset yet, there are no buckets to look in
+    return {0, 0, -1, -1};
+  }
+  return {math::clamp(floor_div(rect.position.x(), BUCKET_SIZE), 0, columns_ - 1),
+          math::clamp(floor_div(rect.position.y(), BUCKET_SIZE), 0, rows_ - 1),
+          math::clamp(floor_div(rect.position.x() + rect.size.x() - 1, BUCKET_SIZE), 0, columns_ - 1),
+          math::clamp(floor_div(rect.position.y() + rect.size.y() - 1, BUCKET_SIZE), 0, rows_ - 1)};
+}
+
+void SpatialIndex::add_to_buckets(const Range& range, const uint32_t record)
+{
+  for (int y = range.min_y; y <= range.max_y; y++)
+  {
+    for (int x = range.min_x; x <= range.max_x; x++)
+    {
+      const auto bucket = (y * columns_) + x;
+      if (bucket_starts_[bucket] + bucket_sizes_[bucket] == bucket_starts_[bucket + 1])
+      {
+        grow_bucket(bucket);
+      }
+      entries_[bucket_starts_[bucket] + bucket_sizes_[bucket]++] = record;
+    }
+  }
+}
+
+void SpatialIndex::remove_from_buckets(const Range& range, const uint32_t record)
+{
+  for (int y = range.min_y; y <= range.max_y; y++)
+  {
+    for (int x = range.min_x; x <= range.max_x; x++)
+    {
+      const auto bucket = (y * columns_) + x;
+      auto* first = entries_.data() + bucket_starts_[bucket];
+      auto* last = first + bucket_sizes_[bucket];
+      bucket_sizes_[bucket] = static_cast<uint32_t>(std::remove(first, last, record) - first);
+    }
+  }
+}
+
+void SpatialIndex::grow_bucket(const int bucket)
+{
+  const auto room = bucket_starts_[bucket + 1] - bucket_starts_[bucket];
+  const auto extra = std::max(static_cast<uint32_t>(BUCKET_CAPACITY), room);
+  entries_.insert(entries_.begin() + bucket_starts_[bucket + 1], extra, 0u);
+  for (auto i = static_cast<std::size_t>(bucket) + 1u; i < bucket_starts_.size(); i++)
+  {
+    bucket_starts_[i] += extra;
+  }
+}
@@ -1,3 +0,0 @@
-#include "tile.h"
-
-const Tile Tile::INVALID;
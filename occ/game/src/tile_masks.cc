@@ -0,0 +1,69 @@
+#include "tile_masks.h"
+
+#include <algorithm>
+
+namespace
+{
+// Returns a word with bits [from, to] set
+std::uint64_t bit_range(const int from, const int to)
+{
+  const auto high = to == 63 ? ~std::uint64_t(0) : (std::uint64_t(1) << (to + 1)) - 1;
+  return high & ~((std::uint64_t(1) << from) - 1);
+}
+}
+
+void TileMasks::build(const std::vector<Tile>& tiles, const int width, const int height)
+{
+  width_ = width;
+  height_ = height;
+  words_per_row_ = (width + 63) / 64;
+  for (std::size_t i = 0; i < MASK_FLAGS.size(); i++)
+  {
+    auto& mask = masks_[i];
+    mask.assign(static_cast<std::size_t>(words_per_row_) * height, 0u);
+    for (int y = 0; y < height; y++)
+    {
+      for (int x = 0; x < width; x++)
+      {
+        if (tiles[(y * width) + x].get_flags() & MASK_FLAGS[i])
+        {
+          mask[(y * words_per_row_) + (x / 64)] |= std::uint64_t(1) << (x % 64);
+        }
+      }
+    }
+  }
+}
+
+bool TileMasks::any(int min_x, int min_y, int max_x, int max_y, const int flags) const
+{
+  min_x = std::max(min_x, 0);
+  min_y = std::max(min_y, 0);
+  max_x = std::min(max_x, width_ - 1);
+  max_y = std::min(max_y, height_ - 1);
+  if (min_x > max_x || min_y > max_y)
+  {
+    return false;
+  }
+
+  for (std::size_t i = 0; i < MASK_FLAGS.size(); i++)
+  {
+    if (!(flags & MASK_FLAGS[i]))
+    {
+      continue;
+    }
+    for (int y = min_y; y <= max_y; y++)
+    {
+      const auto* row = masks_[i].data() + (y * words_per_row_);
+      for (int word = min_x / 64; word <= max_x / 64; word++)
+      {
+        const int from = word == min_x / 64 ? min_x % 64 : 0;
+        const int to = word == max_x / 64 ? max_x % 64 : 63;
+        if (row[word] & bit_range(from, to))
+        {
+          return true;
+        }
+      }
+    }
+  }
+  return false;
+}
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <memory>
+
+#include "game_impl.h"
+#include "level.h"
+#include "test_level.h"
+
+namespace
+{
+// Creates a long corridor with the player at the left end and a snake at the right end
+std::unique_ptr<Level> create_level()
+{
+  auto level = create_room(100, 6, geometry::Position(2 * 16, 4 * 16));
+  level->add_enemy<Snake>(geometry::Position(90 * 16, 4 * 16));
+  return level;
+}
+
+geometry::Position get_snake_position(const Game& game)
+{
+  geometry::Position position;
+  game.get_level().enemies.get<Snake>().for_each([&position](const Snake& snake) { position = snake.position; });
+  return position;
+}
+}
+
+TEST(Activity, SimulateAll)
+{
+  GameImpl game;
+  ASSERT_TRUE(game.init(create_level()));
+
+  // All entities are simulated by default
+  game.update(0u, PlayerInput());
+  EXPECT_EQ(1u, game.get_num_simulated());
+  EXPECT_EQ(1u, game.get_objects().size());
+}
+
+TEST(Activity, SleepUntilPlayerIsNear)
+{
+  GameImpl game;
+  ASSERT_TRUE(game.init(create_level()));
+  game.set_activity_area(geometry::Size(320, 192), 16);
+
+  const auto start_position = get_snake_position(game);
+  unsigned tick = 0u;
+  for (; tick < 10u; tick++)
+  {
+    game.update(tick, PlayerInput());
+    EXPECT_EQ(0u, game.get_num_simulated());
+    EXPECT_TRUE(game.get_objects().empty());
+  }
+  EXPECT_EQ(start_position, get_snake_position(game));
+
+  // Walk right until the snake wakes up
+  PlayerInput input;
+  input.right = true;
+  for (; tick < 1000u && game.get_num_simulated() == 0u; tick++)
+  {
+    game.update(tick, input);
+  }
+  ASSERT_EQ(1u, game.get_num_simulated());
+  EXPECT_LT(game.get_player().position.x(), start_position.x());
+
+  // The snake continues from where it fell asleep
+  const auto wake_position = get_snake_position(game);
+  EXPECT_EQ(2, std::abs(wake_position.x() - start_position.x()));
+
+  // Disabling the activity area simulates everything again
+  game.set_activity_area(geometry::Size(320, 192), -1);
+  game.update(tick, PlayerInput());
+  EXPECT_EQ(1u, game.get_num_simulated());
+}
+
+TEST(Activity, ProjectilesDoNotSleep)
+{
+  // A laser at the left end of the corridor fires at the player, and its beam flies out of the activity area
+  auto level = create_room(100, 6, geometry::Position(6 * 16, 4 * 16));
+  level->add_hazard<Laser>(geometry::Position(2 * 16, 4 * 16), false);
+  GameImpl game;
+  ASSERT_TRUE(game.init(std::move(level)));
+  game.set_activity_area(geometry::Size(320, 192), 16);
+
+  // The beam has to reach the far wall before the laser can fire again
+  int last_beam_x = 0;
+  bool fired_again = false;
+  for (unsigned tick = 0u; tick < 1000u && !fired_again; tick++)
+  {
+    game.update(tick, PlayerInput());
+    game.get_level().hazards.get<LaserBeam>().for_each(
+      [&last_beam_x, &fired_again](const LaserBeam& beam)
+      {
+        fired_again = beam.position.x() < last_beam_x;
+        last_beam_x = beam.position.x();
+      });
+  }
+  EXPECT_TRUE(fired_again);
+}
@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include "allocation_counter.h"
+#include "game_impl.h"
+#include "level.h"
+#include "test_level.h"
+
+namespace
+{
+// Creates a closed room with a floor halfway up, containing enemies, hazards and actors
+// Slimes are left out since they move randomly and could enter parts of the room they have not visited before
+std::unique_ptr<Level> create_level()
+{
+  auto level = create_room(30, 12, geometry::Position(2 * 16, 10 * 16), [](const int x, const int y) { return y == 6 && x < 20; });
+
+  level->add_enemy<Hopper>(geometry::Position(10 * 16, 10 * 16));
+  level->add_enemy<Snake>(geometry::Position(15 * 16, 10 * 16));
+  level->add_enemy<Bigfoot>(geometry::Position(20 * 16, 10 * 16));
+  level->add_enemy<Spider>(geometry::Position(5 * 16, 7 * 16));
+  level->add_hazard<Thorn>(geometry::Position(8 * 16, 10 * 16));
+  level->add_hazard<Laser>(geometry::Position(27 * 16, 10 * 16), true);
+  level->add_hazard<AirTank>(geometry::Position(12 * 16, 10 * 16), false);
+  level->add_actor<Lever>(geometry::Position(25 * 16, 10 * 16), LeverColor::LEVER_COLOR_B);
+  level->add_actor<Door>(geometry::Position(18 * 16, 4 * 16), LeverColor::LEVER_COLOR_B);
+  level->exit = std::make_unique<Exit>(geometry::Position(22 * 16, 4 * 16));
+  return level;
+}
+}
+
+TEST(Allocation, NoAllocationsPerTick)
+{
+  GameImpl game;
+  ASSERT_TRUE(game.init(create_level()));
+
+  // Let all entities and the object list reach their steady state
+  unsigned tick = 0u;
+  for (; tick < 500u; tick++)
+  {
+    game.update(tick, walk_back_and_forth(tick));
+  }
+
+  const auto allocations_before = get_num_allocations();
+  for (; tick < 1500u; tick++)
+  {
+    game.update(tick, walk_back_and_forth(tick));
+  }
+  const auto allocations = get_num_allocations() - allocations_before;
+
+  EXPECT_EQ(0u, allocations);
+  EXPECT_FALSE(game.get_objects().empty());
+}
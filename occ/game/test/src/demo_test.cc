@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+#include "demo.h"
+#include "exe_data.h"
+#include "game.h"
+#include "path.h"
+#include "temp_dir_test.h"
+#include "test_level.h"
+
+namespace
+{
+using DemoTest = TempDirTest;
+}
+
+TEST_F(DemoTest, PackUnpack)
+{
+  PlayerInput input;
+  EXPECT_EQ(0u, Demo::pack(input));
+
+  input.left = true;
+  input.jump_pressed = true;
+  input.level_warp_pressed = true;
+  const auto unpacked = Demo::unpack(Demo::pack(input));
+  EXPECT_TRUE(unpacked.left);
+  EXPECT_TRUE(unpacked.jump_pressed);
+  EXPECT_TRUE(unpacked.level_warp_pressed);
+  EXPECT_FALSE(unpacked.right);
+  EXPECT_FALSE(unpacked.shoot);
+  EXPECT_EQ(Demo::pack(input), Demo::pack(unpacked));
+}
+
+TEST_F(DemoTest, SaveLoad)
+{
+  Demo demo{1234u, geometry::Size(320, 200), 64};
+  demo.start_level(LevelId::MAIN_LEVEL, 0u);
+  for (unsigned tick = 0u; tick < 200u; tick++)
+  {
+    demo.add(walk_back_and_forth(tick, true));
+  }
+  // Restarted before any input
+  demo.start_level(LevelId::LEVEL_1, 200u);
+  demo.start_level(LevelId::LEVEL_1, 200u);
+  demo.add(walk_back_and_forth(0u, true));
+
+  // Consecutive equal inputs are stored as one run
+  ASSERT_EQ(2u, demo.get_segments().size());
+  EXPECT_LT(demo.get_segments()[0].runs.size(), 40u);
+  EXPECT_EQ(201u, demo.get_num_ticks());
+
+  const auto path = dir_ / "test.dem";
+  ASSERT_TRUE(demo.save(path));
+  const auto loaded = Demo::load(path);
+  ASSERT_TRUE(loaded);
+  EXPECT_EQ(1234u, loaded->get_seed());
+  ASSERT_EQ(2u, loaded->get_segments().size());
+  EXPECT_EQ(LevelId::LEVEL_1, loaded->get_segments()[1].level);
+  EXPECT_EQ(200u, loaded->get_segments()[1].first_tick);
+  ASSERT_EQ(demo.get_segments()[0].runs.size(), loaded->get_segments()[0].runs.size());
+  for (std::size_t i = 0u; i < demo.get_segments()[0].runs.size(); i++)
+  {
+    EXPECT_EQ(demo.get_segments()[0].runs[i].input, loaded->get_segments()[0].runs[i].input);
+    EXPECT_EQ(demo.get_segments()[0].runs[i].count, loaded->get_segments()[0].runs[i].count);
+  }
+
+  // Truncated files and other files are rejected
+  const auto size = std::filesystem::file_size(path);
+  std::filesystem::resize_file(path, size - 1u);
+  EXPECT_FALSE(Demo::load(path));
+  {
+    std::ofstream output{path, std::ios::binary | std::ios::trunc};
+    output << "not a demo file at all";
+  }
+  EXPECT_FALSE(Demo::load(path));
+  EXPECT_FALSE(Demo::load(dir_ / "missing.dem"));
+}
+
+TEST_F(DemoTest, InvalidLevel)
+{
+  const auto path = dir_ / "test.dem";
+  for (const auto level : {-1, static_cast<int>(LevelId::LEVEL_16) + 1})
+  {
+    Demo demo{1234u, geometry::Size(320, 200), 64};
+    demo.start_level(LevelId::MAIN_LEVEL, 0u);
+    demo.add(walk_back_and_forth(0u, true));
+    demo.start_level(static_cast<LevelId>(level), 1u);
+    demo.add(walk_back_and_forth(1u, true));
+    ASSERT_TRUE(demo.save(path));
+    EXPECT_FALSE(Demo::load(path));
+  }
+}
+
+TEST_F(DemoTest, Replay)
+{
+  if (get_data_path("CC1.EXE").empty())
+  {
+    GTEST_SKIP() << "CC1.EXE not found";
+  }
+  const ExeData exe_data{1};
+
+  // Record two levels the way GameState does
+  auto game = Game::create(42u);
+  Demo demo{game->get_seed(), geometry::Size(320, 200), 64};
+  game->set_activity_area(geometry::Size(320, 200), 64);
+  unsigned game_tick = 0u;
+  unsigned num_shots = 0u;
+  for (const auto level : {LevelId::MAIN_LEVEL, LevelId::LEVEL_1})
+  {
+    ASSERT_TRUE(game->init(exe_data, level));
+    demo.start_level(level, game_tick);
+    for (unsigned i = 0u; i < 500u; i++, game_tick++)
+    {
+      const auto input = walk_back_and_forth(game_tick, true);
+      demo.add(input);
+      const auto num_ammo = game->get_num_ammo();
+      game->update(game_tick, input);
+      num_shots += game->get_num_ammo() < num_ammo ? 1u : 0u;
+    }
+  }
+  // The missiles are part of the state that the replay has to reproduce
+  ASSERT_GT(num_shots, 0u);
+  const auto expected = get_state(*game);
+
+  const auto path = dir_ / "test.dem";
+  ASSERT_TRUE(demo.save(path));
+  const auto loaded = Demo::load(path);
+  ASSERT_TRUE(loaded);
+  EXPECT_EQ(1000u, loaded->get_num_ticks());
+
+  auto replayed = Game::create(loaded->get_seed());
+  ASSERT_TRUE(loaded->replay(*replayed, exe_data));
+  EXPECT_EQ(expected, get_state(*replayed));
+  EXPECT_EQ(game->get_num_ammo(), replayed->get_num_ammo());
+
+  // The seed decides e.g. how enemies move, so a game with another seed is refused
+  auto other = Game::create(43u);
+  EXPECT_FALSE(loaded->replay(*other, exe_data));
+}
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "exe_data.h"
+#include "game_impl.h"
+#include "level.h"
+#include "level_cache.h"
+#include "path.h"
+#include "test_level.h"
+
+namespace
+{
+// Adds another hopper and slime, which both move randomly
+std::unique_ptr<Level> create_level(const uint64_t seed)
+{
+  auto level = create_test_level(seed);
+  level->add_enemy<Hopper>(geometry::Position(20 * 16, 4 * 16));
+  level->add_enemy<Slime>(geometry::Position(25 * 16, 9 * 16));
+  return level;
+}
+}
+
+TEST(Determinism, SameSeedSameTicks)
+{
+  GameImpl a;
+  GameImpl b;
+  GameImpl c;
+  ASSERT_TRUE(a.init(create_level(1u)));
+  ASSERT_TRUE(b.init(create_level(1u)));
+  ASSERT_TRUE(c.init(create_level(2u)));
+
+  // Two games at the same time must not affect each other
+  std::vector<int> trace_a;
+  std::thread thread([&a, &trace_a]() { trace_a = run(a, 0u, 1000u); });
+  const auto trace_b = run(b, 0u, 1000u);
+  thread.join();
+  const auto trace_c = run(c, 0u, 1000u);
+
+  EXPECT_EQ(trace_a, trace_b);
+  EXPECT_EQ(a.get_level().random, b.get_level().random);
+  EXPECT_NE(trace_a, trace_c);
+}
+
+TEST(Determinism, ShippedLevels)
+{
+  if (get_data_path("CC1.EXE").empty())
+  {
+    GTEST_SKIP() << "CC1.EXE not found";
+  }
+  const ExeData exe_data{1};
+
+  // b and c share a level cache, which must not change how their levels play
+  const auto level_cache = std::make_shared<LevelCache>();
+  bool other_seed_differs = false;
+  for (int level_id = static_cast<int>(LevelId::INTRO); level_id <= static_cast<int>(LevelId::LEVEL_16); level_id++)
+  {
+    auto a = Game::create(1234u);
+    auto b = Game::create(1234u, level_cache);
+    auto c = Game::create(4321u, level_cache);
+    ASSERT_TRUE(a->init(exe_data, static_cast<LevelId>(level_id)));
+    ASSERT_TRUE(b->init(exe_data, static_cast<LevelId>(level_id)));
+    ASSERT_TRUE(c->init(exe_data, static_cast<LevelId>(level_id)));
+
+    EXPECT_EQ(a->get_level().bgs, b->get_level().bgs);
+    EXPECT_EQ(run(*a, 0u, 300u), run(*b, 0u, 300u));
+    other_seed_differs = other_seed_differs || a->get_level().bgs != c->get_level().bgs;
+  }
+  // The star and horizon backgrounds depend on the seed
+  EXPECT_TRUE(other_seed_differs);
+}
@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "enemy.h"
+#include "entity_pool.h"
+#include "hazard.h"
+
+TEST(EntityPool, EmplaceAndErase)
+{
+  EntityPool<Hopper> pool;
+  EXPECT_EQ(0u, pool.size());
+
+  std::vector<Hopper*> hoppers;
+  for (int i = 0; i < 100; i++)
+  {
+    hoppers.push_back(&pool.emplace(geometry::Position(i, 0)));
+  }
+  EXPECT_EQ(100u, pool.size());
+
+  // Entities never move
+  for (int i = 0; i < 100; i++)
+  {
+    EXPECT_EQ(i, hoppers[i]->position.x());
+  }
+
+  pool.erase(hoppers[10]);
+  pool.erase(hoppers[80]);
+  EXPECT_EQ(98u, pool.size());
+
+  std::vector<int> visited;
+  pool.for_each([&visited](const Hopper& hopper) { visited.push_back(hopper.position.x()); });
+  ASSERT_EQ(98u, visited.size());
+  EXPECT_EQ(9, visited[9]);
+  EXPECT_EQ(11, visited[10]);
+
+  // Erased slots are reused
+  EXPECT_EQ(hoppers[80], &pool.emplace(geometry::Position(1000, 0)));
+  EXPECT_EQ(99u, pool.size());
+
+  pool.clear();
+  EXPECT_EQ(0u, pool.size());
+}
+
+TEST(EntityPool, EmplaceWhileIterating)
+{
+  EntityPool<Hopper> pool;
+  pool.emplace(geometry::Position(0, 0));
+
+  // Entities created during iteration are visited in the same iteration
+  int num_visited = 0;
+  pool.for_each(
+    [&pool, &num_visited](const Hopper& hopper)
+    {
+      num_visited++;
+      if (hopper.position.x() < 200)
+      {
+        pool.emplace(hopper.position + geometry::Position(1, 0));
+      }
+    });
+  EXPECT_EQ(201, num_visited);
+  EXPECT_EQ(201u, pool.size());
+}
+
+TEST(EntityPools, ForEachVisitsPoolsInOrder)
+{
+  EntityPools<Hopper, Thorn, Snake> pools;
+  pools.get<Snake>().emplace(geometry::Position(0, 0));
+  pools.get<Hopper>().emplace(geometry::Position(1, 0));
+  pools.get<Thorn>().emplace(geometry::Position(2, 0));
+  pools.get<Hopper>().emplace(geometry::Position(3, 0));
+  EXPECT_EQ(4u, pools.size());
+
+  std::vector<int> visited;
+  pools.for_each([&visited](const Actor& actor) { visited.push_back(actor.position.x()); });
+  EXPECT_EQ(std::vector<int>({1, 3, 2, 0}), visited);
+
+  pools.clear();
+  EXPECT_EQ(0u, pools.size());
+}
@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include "exe_data.h"
+#include "level.h"
+#include "level_cache.h"
+#include "level_loader.h"
+#include "level_prefetcher.h"
+#include "path.h"
+#include "test_level.h"
+
+namespace
+{
+// Creates a corridor with a laser at the right end facing left
+std::unique_ptr<Level> create_level()
+{
+  auto level = create_room(20, 6, geometry::Position(2 * 16, 4 * 16));
+
+  level->add_hazard<Laser>(geometry::Position(17 * 16, 4 * 16), true);
+  level->add_enemy<Snake>(geometry::Position(8 * 16, 4 * 16));
+  return level;
+}
+
+// Updates the lasers and laser beams of the level once
+void update_lasers(Level& level, const geometry::Rectangle& player_rect)
+{
+  level.hazards.get<Laser>().for_each([&](Laser& laser) { laser.update(player_rect, level); });
+  level.hazards.get<LaserBeam>().for_each([&](LaserBeam& beam) { beam.update(player_rect, level); });
+}
+}
+
+TEST(LevelCache, CloneRelocatesPointers)
+{
+  const auto original = create_level();
+  const geometry::Rectangle player_rect(original->player_spawn, geometry::Size(16, 16));
+
+  // Fire a beam, which refers to its laser and the other way around
+  update_lasers(*original, player_rect);
+  ASSERT_EQ(1u, original->hazards.get<LaserBeam>().size());
+
+  const auto clone = original->clone();
+  EXPECT_EQ(original->tiles.size(), clone->tiles.size());
+  EXPECT_EQ(original->enemies.size(), clone->enemies.size());
+  EXPECT_EQ(original->hazards.size(), clone->hazards.size());
+  EXPECT_EQ(original->hazard_index.size(), clone->hazard_index.size());
+
+  // The spatial index of the clone refers to the entities of the clone
+  const LaserBeam* original_beam = nullptr;
+  original->hazards.get<LaserBeam>().for_each([&original_beam](const LaserBeam& beam) { original_beam = &beam; });
+  const LaserBeam* beam = nullptr;
+  clone->hazards.get<LaserBeam>().for_each([&beam](const LaserBeam& b) { beam = &b; });
+  ASSERT_NE(nullptr, beam);
+  EXPECT_NE(original_beam, beam);
+  EXPECT_EQ(beam, clone->hazard_index.find_first(geometry::Rectangle(beam->position, beam->size)));
+  EXPECT_EQ(clone->relocate(*original, original_beam), beam);
+
+  // When the beam of the clone hits the wall it must notify the laser of the clone, which then fires again,
+  // while the laser of the original still waits for its own beam
+  for (int i = 0; i < 100; i++)
+  {
+    update_lasers(*clone, player_rect);
+  }
+  EXPECT_LT(1u, clone->hazards.get<LaserBeam>().size());
+  update_lasers(*original, player_rect);
+  EXPECT_EQ(1u, original->hazards.get<LaserBeam>().size());
+}
+
+TEST(LevelCache, ShippedLevels)
+{
+  if (get_data_path("CC1.EXE").empty())
+  {
+    GTEST_SKIP() << "CC1.EXE not found";
+  }
+  const ExeData exe_data{1};
+  LevelCache cache;
+
+  for (int level_id = static_cast<int>(LevelId::INTRO); level_id <= static_cast<int>(LevelId::LEVEL_16); level_id++)
+  {
+    const auto first = cache.get(exe_data, static_cast<LevelId>(level_id), 0u);
+    const auto second = cache.get(exe_data, static_cast<LevelId>(level_id), 0u);
+    ASSERT_NE(nullptr, first);
+    ASSERT_NE(nullptr, second);
+    EXPECT_NE(first.get(), second.get());
+    EXPECT_EQ(first->width, second->width);
+    EXPECT_EQ(first->height, second->height);
+    EXPECT_EQ(first->bgs, second->bgs);
+    EXPECT_EQ(first->random, second->random);
+    EXPECT_EQ(first->enemies.size(), second->enemies.size());
+    EXPECT_EQ(first->hazards.size(), second->hazards.size());
+    EXPECT_EQ(first->actors.size(), second->actors.size());
+    EXPECT_EQ(first->enemy_index.size(), second->enemy_index.size());
+
+    // Clones of the shared prototype are randomized like a level loaded with the seed
+    const auto seeded = cache.get(exe_data, static_cast<LevelId>(level_id), 7u);
+    const auto loaded = LevelLoader::load(exe_data, static_cast<LevelId>(level_id), 7u);
+    ASSERT_NE(nullptr, seeded);
+    ASSERT_NE(nullptr, loaded);
+    EXPECT_EQ(loaded->bgs, seeded->bgs);
+    EXPECT_EQ(loaded->random, seeded->random);
+  }
+}
+
+TEST(LevelPrefetcher, Take)
+{
+  if (get_data_path("CC1.EXE").empty())
+  {
+    GTEST_SKIP() << "CC1.EXE not found";
+  }
+  const ExeData exe_data{1};
+  LevelPrefetcher prefetcher(std::make_shared<LevelCache>());
+
+  prefetcher.prefetch(exe_data, LevelId::LEVEL_1, 0u);
+  EXPECT_TRUE(prefetcher.is_prefetching(LevelId::LEVEL_1));
+  EXPECT_FALSE(prefetcher.is_prefetching(LevelId::LEVEL_2));
+
+  const auto prefetched = prefetcher.take(exe_data, LevelId::LEVEL_1, 0u);
+  ASSERT_NE(nullptr, prefetched);
+  EXPECT_EQ(LevelId::LEVEL_1, prefetched->level_id);
+  EXPECT_FALSE(prefetcher.is_prefetching(LevelId::LEVEL_1));
+
+  // Levels that were not prefetched are prepared when taken
+  const auto level = prefetcher.take(exe_data, LevelId::LEVEL_2, 0u);
+  ASSERT_NE(nullptr, level);
+  EXPECT_EQ(LevelId::LEVEL_2, level->level_id);
+}
+
+TEST(LevelPrefetcher, SourceChanged)
+{
+  if (get_data_path("CC1.EXE").empty())
+  {
+    GTEST_SKIP() << "CC1.EXE not found";
+  }
+  auto old_exe_data = std::make_unique<ExeData>(1);
+  const ExeData exe_data{1};
+  LevelPrefetcher prefetcher(std::make_shared<LevelCache>());
+
+  // Levels still queued when the source changes are not loaded from the old EXE data, which is gone by then
+  for (int level_id = static_cast<int>(LevelId::LEVEL_1); level_id <= static_cast<int>(LevelId::LEVEL_16); level_id++)
+  {
+    prefetcher.prefetch(*old_exe_data, static_cast<LevelId>(level_id), 0u);
+  }
+  const auto level = prefetcher.take(exe_data, LevelId::LEVEL_1, 1u);
+  old_exe_data.reset();
+  ASSERT_NE(nullptr, level);
+  EXPECT_FALSE(prefetcher.is_prefetching(LevelId::LEVEL_16));
+
+  prefetcher.prefetch(exe_data, LevelId::LEVEL_16, 1u);
+  const auto prefetched = prefetcher.take(exe_data, LevelId::LEVEL_16, 1u);
+  ASSERT_NE(nullptr, prefetched);
+  EXPECT_EQ(LevelId::LEVEL_16, prefetched->level_id);
+}
@@ -0,0 +1,188 @@
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <random>
+
+#include "actor.h"
+#include "exe_data.h"
+#include "game.h"
+#include "level.h"
+#include "movement.h"
+#include "path.h"
+
+namespace
+{
+
+// Reference implementation: move one pixel at a time and stop before the first colliding position
+Movement::Result step_x(const Level& level, geometry::Position position, const geometry::Size& size, const int velocity)
+{
+  const auto destination = position.x() + velocity;
+  const auto step = destination > position.x() ? 1 : -1;
+  int distance = 0;
+  while (position.x() != destination)
+  {
+    const auto new_position = position + geometry::Position(step, 0);
+    if (level.collides_solid(new_position, size) || new_position.x() < 0 || new_position.x() >= level.width * 16 - size.x())
+    {
+      return {distance, true};
+    }
+    position = new_position;
+    distance++;
+  }
+  return {distance, false};
+}
+
+bool step_on_platform(const Level& level, const geometry::Position& position, const geometry::Size& size)
+{
+  if ((position.y() + size.y() - 1) % 16 == 0)
+  {
+    if (level.get_tile(position.x() / 16, (position.y() + size.y() - 1) / 16).is_solid_top() ||
+        level.get_tile((position.x() + size.x()) / 16, (position.y() + size.y() - 1) / 16).is_solid_top())
+    {
+      return true;
+    }
+  }
+  for (const auto& platform : level.moving_platforms)
+  {
+    if ((position.y() + size.y() - 1 == platform.position.y()) && (position.x() < platform.position.x() + 16) &&
+        (position.x() + size.x() > platform.position.x()))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+Movement::Result step_y(const Level& level, geometry::Position position, const geometry::Size& size, const int velocity)
+{
+  const auto destination = position.y() + velocity;
+  const auto step = destination > position.y() ? 1 : -1;
+  int distance = 0;
+  while (position.y() != destination)
+  {
+    const auto new_position = position + geometry::Position(0, step);
+    if (level.collides_solid(new_position, size) || (step == 1 && step_on_platform(level, new_position, size)))
+    {
+      return {distance, true};
+    }
+    position = new_position;
+    distance++;
+  }
+  return {distance, false};
+}
+
+// Compares the swept movement against the reference for all velocities in [-max_velocity, max_velocity]
+void expect_same_movement(const Level& level, const geometry::Position& position, const geometry::Size& size, const int max_velocity)
+{
+  for (int velocity = -max_velocity; velocity <= max_velocity; velocity++)
+  {
+    const auto expected_x = step_x(level, position, size, velocity);
+    const auto actual_x = Movement::move_x(level, position, size, velocity);
+    ASSERT_EQ(expected_x.distance, actual_x.distance) << "x at (" << position.x() << ", " << position.y() << ") velocity " << velocity;
+    ASSERT_EQ(expected_x.collided, actual_x.collided) << "x at (" << position.x() << ", " << position.y() << ") velocity " << velocity;
+
+    const auto expected_y = step_y(level, position, size, velocity);
+    const auto actual_y = Movement::move_y(level, position, size, velocity);
+    ASSERT_EQ(expected_y.distance, actual_y.distance) << "y at (" << position.x() << ", " << position.y() << ") velocity " << velocity;
+    ASSERT_EQ(expected_y.collided, actual_y.collided) << "y at (" << position.x() << ", " << position.y() << ") velocity " << velocity;
+  }
+}
+
+// Creates a level with random solid and solid top tiles, doors and moving platforms
+std::unique_ptr<Level> create_random_level(const unsigned seed)
+{
+  std::mt19937 gen(seed);
+  auto level = std::make_unique<Level>();
+  level->width = 20;
+  level->height = 12;
+  for (int i = 0; i < level->width * level->height; i++)
+  {
+    const auto r = gen() % 10;
+    level->tiles.emplace_back(0, 1, r == 0 ? TILE_SOLID : (r == 1 ? TILE_SOLID_TOP : 0));
+  }
+  level->finalize();
+  level->add_actor<Door>(geometry::Position(gen() % 300, gen() % 170), LeverColor::LEVER_COLOR_R);
+  level->add_actor<Door>(geometry::Position(gen() % 300, gen() % 170), LeverColor::LEVER_COLOR_B);
+  level->lever_on.set(static_cast<std::size_t>(LeverColor::LEVER_COLOR_B));
+  level->moving_platforms.emplace_back(geometry::Position(gen() % 300, gen() % 170), false, false);
+  level->moving_platforms.emplace_back(geometry::Position(gen() % 300, gen() % 170), true, false);
+  return level;
+}
+
+struct InputStep
+{
+  unsigned num_ticks;
+  bool left;
+  bool right;
+  bool jump;
+};
+
+// Input sequence replayed on the shipped levels: walking, jumping and falling in both directions
+constexpr InputStep recorded_inputs[] = {
+  {30u, false, true, false}, {12u, false, true, true},  {5u, false, false, false}, {20u, false, false, true},
+  {45u, true, false, false}, {16u, true, false, true},  {8u, false, true, false},  {16u, false, false, true},
+  {60u, false, true, false}, {20u, false, true, true},  {40u, true, false, false}, {4u, true, true, false},
+  {30u, true, false, true},  {10u, false, false, false}, {25u, false, true, true},  {35u, true, false, false},
+};
+
+}  // namespace
+
+TEST(Movement, RandomLevels)
+{
+  const auto size = geometry::Size(12, 16);
+  for (unsigned seed = 0u; seed < 6u; seed++)
+  {
+    const auto level = create_random_level(seed);
+    for (int y = -24; y < level->height * 16 + 8; y += 3)
+    {
+      for (int x = -8; x < level->width * 16 + 8; x += 5)
+      {
+        expect_same_movement(*level, geometry::Position(x, y), size, 16);
+        if (HasFatalFailure())
+        {
+          return;
+        }
+      }
+    }
+  }
+}
+
+TEST(Movement, ShippedLevels)
+{
+  if (get_data_path("CC1.EXE").empty())
+  {
+    GTEST_SKIP() << "CC1.EXE not found";
+  }
+  const ExeData exe_data{1};
+
+  for (int level_id = static_cast<int>(LevelId::INTRO); level_id <= static_cast<int>(LevelId::LEVEL_16); level_id++)
+  {
+    auto game = Game::create();
+    ASSERT_TRUE(game->init(exe_data, static_cast<LevelId>(level_id)));
+
+    // Replay the inputs a few times, and at each tick compare the swept movement against the
+    // reference for all velocities the player can have
+    unsigned tick = 0u;
+    for (int repeat = 0; repeat < 4; repeat++)
+    {
+      for (const auto& step : recorded_inputs)
+      {
+        for (unsigned i = 0u; i < step.num_ticks; i++, tick++)
+        {
+          PlayerInput input;
+          input.left = step.left;
+          input.right = step.right;
+          input.jump = step.jump;
+          game->update(tick, input);
+
+          const auto& player = game->get_player();
+          expect_same_movement(game->get_level(), player.position, player.size, 8);
+          if (HasFatalFailure())
+          {
+            FAIL() << "level " << level_id << " tick " << tick;
+          }
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "game_impl.h"
+#include "level.h"
+#include "random.h"
+#include "rewind.h"
+#include "snapshot.h"
+#include "test_level.h"
+
+namespace
+{
+// Adds a laser that fires when the player walks by
+std::unique_ptr<Level> create_level()
+{
+  auto level = create_test_level();
+  level->add_hazard<Laser>(geometry::Position(28 * 16, 10 * 16), true);
+  return level;
+}
+
+// Plays num_ticks ticks, capturing each one, and returns the state after each tick
+std::vector<std::vector<int>> play(GameImpl& game, Rewind& rewind, const unsigned num_ticks)
+{
+  std::vector<std::vector<int>> states;
+  for (unsigned tick = 0u; tick < num_ticks; tick++)
+  {
+    game.update(tick, walk_back_and_forth(tick, true));
+    rewind.capture(game);
+    states.push_back(get_state(game));
+  }
+  return states;
+}
+}
+
+TEST(Rewind, StepBack)
+{
+  GameImpl game;
+  ASSERT_TRUE(game.init(create_level()));
+  Rewind rewind(1024u * 1024u, 1000u, 16u);
+  const auto states = play(game, rewind, 300u);
+  ASSERT_EQ(300u, rewind.get_num_ticks());
+  // Only missiles score in the test level, so missiles came and went and an enemy was killed between keyframes
+  ASSERT_GT(game.get_score(), 0u);
+
+  // Most ticks are stored as small differences to their keyframe
+  Snapshot snapshot;
+  game.snapshot(snapshot);
+  EXPECT_LT(rewind.get_bytes_used(), 300u * snapshot.size() / 4u);
+
+  for (auto i = states.size() - 1u; i > 0u; i--)
+  {
+    ASSERT_TRUE(rewind.step_back(game));
+    EXPECT_EQ(states[i - 1u], get_state(game)) << "tick " << i - 1u;
+  }
+  EXPECT_FALSE(rewind.step_back(game));
+
+  // Playing on after rewinding continues from the restored tick
+  game.update(0u, walk_back_and_forth(0u, true));
+  rewind.capture(game);
+  EXPECT_EQ(2u, rewind.get_num_ticks());
+  EXPECT_TRUE(rewind.step_back(game));
+  EXPECT_EQ(states[0], get_state(game));
+}
+
+TEST(Rewind, FixedSize)
+{
+  GameImpl game;
+  ASSERT_TRUE(game.init(create_level()));
+  Snapshot snapshot;
+  game.snapshot(snapshot);
+
+  // Room for a few keyframes only, the oldest ticks are dropped
+  const auto capacity = 4u * snapshot.size();
+  Rewind rewind(capacity, 1000u, 16u);
+  const auto states = play(game, rewind, 500u);
+  EXPECT_LE(rewind.get_bytes_used(), capacity);
+  EXPECT_LT(rewind.get_num_ticks(), 500u);
+  EXPECT_GE(rewind.get_num_ticks(), 16u);
+
+  const auto num_ticks = rewind.get_num_ticks();
+  auto i = states.size() - 1u;
+  while (rewind.step_back(game))
+  {
+    i--;
+    EXPECT_EQ(states[i], get_state(game)) << "tick " << i;
+  }
+  EXPECT_EQ(500u - num_ticks, i);
+
+  // At most max_ticks ticks are kept
+  Rewind short_rewind(1024u * 1024u, 20u, 16u);
+  play(game, short_rewind, 100u);
+  EXPECT_LE(short_rewind.get_num_ticks(), 20u);
+  EXPECT_GE(short_rewind.get_num_ticks(), 5u);
+}
+
+TEST(Rewind, VaryingSize)
+{
+  // Spiders keep spawning webs, so the snapshots grow as the game is played
+  auto level = create_room(14, 5, geometry::Position(2 * 16, 3 * 16));
+  level->random.seed(1u);
+  for (int x = 3; x < 12; x++)
+  {
+    level->add_enemy<Spider>(geometry::Position(x * 16, 1 * 16));
+  }
+  GameImpl game;
+  ASSERT_TRUE(game.init(std::move(level)));
+  Snapshot snapshots[2];
+  std::vector<int> states[2];
+  game.snapshot(snapshots[0]);
+  states[0] = get_state(game);
+  for (unsigned tick = 0u; tick < 300u; tick++)
+  {
+    game.update(tick, walk_back_and_forth(tick));
+  }
+  game.snapshot(snapshots[1]);
+  states[1] = get_state(game);
+  ASSERT_LT(snapshots[0].size() + 256u, snapshots[1].size());
+
+  // Capturing the small and the big snapshot in random order, each as a keyframe, makes frames of different sizes
+  // wrap around the buffer at different offsets for each buffer size
+  Random random(1u);
+  for (auto capacity = 2u * snapshots[1].size(); capacity < 4u * snapshots[1].size(); capacity += 97u)
+  {
+    Rewind rewind(capacity, 1000u, 1u);
+    std::vector<std::size_t> captured;
+    for (unsigned tick = 0u; tick < 100u; tick++)
+    {
+      captured.push_back(random.range<std::size_t>(0u, 1u));
+      ASSERT_TRUE(game.restore(snapshots[captured.back()]));
+      rewind.capture(game);
+      ASSERT_LE(rewind.get_bytes_used(), capacity);
+
+      // Every tick still in the buffer can be stepped back to
+      Rewind copy = rewind;
+      auto i = captured.size() - 1u;
+      while (copy.step_back(game))
+      {
+        i--;
+        ASSERT_EQ(states[captured[i]], get_state(game)) << "capacity " << capacity << ", tick " << i;
+      }
+      ASSERT_EQ(captured.size() - rewind.get_num_ticks(), i) << "capacity " << capacity;
+    }
+  }
+}
+
+TEST(Rewind, NewLevel)
+{
+  GameImpl game;
+  ASSERT_TRUE(game.init(create_level()));
+  Rewind rewind(1024u * 1024u, 1000u, 16u);
+  play(game, rewind, 10u);
+
+  // The ticks of another level can not be restored
+  ASSERT_TRUE(game.init(create_room(20, 6, geometry::Position(2 * 16, 4 * 16))));
+  EXPECT_FALSE(rewind.step_back(game));
+  EXPECT_EQ(0u, rewind.get_num_ticks());
+}
@@ -0,0 +1,182 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "exe_data.h"
+#include "game_impl.h"
+#include "level.h"
+#include "path.h"
+#include "snapshot.h"
+#include "test_level.h"
+
+namespace
+{
+// Adds a laser and a spider that spawn hazards which refer back to them
+std::unique_ptr<Level> create_level()
+{
+  auto level = create_test_level();
+  level->add_enemy<Spider>(geometry::Position(12 * 16, 7 * 16));
+  level->add_hazard<Laser>(geometry::Position(28 * 16, 10 * 16), true);
+  return level;
+}
+}
+
+TEST(Snapshot, ReadPastEnd)
+{
+  Snapshot snapshot;
+  snapshot.write(1u);
+  snapshot.write_vector(std::vector<int>{1, 2, 3});
+
+  Snapshot::Reader reader(snapshot);
+  unsigned value = 0u;
+  std::vector<int> values;
+  EXPECT_TRUE(reader.read(value));
+  EXPECT_EQ(1u, value);
+  EXPECT_TRUE(reader.read_vector(values));
+  EXPECT_EQ((std::vector<int>{1, 2, 3}), values);
+  EXPECT_TRUE(reader.at_end());
+  EXPECT_FALSE(reader.read(value));
+
+  // Memory is kept when cleared
+  const auto* data = snapshot.data();
+  snapshot.clear();
+  snapshot.write(2u);
+  EXPECT_EQ(data, snapshot.data());
+}
+
+TEST(Snapshot, RestorePlaysOutTheSame)
+{
+  GameImpl game;
+  ASSERT_TRUE(game.init(create_level()));
+  run(game, 0u, 100u, true);
+
+  Snapshot snapshot;
+  game.snapshot(snapshot);
+  const auto score = game.get_score();
+  const auto trace = run(game, 100u, 500u, true);
+  // Only missiles score in the test level, so a missile killed an enemy after the snapshot
+  ASSERT_GT(game.get_score(), score);
+
+  // Restoring again after the level has changed further must give the same result, and hazards spawned after the
+  // snapshot must be gone
+  for (int i = 0; i < 2; i++)
+  {
+    ASSERT_TRUE(game.restore(snapshot));
+    EXPECT_EQ(trace, run(game, 100u, 500u, true));
+  }
+
+  // Restoring the snapshot of another point in time gives the state of that point in time
+  Snapshot later;
+  game.snapshot(later);
+  ASSERT_TRUE(game.restore(snapshot));
+  run(game, 100u, 500u, true);
+  Snapshot again;
+  game.snapshot(again);
+  EXPECT_EQ(later.size(), again.size());
+}
+
+TEST(Snapshot, OtherGameOrLevel)
+{
+  GameImpl a;
+  GameImpl b;
+  ASSERT_TRUE(a.init(create_level()));
+  ASSERT_TRUE(b.init(create_level()));
+  run(a, 0u, 100u, true);
+
+  // Entities refer to each other by slot in the snapshot, so it can be restored into any game playing the same level
+  Snapshot snapshot;
+  a.snapshot(snapshot);
+  ASSERT_TRUE(b.restore(snapshot));
+  EXPECT_EQ(run(a, 100u, 500u, true), run(b, 100u, 500u, true));
+
+  // Also after the level is started again
+  ASSERT_TRUE(a.init(create_level()));
+  ASSERT_TRUE(a.restore(snapshot));
+  ASSERT_TRUE(b.restore(snapshot));
+  EXPECT_EQ(run(a, 100u, 500u, true), run(b, 100u, 500u, true));
+
+  // Snapshots of other levels are rejected and leave the game as it was
+  GameImpl c;
+  ASSERT_TRUE(c.init(create_room(20, 6, geometry::Position(2 * 16, 4 * 16))));
+  run(c, 0u, 100u, true);
+  Snapshot before;
+  c.snapshot(before);
+  EXPECT_FALSE(c.restore(snapshot));
+  Snapshot after;
+  c.snapshot(after);
+  EXPECT_TRUE(std::equal(before.data(), before.data() + before.size(), after.data(), after.data() + after.size()));
+}
+
+TEST(Snapshot, Truncated)
+{
+  GameImpl game;
+  ASSERT_TRUE(game.init(create_level()));
+  run(game, 0u, 200u, true);
+  Snapshot snapshot;
+  game.snapshot(snapshot);
+  run(game, 200u, 100u, true);
+  Snapshot before;
+  game.snapshot(before);
+
+  // The whole snapshot is checked before anything is restored
+  Snapshot truncated;
+  for (std::size_t size = 0u; size < snapshot.size(); size += 7u)
+  {
+    truncated.clear();
+    truncated.write_bytes(snapshot.data(), size);
+    EXPECT_FALSE(game.restore(truncated)) << "size " << size;
+  }
+  Snapshot after;
+  game.snapshot(after);
+  EXPECT_TRUE(std::equal(before.data(), before.data() + before.size(), after.data(), after.data() + after.size()));
+  EXPECT_TRUE(game.restore(snapshot));
+}
+
+TEST(Snapshot, SpiderKilledWhileWebFalls)
+{
+  // The spider fires a web at the player walking below it and is shot before the web lands
+  auto level = create_room(14, 6, geometry::Position(2 * 16, 4 * 16));
+  level->random.seed(1u);
+  level->add_enemy<Spider>(geometry::Position(8 * 16, 1 * 16));
+  GameImpl game;
+  ASSERT_TRUE(game.init(std::move(level)));
+  bool orphan_web = false;
+  for (unsigned tick = 0u; tick < 100u && !orphan_web; tick++)
+  {
+    auto input = walk_back_and_forth(tick);
+    input.shoot = tick % 2u == 0u;
+    game.update(tick, input);
+    orphan_web = game.get_level().enemies.get<Spider>().size() == 0u && game.get_level().hazards.get<SpiderWeb>().size() == 1u;
+  }
+  ASSERT_TRUE(orphan_web);
+
+  // The web no longer refers to the spider, so the snapshot can be restored while it falls and after it lands
+  Snapshot snapshot;
+  game.snapshot(snapshot);
+  const auto trace = run(game, 100u, 50u, true);
+  ASSERT_TRUE(game.restore(snapshot));
+  EXPECT_EQ(trace, run(game, 100u, 50u, true));
+}
+
+TEST(Snapshot, ShippedLevels)
+{
+  if (get_data_path("CC1.EXE").empty())
+  {
+    GTEST_SKIP() << "CC1.EXE not found";
+  }
+  const ExeData exe_data{1};
+
+  Snapshot snapshot;
+  for (int level_id = static_cast<int>(LevelId::INTRO); level_id <= static_cast<int>(LevelId::LEVEL_16); level_id++)
+  {
+    auto game = Game::create(1234u);
+    ASSERT_TRUE(game->init(exe_data, static_cast<LevelId>(level_id)));
+    run(*game, 0u, 100u, true);
+    game->snapshot(snapshot);
+    const auto trace = run(*game, 100u, 300u, true);
+    ASSERT_TRUE(game->restore(snapshot));
+    EXPECT_EQ(trace, run(*game, 100u, 300u, true)) << "level " << level_id;
+  }
+}
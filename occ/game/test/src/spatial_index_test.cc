@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+
+#include "enemy.h"
+#include "spatial_index.h"
+
+TEST(SpatialIndex, FindFirst)
+{
+  SpatialIndex index;
+  index.reset(40, 24);
+
+  Hopper a(geometry::Position(0, 0));
+  Hopper b(geometry::Position(100, 100));
+  index.insert(&a);
+  index.insert(&b);
+  EXPECT_EQ(2u, index.size());
+
+  EXPECT_EQ(&a, index.find_first(geometry::Rectangle(8, 8, 4, 4)));
+  EXPECT_EQ(&b, index.find_first(geometry::Rectangle(110, 110, 16, 16)));
+  EXPECT_EQ(nullptr, index.find_first(geometry::Rectangle(50, 50, 16, 16)));
+
+  // Touching edges is not colliding
+  EXPECT_EQ(nullptr, index.find_first(geometry::Rectangle(16, 0, 16, 16)));
+}
+
+TEST(SpatialIndex, FindFirstReturnsFirstInserted)
+{
+  SpatialIndex index;
+  index.reset(40, 24);
+
+  // c spans more buckets than d, but d was inserted first
+  Bigfoot c(geometry::Position(60, 76));
+  Hopper d(geometry::Position(64, 64));
+  index.insert(&d);
+  index.insert(&c);
+
+  EXPECT_EQ(&d, index.find_first(geometry::Rectangle(60, 60, 32, 32)));
+  EXPECT_EQ(&c, index.find_first(geometry::Rectangle(60, 60, 32, 32), [&d](const Actor& actor) { return &actor != &d; }));
+}
+
+TEST(SpatialIndex, Update)
+{
+  SpatialIndex index;
+  index.reset(40, 24);
+
+  Hopper a(geometry::Position(0, 0));
+  index.insert(&a);
+
+  // Move a far away without updating, the index should still see the old bucket only
+  a.position = geometry::Position(300, 300);
+  EXPECT_EQ(nullptr, index.find_first(geometry::Rectangle(300, 300, 16, 16)));
+
+  index.update(&a);
+  EXPECT_EQ(&a, index.find_first(geometry::Rectangle(300, 300, 16, 16)));
+  EXPECT_EQ(nullptr, index.find_first(geometry::Rectangle(0, 0, 16, 16)));
+
+  index.remove(&a);
+  EXPECT_EQ(0u, index.size());
+  EXPECT_EQ(nullptr, index.find_first(geometry::Rectangle(300, 300, 16, 16)));
+}
+
+TEST(SpatialIndex, OutsideLevel)
+{
+  SpatialIndex index;
+  index.reset(4, 4);
+
+  // Actors and queries outside of the level are clamped to the edge buckets
+  Hopper a(geometry::Position(-20, -20));
+  Hopper b(geometry::Position(100, 30));
+  index.insert(&a);
+  index.insert(&b);
+
+  EXPECT_EQ(&a, index.find_first(geometry::Rectangle(-10, -10, 4, 4)));
+  EXPECT_EQ(&b, index.find_first(geometry::Rectangle(110, 40, 4, 4)));
+  EXPECT_EQ(nullptr, index.find_first(geometry::Rectangle(0, 0, 64, 64)));
+}
+
+TEST(SpatialIndex, InsertBeforeResize)
+{
+  SpatialIndex index;
+
+  // Queries on an index that is not sized yet find nothing
+  Hopper a(geometry::Position(0, 0));
+  Hopper b(geometry::Position(100, 100));
+  index.insert(&a);
+  index.insert(&b);
+  EXPECT_EQ(2u, index.size());
+  EXPECT_EQ(nullptr, index.find_first(geometry::Rectangle(0, 0, 200, 200)));
+
+  index.resize(40, 24);
+  EXPECT_EQ(2u, index.size());
+  EXPECT_EQ(&a, index.find_first(geometry::Rectangle(0, 0, 200, 200)));
+  EXPECT_EQ(&b, index.find_first(geometry::Rectangle(110, 110, 16, 16)));
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "game.h"
+#include "geometry.h"
+#include "level.h"
+#include "level_id.h"
+#include "player_input.h"
+#include "tile.h"
+
+// Creates a finalized room of width x height tiles, with solid walls around it and solid tiles wherever
+// solid(x, y) returns true, enemies, hazards and actors can then be added with Level::add_enemy etc.
+template <typename F>
+std::unique_ptr<Level> create_room(const int width, const int height, const geometry::Position& player_spawn, F solid)
+{
+  auto level = std::make_unique<Level>();
+  level->level_id = LevelId::LEVEL_1;
+  level->width = width;
+  level->height = height;
+  level->player_spawn = player_spawn;
+  for (int y = 0; y < height; y++)
+  {
+    for (int x = 0; x < width; x++)
+    {
+      const auto wall = x == 0 || x == width - 1 || y == 0 || y == height - 1;
+      level->tiles.emplace_back(0, 1, wall || solid(x, y) ? TILE_SOLID : 0);
+      level->bgs.push_back(-1);
+      level->items.emplace_back();
+    }
+  }
+  level->finalize();
+  return level;
+}
+
+inline std::unique_ptr<Level> create_room(const int width, const int height, const geometry::Position& player_spawn)
+{
+  return create_room(width, height, player_spawn, []([[maybe_unused]] const int x, [[maybe_unused]] const int y) { return false; });
+}
+
+// Creates a closed room with a floor halfway up, two hoppers and a slime which all move randomly, and two ammo items
+// that keep the player of run shooting for about 600 ticks. Tests add the other entities they need.
+inline std::unique_ptr<Level> create_test_level(const uint64_t seed = 1u)
+{
+  auto level = create_room(30, 12, geometry::Position(2 * 16, 10 * 16), [](const int x, const int y) { return y == 6 && x > 4 && x < 25; });
+  level->random.seed(seed);
+  for (const auto x : {8, 12})
+  {
+    level->items[x + (10 * level->width)] = Item(Sprite::SPRITE_PISTOL, ItemType::ITEM_TYPE_AMMO, AMMO_AMOUNT);
+  }
+  level->add_enemy<Hopper>(geometry::Position(10 * 16, 10 * 16));
+  level->add_enemy<Hopper>(geometry::Position(22 * 16, 10 * 16));
+  level->add_enemy<Slime>(geometry::Position(15 * 16, 3 * 16));
+  return level;
+}
+
+// Walks back and forth, jumping every now and then, and shooting too if shoot is set
+// The game only shoots while shoot is held, so it is held for a few ticks every 40 ticks.
+inline PlayerInput walk_back_and_forth(const unsigned tick, const bool shoot = false)
+{
+  PlayerInput input;
+  input.right = (tick / 60u) % 2u == 0u;
+  input.left = !input.right;
+  input.jump = tick % 25u == 0u;
+  input.shoot = shoot && tick % 40u < 3u;
+  input.shoot_pressed = shoot && tick % 40u == 0u;
+  return input;
+}
+
+// Returns the state of the player and all objects
+inline std::vector<int> get_state(const Game& game)
+{
+  const auto& player = game.get_player();
+  std::vector<int> state = {player.position.x(), player.position.y(), static_cast<int>(game.get_score())};
+  for (const auto& object : game.get_objects())
+  {
+    state.insert(state.end(), {object.position.x(), object.position.y(), object.sprite_id});
+  }
+  return state;
+}
+
+// Plays num_ticks ticks walking back and forth, and returns the states after each tick one after another
+inline std::vector<int> run(Game& game, const unsigned first_tick, const unsigned num_ticks, const bool shoot = false)
+{
+  std::vector<int> trace;
+  for (unsigned tick = first_tick; tick < first_tick + num_ticks; tick++)
+  {
+    game.update(tick, walk_back_and_forth(tick, shoot));
+    const auto state = get_state(game);
+    trace.insert(trace.end(), state.begin(), state.end());
+  }
+  return trace;
+}
@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+
+#include "tile_masks.h"
+
+namespace
+{
+// Creates a level of the given size with the given flags set on tile x, y
+std::vector<Tile> create_tiles(const int width, const int height, const int x, const int y, const int flags)
+{
+  std::vector<Tile> tiles(width * height, Tile(0, 1, 0));
+  tiles[(y * width) + x] = Tile(0, 1, flags);
+  return tiles;
+}
+}
+
+TEST(TileMasks, Any)
+{
+  TileMasks masks;
+  masks.build(create_tiles(40, 24, 10, 5, TILE_SOLID | TILE_DAMAGE), 40, 24);
+
+  EXPECT_TRUE(masks.any(10, 5, 10, 5, TILE_SOLID));
+  EXPECT_TRUE(masks.any(10, 5, 10, 5, TILE_DAMAGE));
+  EXPECT_TRUE(masks.any(10, 5, 10, 5, TILE_DEATH | TILE_DAMAGE));
+  EXPECT_FALSE(masks.any(10, 5, 10, 5, TILE_SOLID_TOP | TILE_DEATH | TILE_BLOCKS_SLIME));
+
+  // Neighbouring tiles
+  EXPECT_FALSE(masks.any(9, 5, 9, 5, TILE_SOLID));
+  EXPECT_FALSE(masks.any(11, 5, 11, 5, TILE_SOLID));
+  EXPECT_FALSE(masks.any(10, 4, 10, 4, TILE_SOLID));
+  EXPECT_FALSE(masks.any(10, 6, 10, 6, TILE_SOLID));
+
+  // Large ranges
+  EXPECT_TRUE(masks.any(0, 0, 39, 23, TILE_SOLID));
+  EXPECT_TRUE(masks.any(3, 5, 20, 5, TILE_SOLID));
+  EXPECT_FALSE(masks.any(0, 0, 39, 4, TILE_SOLID));
+  EXPECT_FALSE(masks.any(11, 0, 39, 23, TILE_SOLID));
+}
+
+TEST(TileMasks, WideLevel)
+{
+  // Tiles in later words of a row
+  TileMasks masks;
+  masks.build(create_tiles(200, 3, 130, 1, TILE_BLOCKS_SLIME), 200, 3);
+
+  EXPECT_TRUE(masks.any(0, 0, 199, 2, TILE_BLOCKS_SLIME));
+  EXPECT_TRUE(masks.any(63, 1, 130, 1, TILE_BLOCKS_SLIME));
+  EXPECT_TRUE(masks.any(130, 0, 191, 1, TILE_BLOCKS_SLIME));
+  EXPECT_FALSE(masks.any(0, 0, 129, 2, TILE_BLOCKS_SLIME));
+  EXPECT_FALSE(masks.any(131, 0, 199, 2, TILE_BLOCKS_SLIME));
+  EXPECT_FALSE(masks.any(130, 2, 130, 2, TILE_BLOCKS_SLIME));
+}
+
+TEST(TileMasks, OutsideLevel)
+{
+  TileMasks masks;
+  masks.build(create_tiles(4, 4, 0, 0, TILE_SOLID), 4, 4);
+
+  // Ranges are clipped to the level
+  EXPECT_TRUE(masks.any(-5, -5, 0, 0, TILE_SOLID));
+  EXPECT_FALSE(masks.any(-5, -5, -1, -1, TILE_SOLID));
+  EXPECT_FALSE(masks.any(4, 0, 10, 3, TILE_SOLID));
+}
@@ -0,0 +1,650 @@
+/*
+Run the game simulation headless (no window, renderer or SDL) with scripted input
+and report how fast each level can be simulated
+
+Usage: game_runner [episode] [ticks] [activity radius]
+       game_runner stress [entities] [ticks] [activity radius]
+       game_runner levels [episode] [iterations]
+       game_runner snapshots [episode] [iterations]
+       game_runner rewind [episode] [ticks]
+       game_runner record <demo file> [episode] [ticks]
+       game_runner replay <demo file> [episode] [iterations]
+
+The levels mode compares loading each level from the EXE data with cloning its prototype from the level cache,
+which is what restarting a level costs. The snapshots mode measures Game::snapshot and Game::restore of each level
+after it has been played for a while. The rewind mode plays each level while capturing every tick in a rewind
+buffer as the game does, compares the capture cost with the update cost, and then steps all the way back.
+
+The record mode plays every level with the scripted input and saves it as a demo, and the replay mode plays a
+demo (e.g. one recorded with occ --record-demo) as fast as possible. The replay mode prints a checksum of the
+final game state, which changes if the simulation of the demo changes.
+*/
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "activity_area.h"
+#include "allocation_counter.h"
+#include "demo.h"
+#include "exe_data.h"
+#include "game.h"
+#include "level.h"
+#include "level_id.h"
+#include "level_loader.h"
+#include "logger.h"
+#include "misc.h"
+#include "player_input.h"
+#include "rewind.h"
+#include "snapshot.h"
+
+namespace
+{
+constexpr unsigned DEFAULT_NUM_TICKS = 10000u;
+constexpr unsigned DEFAULT_NUM_STRESS_ENTITIES = 5000u;
+constexpr unsigned DEFAULT_NUM_LEVEL_ITERATIONS = 100u;
+constexpr unsigned DEFAULT_NUM_SNAPSHOT_ITERATIONS = 1000u;
+constexpr unsigned DEFAULT_NUM_DEMO_TICKS = 1000u;
+constexpr unsigned DEFAULT_NUM_REPLAY_ITERATIONS = 10u;
+
+struct ScriptStep
+{
+  unsigned num_ticks;
+  bool left;
+  bool right;
+  bool jump;
+  bool shoot;
+};
+
+// The player walks back and forth, jumping and shooting along the way
+constexpr ScriptStep script[] = {
+  {40u, false, true, false, false},
+  {16u, false, true, true, false},
+  {4u, false, false, false, true},
+  {30u, false, true, false, false},
+  {10u, false, false, false, false},
+  {40u, true, false, false, false},
+  {16u, true, false, true, false},
+  {4u, false, false, false, true},
+  {30u, true, false, false, false},
+  {16u, false, false, true, false},
+};
+
+PlayerInput scripted_input(unsigned tick)
+{
+  unsigned script_length = 0u;
+  for (const auto& step : script)
+  {
+    script_length += step.num_ticks;
+  }
+
+  tick %= script_length;
+  for (const auto& step : script)
+  {
+    if (tick < step.num_ticks)
+    {
+      PlayerInput input;
+      input.left = step.left;
+      input.right = step.right;
+      input.jump = step.jump;
+      input.shoot = step.shoot;
+      input.left_pressed = step.left && tick == 0u;
+      input.right_pressed = step.right && tick == 0u;
+      input.jump_pressed = step.jump && tick == 0u;
+      input.shoot_pressed = step.shoot && tick == 0u;
+      return input;
+    }
+    tick -= step.num_ticks;
+  }
+  return PlayerInput();
+}
+
+struct Result
+{
+  double mean_us;
+  double p99_us;
+  double ticks_per_second;
+  double allocations_per_tick;
+  double simulated_per_tick;
+};
+
+// Creates a large level divided into rooms, filled with num_entities enemies and hazards of all types
+std::unique_ptr<Level> create_stress_level(const unsigned num_entities)
+{
+  constexpr int width = 256;
+  constexpr int height = 64;
+  constexpr int room_width = 16;
+  constexpr int room_height = 8;
+
+  auto level = std::make_unique<Level>();
+  level->level_id = LevelId::LEVEL_1;
+  level->width = width;
+  level->height = height;
+  level->player_spawn = geometry::Position(2 * 16, (room_height - 2) * 16);
+  for (int y = 0; y < height; y++)
+  {
+    for (int x = 0; x < width; x++)
+    {
+      const auto solid = x % room_width == 0 || x == width - 1 || y % room_height == 0 || y == height - 1;
+      level->tiles.emplace_back(0, 1, solid ? TILE_SOLID : 0);
+      level->bgs.push_back(-1);
+      level->items.emplace_back();
+    }
+  }
+  level->finalize();
+
+  // Spread the entities over all rooms using a simple LCG so that the level is always the same
+  unsigned lcg = 1u;
+  for (unsigned i = 0u; i < num_entities; i++)
+  {
+    lcg = (lcg * 1103515245u) + 12345u;
+    const int room_x = static_cast<int>((lcg >> 8) % (width / room_width));
+    const int room_y = 1 + static_cast<int>((lcg >> 16) % ((height - 1) / room_height));
+    const int x = (room_x * room_width) + 2 + static_cast<int>((lcg >> 24) % (room_width - 4));
+    const auto on_floor = geometry::Position(x * 16, ((room_y * room_height) - 1) * 16);
+    const auto in_air = on_floor - geometry::Position(0, 3 * 16);
+    switch (i % 8)
+    {
+      case 0:
+        level->add_enemy<Hopper>(on_floor);
+        break;
+      case 1:
+        level->add_enemy<Snake>(on_floor);
+        break;
+      case 2:
+        level->add_enemy<Bigfoot>(on_floor);
+        break;
+      case 3:
+        level->add_enemy<Slime>(in_air);
+        break;
+      case 4:
+        level->add_enemy<Spider>(in_air);
+        break;
+      case 5:
+        level->add_hazard<Thorn>(on_floor);
+        break;
+      case 6:
+        level->add_hazard<Laser>(in_air, (i / 8) % 2 == 0);
+        break;
+      default:
+        level->add_hazard<AirTank>(on_floor, false);
+        break;
+    }
+  }
+  return level;
+}
+
+bool run_game(Game& game, const unsigned num_ticks, const int activity_radius, Result* result)
+{
+  // Simulate the same entities as the game would, with the camera following the player
+  game.set_activity_area(CAMERA_SIZE, activity_radius);
+
+  std::vector<double> durations_us;
+  durations_us.reserve(num_ticks);
+
+  unsigned long long total_simulated = 0u;
+  const auto allocations_before = get_num_allocations();
+  for (unsigned tick = 0u; tick < num_ticks; tick++)
+  {
+    const auto input = scripted_input(tick);
+    const auto start = std::chrono::steady_clock::now();
+    game.update(tick, input);
+    const auto end = std::chrono::steady_clock::now();
+    durations_us.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+    total_simulated += game.get_num_simulated();
+  }
+  const auto allocations = get_num_allocations() - allocations_before;
+
+  double total_us = 0.0;
+  for (const auto duration : durations_us)
+  {
+    total_us += duration;
+  }
+  std::sort(durations_us.begin(), durations_us.end());
+
+  result->mean_us = total_us / num_ticks;
+  result->p99_us = durations_us[(durations_us.size() - 1u) * 99u / 100u];
+  result->ticks_per_second = total_us > 0.0 ? num_ticks / (total_us / 1000000.0) : 0.0;
+  result->allocations_per_tick = static_cast<double>(allocations) / num_ticks;
+  result->simulated_per_tick = static_cast<double>(total_simulated) / num_ticks;
+  return true;
+}
+
+bool run_level(const ExeData& exe_data, const LevelId level_id, const unsigned num_ticks, const int activity_radius, Result* result)
+{
+  // Same seed every run so that runs are repeatable
+  auto game = Game::create(0u);
+  if (!game || !game->init(exe_data, level_id))
+  {
+    return false;
+  }
+  return run_game(*game, num_ticks, activity_radius, result);
+}
+
+bool run_stress(const unsigned num_entities, const unsigned num_ticks, const int activity_radius, Result* result)
+{
+  auto game = Game::create(0u);
+  if (!game || !game->init(create_stress_level(num_entities)))
+  {
+    return false;
+  }
+  return run_game(*game, num_ticks, activity_radius, result);
+}
+
+// Returns the average time in microseconds of f, and its average number of allocations in allocations
+template <typename F>
+double measure_us(const unsigned num_iterations, F f, double* allocations)
+{
+  const auto allocations_before = get_num_allocations();
+  const auto start = std::chrono::steady_clock::now();
+  for (unsigned i = 0u; i < num_iterations; i++)
+  {
+    f();
+  }
+  const auto end = std::chrono::steady_clock::now();
+  *allocations = static_cast<double>(get_num_allocations() - allocations_before) / num_iterations;
+  return std::chrono::duration<double, std::micro>(end - start).count() / num_iterations;
+}
+
+bool run_levels(const int episode, const unsigned num_iterations)
+{
+  ExeData exe_data{episode};
+
+  printf("%-8s %12s %12s %12s %12s %10s\n", "level", "load (us)", "allocs", "clone (us)", "allocs", "speedup");
+  double total_load_us = 0.0;
+  double total_clone_us = 0.0;
+  for (int level_id = static_cast<int>(LevelId::INTRO); level_id <= static_cast<int>(LevelId::LEVEL_16); level_id++)
+  {
+    const auto prototype = LevelLoader::load(exe_data, static_cast<LevelId>(level_id), 0u);
+    if (!prototype)
+    {
+      LOG_CRITICAL("Could not load level %d", level_id);
+      return false;
+    }
+    double load_allocations;
+    double clone_allocations;
+    const auto load_us =
+      measure_us(num_iterations, [&exe_data, level_id]() { LevelLoader::load(exe_data, static_cast<LevelId>(level_id), 0u); }, &load_allocations);
+    const auto clone_us = measure_us(num_iterations, [&prototype]() { prototype->clone(); }, &clone_allocations);
+    printf("%-8d %12.2f %12.0f %12.2f %12.0f %9.1fx\n", level_id, load_us, load_allocations, clone_us, clone_allocations, load_us / clone_us);
+    total_load_us += load_us;
+    total_clone_us += clone_us;
+  }
+  printf("%-8s %12.2f %12s %12.2f %12s %9.1fx\n", "total", total_load_us, "", total_clone_us, "", total_load_us / total_clone_us);
+  return true;
+}
+
+bool run_snapshots(const int episode, const unsigned num_iterations)
+{
+  ExeData exe_data{episode};
+
+  printf("%-8s %10s %14s %12s %14s %12s\n", "level", "bytes", "snapshot (us)", "allocs", "restore (us)", "allocs");
+  Snapshot snapshot;
+  for (int level_id = static_cast<int>(LevelId::INTRO); level_id <= static_cast<int>(LevelId::LEVEL_16); level_id++)
+  {
+    auto game = Game::create(0u);
+    if (!game || !game->init(exe_data, static_cast<LevelId>(level_id)))
+    {
+      LOG_CRITICAL("Could not load level %d", level_id);
+      return false;
+    }
+    // Play a while so that there are moved enemies, picked up items and spawned hazards
+    game->set_activity_area(CAMERA_SIZE, ACTIVITY_RADIUS);
+    for (unsigned tick = 0u; tick < 500u; tick++)
+    {
+      game->update(tick, scripted_input(tick));
+    }
+
+    double snapshot_allocations;
+    double restore_allocations;
+    const auto snapshot_us = measure_us(num_iterations, [&game, &snapshot]() { game->snapshot(snapshot); }, &snapshot_allocations);
+    const auto restore_us = measure_us(num_iterations, [&game, &snapshot]() { game->restore(snapshot); }, &restore_allocations);
+    printf("%-8d %10zu %14.2f %12.2f %14.2f %12.2f\n",
+           level_id,
+           snapshot.size(),
+           snapshot_us,
+           snapshot_allocations,
+           restore_us,
+           restore_allocations);
+  }
+  return true;
+}
+
+bool run_rewind(const int episode, const unsigned num_ticks)
+{
+  ExeData exe_data{episode};
+
+  printf("%-8s %10s %12s %12s %8s %10s %12s %12s %12s\n",
+         "level",
+         "held",
+         "update (us)",
+         "capture (us)",
+         "ratio",
+         "KiB",
+         "KiB/s",
+         "back (us)",
+         "max back (us)");
+  Rewind rewind(REWIND_BUFFER_SIZE, REWIND_TICKS, REWIND_KEYFRAME_INTERVAL);
+  for (int level_id = static_cast<int>(LevelId::INTRO); level_id <= static_cast<int>(LevelId::LEVEL_16); level_id++)
+  {
+    auto game = Game::create(0u);
+    if (!game || !game->init(exe_data, static_cast<LevelId>(level_id)))
+    {
+      LOG_CRITICAL("Could not load level %d", level_id);
+      return false;
+    }
+    game->set_activity_area(CAMERA_SIZE, ACTIVITY_RADIUS);
+    rewind.clear();
+
+    double update_us = 0.0;
+    double capture_us = 0.0;
+    for (unsigned tick = 0u; tick < num_ticks; tick++)
+    {
+      const auto input = scripted_input(tick);
+      const auto start = std::chrono::steady_clock::now();
+      game->update(tick, input);
+      const auto updated = std::chrono::steady_clock::now();
+      rewind.capture(*game);
+      const auto end = std::chrono::steady_clock::now();
+      update_us += std::chrono::duration<double, std::micro>(updated - start).count();
+      capture_us += std::chrono::duration<double, std::micro>(end - updated).count();
+    }
+
+    // Memory per second of history, at the speed the game runs at
+    const auto num_held = rewind.get_num_ticks();
+    const auto bytes_per_second = static_cast<double>(rewind.get_bytes_used()) / num_held * 1000.0 / MS_PER_UPDATE;
+    const auto bytes_used = rewind.get_bytes_used();
+
+    double total_back_us = 0.0;
+    double max_back_us = 0.0;
+    unsigned num_back = 0u;
+    while (true)
+    {
+      const auto start = std::chrono::steady_clock::now();
+      if (!rewind.step_back(*game))
+      {
+        break;
+      }
+      const auto back_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+      total_back_us += back_us;
+      max_back_us = std::max(max_back_us, back_us);
+      num_back++;
+    }
+
+    printf("%-8d %10zu %12.2f %12.2f %8.2f %10.1f %12.1f %12.2f %12.2f\n",
+           level_id,
+           num_held,
+           update_us / num_ticks,
+           capture_us / num_ticks,
+           capture_us / update_us,
+           bytes_used / 1024.0,
+           bytes_per_second / 1024.0,
+           num_back > 0u ? total_back_us / num_back : 0.0,
+           max_back_us);
+  }
+  return true;
+}
+
+bool record_demo(const char* path, const int episode, const unsigned num_ticks)
+{
+  ExeData exe_data{episode};
+
+  // Same seed and activity area as run_level
+  auto game = Game::create(0u);
+  Demo demo{game->get_seed(), CAMERA_SIZE, ACTIVITY_RADIUS};
+  game->set_activity_area(CAMERA_SIZE, ACTIVITY_RADIUS);
+  unsigned game_tick = 0u;
+  for (int level_id = static_cast<int>(LevelId::INTRO); level_id <= static_cast<int>(LevelId::LEVEL_16); level_id++)
+  {
+    if (!game->init(exe_data, static_cast<LevelId>(level_id)))
+    {
+      LOG_CRITICAL("Could not load level %d", level_id);
+      return false;
+    }
+    demo.start_level(static_cast<LevelId>(level_id), game_tick);
+    for (unsigned tick = 0u; tick < num_ticks; tick++, game_tick++)
+    {
+      const auto input = scripted_input(tick);
+      demo.add(input);
+      game->update(game_tick, input);
+    }
+  }
+  if (!demo.save(path))
+  {
+    return false;
+  }
+
+  std::size_t num_runs = 0u;
+  for (const auto& segment : demo.get_segments())
+  {
+    num_runs += segment.runs.size();
+  }
+  printf("recorded %u ticks in %zu segments as %zu runs to '%s'\n", demo.get_num_ticks(), demo.get_segments().size(), num_runs, path);
+  return true;
+}
+
+// Hashes the player and all objects, so that replays of a demo can be compared
+uint64_t get_checksum(const Game& game)
+{
+  const auto& player = game.get_player();
+  std::vector<int> state = {player.position.x(),
+                            player.position.y(),
+                            static_cast<int>(game.get_score()),
+                            static_cast<int>(game.get_num_ammo()),
+                            static_cast<int>(game.get_num_lives())};
+  for (const auto& object : game.get_objects())
+  {
+    state.insert(state.end(), {object.position.x(), object.position.y(), object.sprite_id});
+  }
+  return misc::hash_fnv1a(reinterpret_cast<const char*>(state.data()), state.size() * sizeof(int));
+}
+
+bool replay_demo(const char* path, const int episode, const unsigned num_iterations)
+{
+  const auto demo = Demo::load(path);
+  if (!demo)
+  {
+    return false;
+  }
+  ExeData exe_data{episode};
+
+  // Every replay must end in the same state
+  uint64_t checksum = 0u;
+  std::vector<double> durations_us;
+  const auto allocations_before = get_num_allocations();
+  for (unsigned i = 0u; i < num_iterations; i++)
+  {
+    auto game = Game::create(demo->get_seed());
+    const auto start = std::chrono::steady_clock::now();
+    if (!demo->replay(*game, exe_data))
+    {
+      return false;
+    }
+    const auto end = std::chrono::steady_clock::now();
+    durations_us.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+
+    const auto game_checksum = get_checksum(*game);
+    if (i > 0u && game_checksum != checksum)
+    {
+      LOG_CRITICAL("Replay %u ended in another state than the first replay", i);
+      return false;
+    }
+    checksum = game_checksum;
+  }
+  const auto allocations = get_num_allocations() - allocations_before;
+
+  const auto num_ticks = demo->get_num_ticks();
+  const auto total_ticks = static_cast<double>(num_ticks) * num_iterations;
+  std::sort(durations_us.begin(), durations_us.end());
+  double total_us = 0.0;
+  for (const auto duration : durations_us)
+  {
+    total_us += duration;
+  }
+  printf("%-10s %10s %10s %12s %12s %12s %16s\n", "segments", "ticks", "replays", "ticks/s", "median (ms)", "allocs/tick", "checksum");
+  printf("%-10zu %10u %10u %12.0f %12.2f %12.2f %016llx\n",
+         demo->get_segments().size(),
+         num_ticks,
+         num_iterations,
+         total_us > 0.0 ? total_ticks / (total_us / 1000000.0) : 0.0,
+         durations_us[durations_us.size() / 2u] / 1000.0,
+         total_ticks > 0.0 ? static_cast<double>(allocations) / total_ticks : 0.0,
+         static_cast<unsigned long long>(checksum));
+  return true;
+}
+
+void print_header()
+{
+  printf("%-8s %10s %12s %10s %10s %12s %10s\n", "level", "ticks", "ticks/s", "mean (us)", "p99 (us)", "allocs/tick", "sim/tick");
+}
+
+void print_result(const char* name, const unsigned num_ticks, const Result& result)
+{
+  printf("%-8s %10u %12.0f %10.2f %10.2f %12.2f %10.1f\n",
+         name,
+         num_ticks,
+         result.ticks_per_second,
+         result.mean_us,
+         result.p99_us,
+         result.allocations_per_tick,
+         result.simulated_per_tick);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+  // Stress mode: a generated level with lots of entities, does not need any game data
+  if (argc > 1 && strcmp(argv[1], "stress") == 0)
+  {
+    const unsigned num_entities = argc > 2 ? static_cast<unsigned>(atoi(argv[2])) : DEFAULT_NUM_STRESS_ENTITIES;
+    const unsigned num_ticks = argc > 3 ? static_cast<unsigned>(atoi(argv[3])) : DEFAULT_NUM_TICKS;
+    const int activity_radius = argc > 4 ? atoi(argv[4]) : ACTIVITY_RADIUS;
+    if (num_ticks == 0u)
+    {
+      LOG_CRITICAL("Number of ticks must be greater than zero");
+      return 1;
+    }
+    Result result;
+    if (!run_stress(num_entities, num_ticks, activity_radius, &result))
+    {
+      LOG_CRITICAL("Could not run stress level");
+      return 1;
+    }
+    print_header();
+    print_result("stress", num_ticks, result);
+    return 0;
+  }
+
+  // Levels mode: compare loading levels with cloning them from the level cache
+  if (argc > 1 && strcmp(argv[1], "levels") == 0)
+  {
+    const int episode = argc > 2 ? atoi(argv[2]) : 1;
+    const unsigned num_iterations = argc > 3 ? static_cast<unsigned>(atoi(argv[3])) : DEFAULT_NUM_LEVEL_ITERATIONS;
+    if (num_iterations == 0u)
+    {
+      LOG_CRITICAL("Number of iterations must be greater than zero");
+      return 1;
+    }
+    return run_levels(episode, num_iterations) ? 0 : 1;
+  }
+
+  // Snapshots mode: cost of taking and restoring a snapshot of each level
+  if (argc > 1 && strcmp(argv[1], "snapshots") == 0)
+  {
+    const int episode = argc > 2 ? atoi(argv[2]) : 1;
+    const unsigned num_iterations = argc > 3 ? static_cast<unsigned>(atoi(argv[3])) : DEFAULT_NUM_SNAPSHOT_ITERATIONS;
+    if (num_iterations == 0u)
+    {
+      LOG_CRITICAL("Number of iterations must be greater than zero");
+      return 1;
+    }
+    return run_snapshots(episode, num_iterations) ? 0 : 1;
+  }
+
+  // Rewind mode: cost and memory use of keeping a rewind history
+  if (argc > 1 && strcmp(argv[1], "rewind") == 0)
+  {
+    const int episode = argc > 2 ? atoi(argv[2]) : 1;
+    const unsigned num_ticks = argc > 3 ? static_cast<unsigned>(atoi(argv[3])) : DEFAULT_NUM_TICKS;
+    if (num_ticks == 0u)
+    {
+      LOG_CRITICAL("Number of ticks must be greater than zero");
+      return 1;
+    }
+    return run_rewind(episode, num_ticks) ? 0 : 1;
+  }
+
+  // Demo modes: record the scripted input of all levels, or replay a recorded demo as fast as possible
+  if (argc > 1 && (strcmp(argv[1], "record") == 0 || strcmp(argv[1], "replay") == 0))
+  {
+    if (argc < 3)
+    {
+      LOG_CRITICAL("Missing demo file");
+      return 1;
+    }
+    const int episode = argc > 3 ? atoi(argv[3]) : 1;
+    if (strcmp(argv[1], "record") == 0)
+    {
+      const unsigned num_ticks = argc > 4 ? static_cast<unsigned>(atoi(argv[4])) : DEFAULT_NUM_DEMO_TICKS;
+      return record_demo(argv[2], episode, num_ticks) ? 0 : 1;
+    }
+    const unsigned num_iterations = argc > 4 ? static_cast<unsigned>(atoi(argv[4])) : DEFAULT_NUM_REPLAY_ITERATIONS;
+    if (num_iterations == 0u)
+    {
+      LOG_CRITICAL("Number of iterations must be greater than zero");
+      return 1;
+    }
+    return replay_demo(argv[2], episode, num_iterations) ? 0 : 1;
+  }
+
+  int episode = 1;
+  if (argc > 1)
+  {
+    episode = atoi(argv[1]);
+  }
+  unsigned num_ticks = DEFAULT_NUM_TICKS;
+  if (argc > 2)
+  {
+    num_ticks = static_cast<unsigned>(atoi(argv[2]));
+  }
+  if (num_ticks == 0u)
+  {
+    LOG_CRITICAL("Number of ticks must be greater than zero");
+    return 1;
+  }
+  // A negative activity radius simulates all entities in the level
+  int activity_radius = ACTIVITY_RADIUS;
+  if (argc > 3)
+  {
+    activity_radius = atoi(argv[3]);
+  }
+
+  ExeData exe_data{episode};
+
+  std::vector<Result> results;
+  print_header();
+  for (int level_id = static_cast<int>(LevelId::INTRO); level_id <= static_cast<int>(LevelId::LEVEL_16); level_id++)
+  {
+    Result result;
+    if (!run_level(exe_data, static_cast<LevelId>(level_id), num_ticks, activity_radius, &result))
+    {
+      LOG_CRITICAL("Could not run level %d", level_id);
+      return 1;
+    }
+    print_result(std::to_string(level_id).c_str(), num_ticks, result);
+    results.push_back(result);
+  }
+
+  double total_ticks_per_second = 0.0;
+  for (const auto& result : results)
+  {
+    total_ticks_per_second += result.ticks_per_second;
+  }
+  printf("mean ticks/s over %zu levels: %.0f\n", results.size(), total_ticks_per_second / results.size());
+
+  return 0;
+}
@@ -5,13 +5,13 @@ Display Crystal Caves levels
 #include <fstream>
 #include <iostream>
 
-#include "../game/src/level.h"
-#include "../game/src/level_loader.h"
 #include "../occ/src/constants.h"
 #include "../occ/src/spritemgr.h"
 #include "../utils/export/exe_data.h"
 #include "event.h"
 #include "graphics.h"
+#include "level.h"
+#include "level_loader.h"
 #include "logger.h"
 #include "sdl_wrapper.h"
 
@@ -51,7 +51,7 @@ int main(int argc, char* argv[])
   std::vector<std::unique_ptr<Level>> levels;
   for (int level_id = static_cast<int>(LevelId::INTRO); level_id <= static_cast<int>(LevelId::LEVEL_16); level_id++)
   {
-    auto l = LevelLoader::load(exe_data, static_cast<LevelId>(level_id));
+    auto l = LevelLoader::load(exe_data, static_cast<LevelId>(level_id), 0u);
     levels.emplace_back(std::move(l));
   }
   int index = 0;
@@ -63,6 +63,7 @@ int main(int argc, char* argv[])
   }
 
   Input input;
+  std::vector<Object> objects;
   while (true)
   {
     event->poll_event(&input);
@@ -102,26 +103,19 @@ int main(int argc, char* argv[])
         const auto tile = level->get_tile(x, y);
         const auto sprite_id = tile.get_sprite();
         sprite_manager.render_tile(sprite_id, {x * SPRITE_W, y * SPRITE_H});
-        for (const auto& enemy : level->enemies)
-        {
-          for (const auto& sprite_pos : enemy->get_sprites(*level))
-          {
-            sprite_manager.render_tile(static_cast<int>(sprite_pos.second), sprite_pos.first);
-          }
-        }
-        for (const auto& hazard : level->hazards)
+        objects.clear();
+        SpriteSink sink(objects);
+        const auto add_sprites = [&sink, &level](const auto& a) { a.get_sprites(*level, sink); };
+        level->enemies.for_each(add_sprites);
+        level->hazards.for_each(add_sprites);
+        level->actors.for_each(add_sprites);
+        if (level->exit)
         {
-          for (const auto& sprite_pos : hazard->get_sprites(*level))
-          {
-            sprite_manager.render_tile(static_cast<int>(sprite_pos.second), sprite_pos.first);
-          }
+          level->exit->get_sprites(sink);
         }
-        for (const auto& a : level->actors)
+        for (const auto& object : objects)
         {
-          for (const auto& sprite_pos : a->get_sprites(*level))
-          {
-            sprite_manager.render_tile(static_cast<int>(sprite_pos.second), sprite_pos.first);
-          }
+          sprite_manager.render_tile(object.sprite_id, object.position);
         }
         for (const auto& platform : level->moving_platforms)
         {
@@ -131,13 +125,6 @@ int main(int argc, char* argv[])
         {
           sprite_manager.render_tile(entrance.get_sprite(), entrance.position);
         }
-        if (level->exit)
-        {
-          for (const auto& sprite_pos : level->exit->get_sprites())
-          {
-            sprite_manager.render_tile(static_cast<int>(sprite_pos.second), sprite_pos.first);
-          }
-        }
         sprite_manager.render_tile(static_cast<int>(Sprite::SPRITE_STANDING_RIGHT), level->player_spawn);
         const auto& item = level->get_item(x, y);
         if (item.valid())
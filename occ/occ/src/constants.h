@@ -1,12 +1,20 @@
 #ifndef CONSTANTS_H_
 #define CONSTANTS_H_
 
+#include <cstddef>
+#include <cstdint>
+
+#include "activity_area.h"
 #include "geometry.h"
 
 static constexpr geometry::Size SCREEN_SIZE = geometry::Size(320, 200);
 
-// The size of the game camera
-static constexpr geometry::Size CAMERA_SIZE = geometry::Size(320, 192);
+// Levels behind entrances and exits closer than this (in tiles) to the player are prepared in the background
+static constexpr int LEVEL_PREFETCH_DISTANCE = 4;
+
+// Surfaces of the title and credits images, which are shown together, fit in this budget (in bytes).
+// The least recently shown images are freed when more images than this are loaded.
+static constexpr std::size_t IMAGE_SURFACE_BUDGET = 2 * SCREEN_SIZE.x() * SCREEN_SIZE.y() * sizeof(uint32_t);
 
 // The size of the game camera after stretching, which is done in the original Crystal Caves
 static constexpr geometry::Size CAMERA_SIZE_STRETCHED = geometry::Size(CAMERA_SIZE.x(), CAMERA_SIZE.y() * 6 / 5);
@@ -1,9 +1,12 @@
 #include "game_renderer.h"
 
+#include <algorithm>
+
 #include "constants.h"
 #include "game.h"
 #include "graphics.h"
 #include "level.h"
+#include "logger.h"
 #include "misc.h"
 #include "occ_math.h"
 #include "player.h"
@@ -24,10 +27,22 @@ GameRenderer::GameRenderer(Game* game, SpriteManager* sprite_manager, Surface* g
                  CAMERA_SIZE.y()),
     game_tick_(0u),
     game_tick_diff_(0u),
-    debug_(false)
+    debug_(false),
+    chunks_(),
+    num_draw_calls_(0u),
+    draw_call_stats_()
 {
 }
 
+void GameRenderer::reset()
+{
+  for (auto& chunks : chunks_)
+  {
+    chunks.clear();
+  }
+  draw_call_stats_ = DrawCallStats();
+}
+
 void GameRenderer::update(unsigned game_tick)
 {
   game_tick_diff_ = game_tick - game_tick_;
@@ -69,6 +84,7 @@ void GameRenderer::update(unsigned game_tick)
 
 void GameRenderer::render_game() const
 {
+  const auto num_draw_calls_start = window_.get_num_draw_calls();
   window_.set_render_target(game_surface_);
   // Clear game surface (background now)
   window_.fill_rect(geometry::Rectangle(0, 0, CAMERA_SIZE), {33u, 33u, 33u});
@@ -80,30 +96,125 @@ void GameRenderer::render_game() const
   render_items();
   render_statusbar();
   window_.set_render_target(nullptr);
+  num_draw_calls_ = window_.get_num_draw_calls() - num_draw_calls_start;
+  draw_call_stats_.num_frames++;
+  draw_call_stats_.total += num_draw_calls_;
+  draw_call_stats_.max = std::max(draw_call_stats_.max, num_draw_calls_);
 }
 
-void GameRenderer::render_background() const
+int GameRenderer::get_static_sprite(const Layer layer, const int tile_x, const int tile_y) const
 {
-  // TODO: Create a surface of size CAMERA + (background.size() * 16) and render the background
-  //       to it _once_, then just keep render that surface (with game_camera offset) until the
-  //       level changes.
+  if (layer == Layer::BACKGROUND)
+  {
+    return game_->get_bg_sprite(tile_x, tile_y);
+  }
 
-  const auto start_tile_x = game_camera_.position.x() > 0 ? game_camera_.position.x() / 16 : 0;
-  const auto start_tile_y = game_camera_.position.y() > 0 ? game_camera_.position.y() / 16 : 0;
-  const auto end_tile_x = (game_camera_.position.x() + game_camera_.size.x()) / 16;
-  const auto end_tile_y = (game_camera_.position.y() + game_camera_.size.y()) / 16;
+  const auto& tile = game_->get_tile(tile_x, tile_y);
+  if (!tile.valid() || tile.is_animated() || tile.is_render_in_front() != (layer == Layer::TILES_IN_FRONT))
+  {
+    return -1;
+  }
+  return tile.get_sprite();
+}
 
-  for (int tile_y = start_tile_y; tile_y <= end_tile_y; tile_y++)
+void GameRenderer::render_static_tiles(const Layer layer, const int chunk_x, const int chunk_y, const geometry::Position& camera_position) const
+{
+  const auto end_tile_x = std::min((chunk_x + 1) * CHUNK_TILES, game_->get_tile_width());
+  const auto end_tile_y = std::min((chunk_y + 1) * CHUNK_TILES, game_->get_tile_height());
+  for (int tile_y = chunk_y * CHUNK_TILES; tile_y < end_tile_y; tile_y++)
   {
-    for (int tile_x = start_tile_x; tile_x <= end_tile_x; tile_x++)
+    for (int tile_x = chunk_x * CHUNK_TILES; tile_x < end_tile_x; tile_x++)
     {
-      const auto sprite_id = game_->get_bg_sprite(tile_x, tile_y);
+      const auto sprite_id = get_static_sprite(layer, tile_x, tile_y);
       if (sprite_id != -1)
       {
-        sprite_manager_->render_tile(sprite_id, {tile_x * SPRITE_W, tile_y * SPRITE_H}, game_camera_.position);
+        sprite_manager_->render_tile(sprite_id, {tile_x * SPRITE_W, tile_y * SPRITE_H}, camera_position);
+      }
+    }
+  }
+}
+
+void GameRenderer::render_chunk(const Layer layer, Chunk& chunk, const int chunk_x, const int chunk_y) const
+{
+  chunk.rendered = true;
+
+  const auto end_tile_x = std::min((chunk_x + 1) * CHUNK_TILES, game_->get_tile_width());
+  const auto end_tile_y = std::min((chunk_y + 1) * CHUNK_TILES, game_->get_tile_height());
+  for (int tile_y = chunk_y * CHUNK_TILES; tile_y < end_tile_y && chunk.empty; tile_y++)
+  {
+    for (int tile_x = chunk_x * CHUNK_TILES; tile_x < end_tile_x && chunk.empty; tile_x++)
+    {
+      chunk.empty = get_static_sprite(layer, tile_x, tile_y) == -1;
+    }
+  }
+  if (chunk.empty)
+  {
+    return;
+  }
+
+  constexpr auto chunk_size = geometry::Size(CHUNK_TILES * SPRITE_W, CHUNK_TILES * SPRITE_H);
+  chunk.surface = window_.create_target_surface(chunk_size);
+  if (!chunk.surface)
+  {
+    // render_layer falls back to rendering the tiles of this chunk directly
+    LOG_ERROR("Could not create surface for chunk (%d, %d)", chunk_x, chunk_y);
+    return;
+  }
+
+  window_.set_render_target(chunk.surface.get());
+  window_.fill_rect(geometry::Rectangle(0, 0, chunk_size), {0u, 0u, 0u, 0u});
+  render_static_tiles(layer, chunk_x, chunk_y, geometry::Position(chunk_x * chunk_size.x(), chunk_y * chunk_size.y()));
+  window_.set_render_target(game_surface_);
+}
+
+void GameRenderer::render_layer(const Layer layer) const
+{
+  constexpr auto chunk_size = geometry::Size(CHUNK_TILES * SPRITE_W, CHUNK_TILES * SPRITE_H);
+  const auto chunks_width = (game_->get_tile_width() + CHUNK_TILES - 1) / CHUNK_TILES;
+  const auto chunks_height = (game_->get_tile_height() + CHUNK_TILES - 1) / CHUNK_TILES;
+
+  auto& chunks = chunks_[static_cast<int>(layer)];
+  if (chunks.empty())
+  {
+    chunks.resize(chunks_width * chunks_height);
+  }
+
+  const auto start_chunk_x = std::max(game_camera_.position.x(), 0) / chunk_size.x();
+  const auto start_chunk_y = std::max(game_camera_.position.y(), 0) / chunk_size.y();
+  const auto end_chunk_x = std::min((game_camera_.position.x() + game_camera_.size.x() - 1) / chunk_size.x(), chunks_width - 1);
+  const auto end_chunk_y = std::min((game_camera_.position.y() + game_camera_.size.y() - 1) / chunk_size.y(), chunks_height - 1);
+
+  for (int chunk_y = start_chunk_y; chunk_y <= end_chunk_y; chunk_y++)
+  {
+    for (int chunk_x = start_chunk_x; chunk_x <= end_chunk_x; chunk_x++)
+    {
+      auto& chunk = chunks[(chunk_y * chunks_width) + chunk_x];
+      if (!chunk.rendered)
+      {
+        render_chunk(layer, chunk, chunk_x, chunk_y);
+      }
+      if (chunk.empty)
+      {
+        continue;
+      }
+
+      if (chunk.surface)
+      {
+        const auto chunk_position = geometry::Position(chunk_x * chunk_size.x(), chunk_y * chunk_size.y());
+        chunk.surface->blit_surface(geometry::Rectangle(0, 0, chunk_size),
+                                    geometry::Rectangle(chunk_position - game_camera_.position, chunk_size));
+      }
+      else
+      {
+        render_static_tiles(layer, chunk_x, chunk_y, game_camera_.position);
       }
     }
   }
+}
+
+void GameRenderer::render_background() const
+{
+  render_layer(Layer::BACKGROUND);
 
   if (game_->get_level().has_earth)
   {
@@ -168,6 +279,8 @@ void GameRenderer::render_background() const
     // Render volcano fire if active and visible
     if (volcano_active)
     {
+      const auto start_tile_x = game_camera_.position.x() > 0 ? game_camera_.position.x() / 16 : 0;
+      const auto end_tile_x = (game_camera_.position.x() + game_camera_.size.x()) / 16;
       if (start_tile_x <= 29 && end_tile_x >= 29)
       {
         const auto sprite_id = 752 + ((game_tick_ - volcano_tick_start) / 3) % 4;
@@ -289,6 +402,10 @@ void GameRenderer::render_player() const
 
 void GameRenderer::render_tiles(bool in_front) const
 {
+  render_layer(in_front ? Layer::TILES_IN_FRONT : Layer::TILES_BEHIND);
+
+  // Animated tiles are not part of the pre-rendered layers
+  sprite_manager_->begin_batch();
   const auto start_tile_x = game_camera_.position.x() > 0 ? game_camera_.position.x() / 16 : 0;
   const auto start_tile_y = game_camera_.position.y() > 0 ? game_camera_.position.y() / 16 : 0;
   const auto end_tile_x = (game_camera_.position.x() + game_camera_.size.x()) / 16;
@@ -307,7 +424,7 @@ void GameRenderer::render_tiles(bool in_front) const
         window_.render_rectangle(dest_rect, {0, 128, 0});
       }
 
-      if (!tile.valid())
+      if (!tile.valid() || !tile.is_animated())
       {
         continue;
       }
@@ -317,57 +434,48 @@ void GameRenderer::render_tiles(bool in_front) const
         continue;
       }
 
-      const auto sprite_id = [&tile](unsigned game_tick)
-      {
-        if (tile.is_animated())
-        {
-          return tile.get_sprite() + static_cast<int>((game_tick / 2) % tile.get_sprite_count());
-        }
-        else
-        {
-          return tile.get_sprite();
-        }
-      }(game_tick_);
+      const auto sprite_id = tile.get_sprite() + static_cast<int>((game_tick_ / 2) % tile.get_sprite_count());
       sprite_manager_->render_tile(sprite_id, {tile_x * SPRITE_W, tile_y * SPRITE_H}, game_camera_.position);
     }
   }
+  sprite_manager_->end_batch();
 }
 
 void GameRenderer::render_objects() const
 {
+  static constexpr geometry::Size object_size = geometry::Size(16, 16);
+  sprite_manager_->begin_batch();
   for (const auto& object : game_->get_objects())
   {
-    static constexpr geometry::Size object_size = geometry::Size(16, 16);
     if (geometry::isColliding(geometry::Rectangle(object.position, object_size), game_camera_))
     {
       const auto sprite_id = object.get_sprite(game_tick_);
       sprite_manager_->render_tile(sprite_id, object.position, game_camera_.position);
-
-      if (debug_)
-      {
-        const geometry::Rectangle dest_rect{object.position - game_camera_.position, object_size};
-        window_.render_rectangle(dest_rect, {255, 0, 0});
-      }
     }
   }
+  sprite_manager_->end_batch();
+
   if (debug_)
   {
-    for (const auto& hazard : game_->get_level().hazards)
+    for (const auto& object : game_->get_objects())
     {
-      for (const auto r : hazard->get_detection_rects(game_->get_level()))
+      if (geometry::isColliding(geometry::Rectangle(object.position, object_size), game_camera_))
       {
-        const geometry::Rectangle dest_rect{r.position - game_camera_.position, r.size};
-        window_.render_rectangle(dest_rect, {255, 255, 0});
+        const geometry::Rectangle dest_rect{object.position - game_camera_.position, object_size};
+        window_.render_rectangle(dest_rect, {255, 0, 0});
       }
     }
-    for (const auto& enemy : game_->get_level().enemies)
+
+    const auto render_detection_rects = [this](const auto& actor)
     {
-      for (const auto r : enemy->get_detection_rects(game_->get_level()))
+      for (const auto r : actor.get_detection_rects(game_->get_level()))
       {
         const geometry::Rectangle dest_rect{r.position - game_camera_.position, r.size};
         window_.render_rectangle(dest_rect, {255, 255, 0});
       }
-    }
+    };
+    game_->get_level().hazards.for_each(render_detection_rects);
+    game_->get_level().enemies.for_each(render_detection_rects);
   }
 }
 
@@ -378,6 +486,7 @@ void GameRenderer::render_items() const
   const auto end_tile_x = (game_camera_.position.x() + game_camera_.size.x()) / 16;
   const auto end_tile_y = (game_camera_.position.y() + game_camera_.size.y()) / 16;
 
+  sprite_manager_->begin_batch();
   for (int tile_y = start_tile_y; tile_y <= end_tile_y; tile_y++)
   {
     for (int tile_x = start_tile_x; tile_x <= end_tile_x; tile_x++)
@@ -392,6 +501,7 @@ void GameRenderer::render_items() const
       sprite_manager_->render_tile(static_cast<int>(item.get_sprite()), {tile_x * SPRITE_W, tile_y * SPRITE_H}, game_camera_.position);
     }
   }
+  sprite_manager_->end_batch();
 }
 
 void GameRenderer::render_statusbar() const
@@ -401,6 +511,7 @@ void GameRenderer::render_statusbar() const
 
   window_.fill_rect(statusbar_rect, {0u, 0u, 0u});
 
+  sprite_manager_->begin_batch();
   constexpr int dy = 1;
   // $
   sprite_manager_->render_text(L"$", statusbar_rect.position + geometry::Position(0, dy));
@@ -420,4 +531,5 @@ void GameRenderer::render_statusbar() const
   {
     sprite_manager_->render_icon(Icon::ICON_KEY, statusbar_rect.position + geometry::Position(23 * CHAR_W, dy));
   }
+  sprite_manager_->end_batch();
 }
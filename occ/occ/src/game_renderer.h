@@ -1,6 +1,10 @@
 #ifndef GAME_RENDERER_H_
 #define GAME_RENDERER_H_
 
+#include <array>
+#include <memory>
+#include <vector>
+
 #include "geometry.h"
 
 class Game;
@@ -13,15 +17,53 @@ class GameRenderer
  public:
   GameRenderer(Game* game, SpriteManager* sprite_manager, Surface* game_surface, Window& window);
 
+  // Must be called when the level has changed
+  void reset();
   void update(unsigned game_tick);
   void render_game() const;
 
+  // Draw calls made by render_game since the last reset
+  struct DrawCallStats
+  {
+    unsigned num_frames = 0u;
+    unsigned long long total = 0u;
+    unsigned max = 0u;
+  };
+
+  // Returns the number of draw calls made by the last call to render_game
+  unsigned get_num_draw_calls() const { return num_draw_calls_; }
+  const DrawCallStats& get_draw_call_stats() const { return draw_call_stats_; }
+
   const geometry::Rectangle& get_game_camera() const { return game_camera_; }
 
   bool get_debug() const { return debug_; }
   void set_debug(bool debug) { debug_ = debug; }
 
  private:
+  // Static (non-animated) background and tile layers are pre-rendered to target surfaces in chunks of
+  // CHUNK_TILES x CHUNK_TILES tiles the first time a chunk is visible, so that each layer needs only a
+  // few blits per frame. Animated tiles and items are still rendered tile by tile.
+  static constexpr int CHUNK_TILES = 16;
+
+  enum class Layer
+  {
+    BACKGROUND,
+    TILES_BEHIND,
+    TILES_IN_FRONT,
+  };
+
+  struct Chunk
+  {
+    bool rendered = false;
+    bool empty = true;
+    std::unique_ptr<Surface> surface;
+  };
+
+  int get_static_sprite(Layer layer, int tile_x, int tile_y) const;
+  void render_static_tiles(Layer layer, int chunk_x, int chunk_y, const geometry::Position& camera_position) const;
+  void render_chunk(Layer layer, Chunk& chunk, int chunk_x, int chunk_y) const;
+  void render_layer(Layer layer) const;
+
   void render_background() const;
   void render_player() const;
   void render_tiles(bool in_front) const;
@@ -40,6 +82,10 @@ class GameRenderer
   unsigned game_tick_diff_;
 
   bool debug_;
+
+  mutable std::array<std::vector<Chunk>, 3> chunks_;
+  mutable unsigned num_draw_calls_;
+  mutable DrawCallStats draw_call_stats_;
 };
 
 #endif  // GAME_RENDERER_H_
@@ -23,54 +23,73 @@ std::filesystem::path get_image_path(const int episode, const CCImage image, con
   return get_data_path(filename);
 }
 
-std::unique_ptr<Surface> load_surface(Window& window, const int episode, const CCImage image, const int index)
+std::vector<std::unique_ptr<Pixels>> decode_images(const std::vector<std::filesystem::path>& paths)
 {
-  auto path = get_image_path(episode, image, index);
-  if (path.empty())
+  std::vector<std::unique_ptr<Pixels>> images;
+  for (const auto& path : paths)
   {
-    return nullptr;
+    auto pixels = Pixels::from_image(path);
+    if (!pixels)
+    {
+      LOG_CRITICAL("Could not load '%s'", path.string().c_str());
+      continue;
+    }
+    images.emplace_back(std::move(pixels));
   }
-  auto surface = Surface::from_image(path, window);
-  if (!surface)
+  return images;
+}
+
+ImageManager::ImageManager(const std::size_t budget)
+  : budget_(budget),
+    window_(nullptr),
+    episode_images_(),
+    surface_bytes_(0u),
+    frame_(1u),
+    pool_(1u)
+{
+}
+
+bool ImageManager::load_images(Window& window)
+{
+  if (!find_images())
   {
-    LOG_CRITICAL("Could not load '%ls'", path.c_str());
-    return nullptr;
+    return false;
   }
-  return surface;
+  set_window(window);
+  return true;
 }
 
-bool ImageManager::load_images(Window& window)
+bool ImageManager::find_images()
 {
-  // Check if images already loaded
+  // Check if images already found
   if (!episode_images_.empty())
   {
     return false;
   }
 
-  // Load images
+  // Find images
   bool end = false;
   for (int episode = 1; !end; episode++)
   {
-    std::array<std::vector<std::unique_ptr<Surface>>, 4> episode_surfaces;
-    int loaded = 0;
+    std::array<Images, 4> episode_images;
+    int found = 0;
     for (int image = IMAGE_APOGEE; image <= IMAGE_END; image++)
     {
-      std::vector<std::unique_ptr<Surface>> image_surfaces;
-      auto surface = load_surface(window, episode, (CCImage)image, 0);
-      if (surface == nullptr)
+      auto& paths = episode_images[image].paths;
+      auto path = get_image_path(episode, (CCImage)image, 0);
+      if (path.empty())
       {
         // Try again but with different image indices
         for (int index = 1;; index++)
         {
-          surface = load_surface(window, episode, (CCImage)image, index);
-          if (surface == nullptr)
+          path = get_image_path(episode, (CCImage)image, index);
+          if (path.empty())
           {
             break;
           }
-          loaded++;
-          image_surfaces.emplace_back(std::move(surface));
+          paths.push_back(path);
         }
-        if (image_surfaces.empty())
+        if (paths.empty())
         {
           if (episode == 1)
           {
@@ -83,28 +102,83 @@ bool ImageManager::load_images(Window& window)
       }
       else
       {
-        loaded++;
-        image_surfaces.emplace_back(std::move(surface));
+        paths.push_back(path);
       }
-      episode_surfaces[image] = std::move(image_surfaces);
+      found += static_cast<int>(paths.size());
     }
-    if (loaded > 0)
+    if (found > 0)
     {
-      episode_images_.emplace_back(std::move(episode_surfaces));
+      episode_images_.emplace_back(std::move(episode_images));
     }
   }
 
   return true;
 }
 
-std::vector<Surface*> ImageManager::get_images(size_t episode, CCImage image) const
+std::vector<Surface*> ImageManager::get_images(size_t episode, CCImage image)
 {
-  std::vector<Surface*> images;
-  const auto& episode_images = episode_images_[episode - 1];
-  const auto& type_images = episode_images[(int)image];
-  for (auto&& surface : type_images)
+  auto& images = episode_images_[episode - 1][(int)image];
+  images.last_used = frame_;
+  if (!images.loaded)
   {
-    images.push_back(surface.get());
+    const auto pixels = images.decoding.valid() ? images.decoding.get() : decode_images(images.paths);
+    for (const auto& p : pixels)
+    {
+      auto surface = Surface::from_pixels(p->width, p->height, p->data.data(), *window_);
+      if (!surface)
+      {
+        LOG_CRITICAL("Could not create surface for game image %d", (int)image);
+        continue;
+      }
+      images.surfaces.emplace_back(std::move(surface));
+      images.bytes += p->data.size() * sizeof(uint32_t);
+    }
+    images.loaded = true;
+    surface_bytes_ += images.bytes;
+    LOG_DEBUG("Loaded game image %d of episode %d, %zu bytes of surfaces", (int)image, (int)episode, surface_bytes_);
   }
-  return images;
+
+  std::vector<Surface*> surfaces;
+  for (auto&& surface : images.surfaces)
+  {
+    surfaces.push_back(surface.get());
+  }
+  return surfaces;
+}
+
+void ImageManager::prefetch(size_t episode, CCImage image)
+{
+  auto& images = episode_images_[episode - 1][(int)image];
+  if (!images.loaded && !images.decoding.valid())
+  {
+    images.decoding = pool_.submit([paths = images.paths]() { return decode_images(paths); });
+  }
+}
+
+void ImageManager::evict()
+{
+  while (budget_ > 0u && surface_bytes_ > budget_)
+  {
+    Images* lru = nullptr;
+    for (auto& episode_images : episode_images_)
+    {
+      for (auto& images : episode_images)
+      {
+        if (!images.surfaces.empty() && images.last_used != frame_ && (!lru || images.last_used < lru->last_used))
+        {
+          lru = &images;
+        }
+      }
+    }
+    if (!lru)
+    {
+      // Everything left is in use
+      break;
+    }
+    lru->surfaces.clear();
+    lru->loaded = false;
+    surface_bytes_ -= lru->bytes;
+    lru->bytes = 0u;
+  }
+  frame_++;
 }
@@ -1,11 +1,15 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
+#include <filesystem>
+#include <future>
 #include <memory>
 #include <vector>
 
 #include "geometry.h"
 #include "graphics.h"
+#include "thread_pool.h"
 
 enum CCImage
 {
@@ -15,16 +19,55 @@ enum CCImage
   IMAGE_END = 3,      // ext .END
 };
 
+// Images are decoded and uploaded when they are first requested, and the least recently used ones are freed
+// when their surfaces use more than the budget
 class ImageManager
 {
  public:
-  ImageManager() : episode_images_() {}
+  // budget is the number of bytes of surfaces that evict keeps, or 0 for no limit
+  explicit ImageManager(const std::size_t budget = 0u);
 
+  // Same as find_images followed by set_window
   bool load_images(Window& window);
+  // Finds the image files of all episodes without decoding them, does not use the window so it can be
+  // called on any thread
+  bool find_images();
+  // The window to create the surfaces for, must be set before get_images
+  void set_window(Window& window) { window_ = &window; }
+
   size_t number_of_episodes() const { return episode_images_.size(); }
-  std::vector<Surface*> get_images(size_t episode, CCImage image) const;
+
+  // Returns the images, decoding and uploading them first if they are not loaded
+  // Images that could not be decoded or uploaded are left out, and are only tried again once evict has freed the
+  // others of the same type, so never if none of them could be loaded
+  // The surfaces stay valid until they are freed by evict
+  std::vector<Surface*> get_images(size_t episode, CCImage image);
+  // Starts decoding the images on a worker thread, so that get_images only has to upload them
+  void prefetch(size_t episode, CCImage image);
+  // Frees the least recently used images until the surfaces fit in the budget
+  // Images returned by get_images since the last call are kept, so call this when no surfaces are in use
+  void evict();
+  std::size_t get_surface_bytes() const { return surface_bytes_; }
 
  private:
-  // Episode, image type, images
-  std::vector<std::array<std::vector<std::unique_ptr<Surface>>, 4>> episode_images_;
+  struct Images
+  {
+    std::vector<std::filesystem::path> paths;
+    std::future<std::vector<std::unique_ptr<Pixels>>> decoding;
+    std::vector<std::unique_ptr<Surface>> surfaces;
+    // Set once the images are decoded and uploaded, even if some failed, so that failed images are not retried
+    bool loaded = false;
+    std::size_t bytes = 0u;
+    unsigned last_used = 0u;
+  };
+
+  std::size_t budget_;
+  Window* window_;
+  // Episode, image type
+  std::vector<std::array<Images, 4>> episode_images_;
+  std::size_t surface_bytes_;
+  // Incremented by evict
+  unsigned frame_;
+  // Destroyed first so that no image is being decoded when the images are destroyed
+  ThreadPool pool_;
 };
@@ -1,8 +1,12 @@
 #include <cassert>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 
+#include <algorithm>
 #include <memory>
+#include <random>
+#include <thread>
 #include <utility>
 
 #include "constants.h"
@@ -15,109 +19,216 @@
 #include "geometry.h"
 #include "logger.h"
 #include "path.h"
+#include "task_graph.h"
 
 #define ICON_FILENAME_FMT "caves%d.ico"
 
 
-int main()
+int main(int argc, char* argv[])
 {
   LOG_INFO("Starting!");
 
-  // Init SDL wrapper
-  auto sdl = SDLWrapper::create();
-  if (!sdl)
+  bool startup_report = false;
+  const char* demo_path = nullptr;
+  for (int i = 1; i < argc; i++)
   {
-    LOG_CRITICAL("Could not create SDLWrapper");
-    return 1;
-  }
-  if (!sdl->init())
-  {
-    LOG_CRITICAL("Could not initialize SDLWrapper");
-    return 1;
+    if (std::strcmp(argv[i], "--startup-report") == 0)
+    {
+      startup_report = true;
+    }
+    else if (std::strcmp(argv[i], "--record-demo") == 0 && i + 1 < argc)
+    {
+      demo_path = argv[++i];
+    }
+    else
+    {
+      LOG_ERROR("Unknown argument '%s'", argv[i]);
+    }
   }
-  LOG_INFO("SDLWrapper initialized");
 
   // TODO: select episode
   const int episode = 1;
 
-  // Create Window
-  const auto icon_file = misc::string_format(ICON_FILENAME_FMT, episode);
-  const auto icon_path = get_data_path(icon_file);
-  if (icon_path.empty())
-  {
-    LOG_ERROR("could not find icon file %s", icon_file.c_str());
-  }
-  auto window = Window::create("OpenCrystalCaves", WINDOW_SIZE, icon_path);
-  if (!window)
-  {
-    LOG_CRITICAL("Could not create Window");
-    return 1;
-  }
-  LOG_INFO("Window created");
-
-  // Create game surface
-  auto game_surface = window->create_target_surface(CAMERA_SIZE);
-  if (!game_surface)
+  // Startup runs as a graph: everything that only needs the CPU (decoding the tilesets and images,
+  // decompressing the EXE and parsing the first level) runs on worker threads while SDL and the window
+  // are created, and the surfaces are created on this thread once both are done
+  std::unique_ptr<SDLWrapper> sdl;
+  std::unique_ptr<Window> window;
+  std::unique_ptr<Surface> game_surface;
+  std::unique_ptr<Event> event;
+  SpriteManager sprite_manager;
+  ImageManager image_manager(IMAGE_SURFACE_BUDGET);
+  // The game prepares levels from exe_data in the background, so exe_data must outlive it
+  std::unique_ptr<ExeData> exe_data;
+  // A new seed every run, so that e.g. the star backgrounds are different each time
+  std::unique_ptr<Game> game = Game::create(std::random_device()());
+  if (!game)
   {
-    LOG_CRITICAL("Could not create game surface");
+    LOG_CRITICAL("Could not create Game");
     return 1;
   }
-  LOG_INFO("Game surface created");
 
-  // Create event handler
-  auto event = Event::create();
-  if (!event)
-  {
-    LOG_CRITICAL("Could not create event handler");
-    return 1;
-  }
+  TaskGraph startup;
+  const auto init_sdl = startup.add("sdl",
+                                    TaskGraph::Thread::MAIN,
+                                    {},
+                                    [&sdl]()
+                                    {
+                                      // Init SDL wrapper
+                                      sdl = SDLWrapper::create();
+                                      if (!sdl)
+                                      {
+                                        LOG_CRITICAL("Could not create SDLWrapper");
+                                        return false;
+                                      }
+                                      if (!sdl->init())
+                                      {
+                                        LOG_CRITICAL("Could not initialize SDLWrapper");
+                                        return false;
+                                      }
+                                      LOG_INFO("SDLWrapper initialized");
+                                      return true;
+                                    });
+  const auto create_window = startup.add("window",
+                                         TaskGraph::Thread::MAIN,
+                                         {init_sdl},
+                                         [&window, &game_surface, &event]()
+                                         {
+                                           // Create Window
+                                           const auto icon_file = misc::string_format(ICON_FILENAME_FMT, episode);
+                                           const auto icon_path = get_data_path(icon_file);
+                                           if (icon_path.empty())
+                                           {
+                                             LOG_ERROR("could not find icon file %s", icon_file.c_str());
+                                           }
+                                           window = Window::create("OpenCrystalCaves", WINDOW_SIZE, icon_path);
+                                           if (!window)
+                                           {
+                                             LOG_CRITICAL("Could not create Window");
+                                             return false;
+                                           }
+                                           LOG_INFO("Window created");
 
-  // Load tileset
-  SpriteManager sprite_manager;
-  if (!sprite_manager.load_tilesets(*window, episode))
-  {
-    LOG_CRITICAL("Could not load tilesets");
-    return 1;
-  }
-  LOG_INFO("Tileset loaded");
+                                           // Create game surface
+                                           game_surface = window->create_target_surface(CAMERA_SIZE);
+                                           if (!game_surface)
+                                           {
+                                             LOG_CRITICAL("Could not create game surface");
+                                             return false;
+                                           }
+                                           LOG_INFO("Game surface created");
 
-  // Load image manager
-  ImageManager image_manager;
-  if (!image_manager.load_images(*window))
-  {
-    LOG_CRITICAL("Could not load images");
-    return 1;
-  }
-  LOG_INFO("Images loaded");
+                                           // Create event handler
+                                           event = Event::create();
+                                           if (!event)
+                                           {
+                                             LOG_CRITICAL("Could not create event handler");
+                                             return false;
+                                           }
+                                           return true;
+                                         });
+  const auto decode_tilesets = startup.add("tileset decode",
+                                           TaskGraph::Thread::WORKER,
+                                           {},
+                                           [&sprite_manager]()
+                                           {
+                                             if (!sprite_manager.decode_tilesets(episode))
+                                             {
+                                               LOG_CRITICAL("Could not load tilesets");
+                                               return false;
+                                             }
+                                             return true;
+                                           });
+  const auto find_images = startup.add("image index",
+                                       TaskGraph::Thread::WORKER,
+                                       {},
+                                       [&image_manager]()
+                                       {
+                                         if (!image_manager.find_images())
+                                         {
+                                           LOG_CRITICAL("Could not find images");
+                                           return false;
+                                         }
+                                         // The splash images are shown first
+                                         image_manager.prefetch(episode, CCImage::IMAGE_APOGEE);
+                                         return true;
+                                       });
+  const auto load_exe_data = startup.add("exe data",
+                                         TaskGraph::Thread::WORKER,
+                                         {},
+                                         [&exe_data, episode]()
+                                         {
+                                           exe_data = std::make_unique<ExeData>(episode);
+                                           return true;
+                                         });
+  startup.add("initial level",
+              TaskGraph::Thread::WORKER,
+              {load_exe_data},
+              [&game, &exe_data]()
+              {
+                if (!game->init(*exe_data, LevelId::INTRO))
+                {
+                  LOG_CRITICAL("Could not initialize Game");
+                  return false;
+                }
+                LOG_INFO("Game initialized");
+                return true;
+              });
+  startup.add("tileset upload",
+              TaskGraph::Thread::MAIN,
+              {create_window, decode_tilesets},
+              [&sprite_manager, &window]()
+              {
+                if (!sprite_manager.upload_tilesets(*window))
+                {
+                  LOG_CRITICAL("Could not load tilesets");
+                  return false;
+                }
+                LOG_INFO("Tileset loaded");
+                return true;
+              });
+  startup.add("splash upload",
+              TaskGraph::Thread::MAIN,
+              {create_window, find_images},
+              [&image_manager, &window]()
+              {
+                // Other images are loaded when they are needed
+                image_manager.set_window(*window);
+                if (image_manager.get_images(episode, CCImage::IMAGE_APOGEE).empty())
+                {
+                  LOG_CRITICAL("Could not load images");
+                  return false;
+                }
+                LOG_INFO("Images loaded");
+                return true;
+              });
 
-  // Create Game
-  std::unique_ptr<Game> game = Game::create();
-  if (!game)
+  // All worker tasks can run at the same time
+  const auto ok = startup.run(std::max(1u, std::min(4u, std::thread::hardware_concurrency())));
+  if (startup_report)
   {
-    LOG_CRITICAL("Could not create Game");
-    return 1;
+    printf("Startup:\n%s", startup.get_report().c_str());
   }
-  ExeData exe_data{episode};
-  if (!game->init(exe_data, LevelId::INTRO))
+  if (!ok)
   {
-    LOG_CRITICAL("Could not initialize Game");
     return 1;
   }
-  LOG_INFO("Game initialized");
 
   // Create game states
   // TODO: more episodes
-  auto splash_images = image_manager.get_images(1, CCImage::IMAGE_APOGEE);
-  SplashState splash{splash_images, *window};
-  auto title_images = image_manager.get_images(1, CCImage::IMAGE_TITLE);
-  auto credits_images = image_manager.get_images(1, CCImage::IMAGE_CREDITS);
-  title_images.insert(title_images.end(), credits_images.begin(), credits_images.end());
-  TitleState title{sprite_manager, *game_surface, title_images, *window, exe_data};
+  SplashState splash{image_manager, episode, *window};
+  TitleState title{sprite_manager, *game_surface, image_manager, episode, *window, *exe_data};
   splash.set_next(title);
-  GameState game_state(*game, sprite_manager, *game_surface, *window, exe_data);
+  GameState game_state(*game, sprite_manager, *game_surface, *window, *exe_data);
+  if (demo_path)
+  {
+    // Can be replayed with game_runner
+    game_state.record_demo(demo_path);
+  }
   title.set_next(game_state);
   game_state.set_next(title);
   State* state = &splash;
+  state->reset();
 
   // Game loop
   {
@@ -126,7 +237,6 @@ int main()
 
     // Game loop logic
     auto sdl_tick = sdl->get_tick();
-    const auto ms_per_update = 57;  // 17.5~ ticks per second
     auto tick_last_update = sdl_tick;
     auto lag = 0u;
 
@@ -149,13 +259,13 @@ int main()
         auto elapsed_ticks = sdl_tick - tick_last_update;
         tick_last_update = sdl_tick;
         lag += elapsed_ticks;
-        if (lag >= ms_per_update)
+        if (lag >= MS_PER_UPDATE)
         {
           break;
         }
-        sdl->delay(ms_per_update - lag);
+        sdl->delay(MS_PER_UPDATE - lag);
       }
-      while (lag >= ms_per_update)
+      while (lag >= MS_PER_UPDATE)
       {
         // Read input
         event->poll_event(&input);
@@ -173,7 +283,7 @@ int main()
           state = new_state;
         }
 
-        lag -= ms_per_update;
+        lag -= MS_PER_UPDATE;
       }
 
       /////////////////////////////////////////////////////////////////////////
@@ -191,6 +301,9 @@ int main()
       // Update screen
       window->refresh();
 
+      // Free images that have not been shown for a while
+      image_manager.evict();
+
       // Calculate FPS each second
       fps_num_renders++;
       if (sdl_tick >= (fps_last_calc + 1000))
@@ -259,15 +259,15 @@ Panel* Panel::update(const Input& input)
     const auto sparkle_frame = (ticks_ / 3) % (std::size(S_ICONS) + 1);
     if (sparkle_frame == 0)
     {
-      if (misc::random<int>(0, 1) == 0)
+      if (random_.range<int>(0, 1) == 0)
       {
         // Put the sparkle on the top edge
-        sparkle_pos_ = geometry::Position(misc::random<int>(1, size_.x()) * CHAR_W, 0);
+        sparkle_pos_ = geometry::Position(random_.range<int>(1, size_.x()) * CHAR_W, 0);
       }
       else
       {
         // Put the sparkle on the left edge
-        sparkle_pos_ = geometry::Position(0, misc::random<int>(1, size_.y()) * CHAR_H);
+        sparkle_pos_ = geometry::Position(0, random_.range<int>(1, size_.y()) * CHAR_H);
       }
     }
   }
@@ -343,6 +343,8 @@ void Panel::draw(const SpriteManager& sprite_manager) const
   const geometry::Position frame_pos(((SCREEN_SIZE.x() / CHAR_W - size_.x() - 1) / 2 - 1) * CHAR_W,
                                      ((SCREEN_SIZE.y() / CHAR_H - size_.y() - 1) / 2 - 2) * CHAR_H);
   const geometry::Size frame_size = size_ + geometry::Size(2, 2);
+  // The panel is drawn almost entirely from the char surface, so draw it as one batch
+  sprite_manager.begin_batch();
   // Draw frame
   // Top-left corner
   sprite_manager.render_icon(Icon::ICON_FRAME_NW, frame_pos);
@@ -476,6 +478,7 @@ void Panel::draw(const SpriteManager& sprite_manager) const
   {
     sprite_manager.render_icon(icon.first, icon.second);
   }
+  sprite_manager.end_batch();
 }
 
 void Panel::add_input(char c)
@@ -2,7 +2,10 @@
 
 #include <event.h>
 
+#include <random>
+
 #include "exe_data.h"
+#include "random.h"
 #include "spritemgr.h"
 
 // Episode 1 panel text offsets
@@ -113,7 +116,7 @@ class Panel
         const std::vector<std::pair<int, geometry::Position>> sprites = {},
         const std::vector<std::pair<Icon, geometry::Position>> icons = {},
         const PanelType type = PanelType::PANEL_TYPE_NORMAL)
-    : Panel(exe_data.data.c_str() + static_cast<int>(pt), sprites, icons, type)
+    : Panel(exe_data.data.data() + static_cast<int>(pt), sprites, icons, type)
   {
   }
   // Basic panel
@@ -140,6 +143,8 @@ class Panel
   geometry::Size size_;
   geometry::Position question_pos_ = {0, 0};
   geometry::Position sparkle_pos_ = {0, 0};
+  // Seeded per panel, so that the sparkle moves differently each time
+  Random random_{std::random_device()()};
   unsigned ticks_ = 0;
   Panel* parent_ = nullptr;
   std::string input_str_ = "";
@@ -1,277 +1,145 @@
-/*
-https://moddingwiki.shikadi.net/wiki/ProGraphx_Toolbox_tileset_format
-*/
 #include "spritemgr.h"
 
 #include <filesystem>
-#include <fstream>
-#include <map>
+#include <vector>
 
 #include "logger.h"
 #include "misc.h"
-#include "occ_math.h"
 #include "path.h"
 #include "sprite.h"
+#include "tileset.h"
 #include "wchars.h"
 
 #define GFX_FILENAME_FMT "CC%d.GFX"
 #define FONT_FILENAME_FMT "CC%d-F%d.MNI"
 #define SPL_FILENAME_FMT "CC%d-SPL.MNI"
+#define FONT_CACHE_FILENAME_FMT "CC%d-F.pixels"
 #define FILLER 2
 #define CHAR_STRIDE 50
+// Small enough for the maximum texture size of any renderer
+#define ATLAS_MAX_SIZE 2048
+// Number of different strings that render_text keeps shaped
+#define TEXT_CACHE_SIZE 256
 
-struct Header
+TilesetPixels decode_tiles(const int episode)
 {
-  uint8_t count;
-  uint8_t width;
-  uint8_t height;
-
-  size_t size() const { return count * width * height * 5; }
-};
-
-const uint32_t colors[] = {
-  0xFF000000,  // "⚫",
-  0xFF0000AA,  // "🔵",
-  0xFF00AA00,  // "🟢",
-  0xFF00AAAA,  // "💧",
-  0xFFAA0000,  // "🔴",
-  0xFFAA00AA,  // "🟣",
-  0xFFAA5500,  // "🟠",
-  0xFFAAAAAA,  // "⚪",
-  0xFF555555,  // "⬛",
-  0xFF5555FF,  // "🟦",
-  0xFF55FF55,  // "🟩",
-  0xFF55FFFF,  // "🐬",
-  0xFFFF5555,  // "🟥",
-  0xFFFF55FF,  // "🟪",
-  0xFFFFFFAA,  // "🟨",
-  0xFFFFFFFF,  // "⬜",
-};
-
-int read_sprite_count(std::ifstream& input, const int filler)
-{
-  Header header;
-  int count = 0;
-  while (input.read(reinterpret_cast<char*>(&header), sizeof header))
+  // Load tileset
+  const auto path = get_data_path(misc::string_format(GFX_FILENAME_FMT, episode));
+  if (path.empty())
   {
-    LOG_DEBUG("Read chunk %d sprites, %d bytes by %d pixels", header.count, header.width, header.height);
-    if (header.count != 50)
-    {
-      // Don't read sprite chunks that are not exactly 50 sprites, they are lies!
-      break;
-    }
-    count += header.count;
-    if (header.count > 0)
-    {
-      count += filler;
-    }
-    input.seekg(header.size(), std::ios_base::cur);
+    LOG_CRITICAL("Could not find game data!");
+    return TilesetPixels();
   }
-  input.clear();
-  input.seekg(0, std::ios_base::beg);
-  return count;
-}
-
-std::string load_pixels(const std::filesystem::path& path,
-                        const int sprite_w,
-                        const int sprite_h,
-                        const int stride,
-                        const int filler,
-                        int& sheet_w,
-                        int& sheet_h)
-{
-  LOG_DEBUG("Reading %ls...", path.c_str());
-  std::ifstream input{path, std::ios::binary};
-  const int count = read_sprite_count(input, filler);
-  if (count == 0)
+  auto pixels =
+    load_tilesets({path}, {SPRITE_W, SPRITE_H, SPRITE_STRIDE, FILLER}, misc::string_format(GFX_FILENAME_FMT ".pixels", episode));
+  if (pixels.empty())
   {
     LOG_CRITICAL("Could not load any sprites!");
-    return "";
-  }
-  sheet_w = stride * sprite_w;
-  sheet_h = math::round_up(count * sprite_h / stride, sprite_h);
-  std::string all_pixels(sheet_w * sheet_h * sizeof(uint32_t), '\0');
-  Header header;
-  int index = 0;
-  while (input.read(reinterpret_cast<char*>(&header), sizeof header))
-  {
-    if (header.count == 50)
-    {
-      std::string pixels(header.size(), '\0');
-      input.read(&pixels[0], header.size());
-      uint8_t* pp = (uint8_t*)(&pixels[0]);
-      for (int c = 0; c < header.count; c++, index++)
-      {
-        int x_start = (index % stride) * sprite_w;
-        int y_start = (index / stride) * sprite_h;
-        int x = x_start;
-        int y = y_start;
-        // Note: deliberately ignoring the header width/height,
-        //  and reading our preferred sprite size here... it seems to work
-        for (int h = 0; h < sprite_h; h++)
-        {
-          for (int w = 0; w < sprite_w / 8; w++)
-          {
-            const uint8_t t_plane = *pp++;
-            const uint8_t b_plane = *pp++;
-            const uint8_t g_plane = *pp++;
-            const uint8_t r_plane = *pp++;
-            const uint8_t i_plane = *pp++;
-            int pi = 0;
-            for (int bit = 7; bit >= 0; bit--, pi++)
-            {
-              const bool t = (t_plane >> bit) & 1;
-              const int pixel_i = x + y * stride * sprite_h;
-              if (!t)
-              {
-                ((uint32_t*)all_pixels.data())[pixel_i] = 0;
-              }
-              else
-              {
-                const bool b = (b_plane >> bit) & 1;
-                const bool g = (g_plane >> bit) & 1;
-                const bool r = (r_plane >> bit) & 1;
-                const bool i = (i_plane >> bit) & 1;
-                ((uint32_t*)all_pixels.data())[pixel_i] = colors[((int)i << 3) | ((int)r << 2) | ((int)g << 1) | (int)b];
-              }
-              x++;
-              if (x == x_start + sprite_w)
-              {
-                y++;
-                x = x_start;
-              }
-            }
-          }
-        }
-      }
-      index += filler;
-    }
   }
-  return all_pixels;
+  return pixels;
 }
 
-std::unique_ptr<Surface> load_surface(const std::filesystem::path& path,
-                                      Window& window,
-                                      const int sprite_w,
-                                      const int sprite_h,
-                                      const int stride,
-                                      const int filler)
+TilesetPixels decode_chars(const int episode)
 {
-  if (path.empty())
+  // Load fonts/characters
+  std::vector<std::filesystem::path> paths;
+  for (int i = 1;; i++)
   {
-    LOG_CRITICAL("Could not find game data!");
-    return nullptr;
+    const auto path = get_data_path(misc::string_format(FONT_FILENAME_FMT, episode, i));
+    if (path.empty())
+    {
+      break;
+    }
+    paths.push_back(path);
   }
-  int sheet_w = 0, sheet_h = 0;
-  const auto all_pixels = load_pixels(path, sprite_w, sprite_h, stride, filler, sheet_w, sheet_h);
-  if (all_pixels.empty())
+  const auto spl_path = get_data_path(misc::string_format(SPL_FILENAME_FMT, episode));
+  if (!spl_path.empty())
   {
-    return nullptr;
+    paths.push_back(spl_path);
   }
-  auto surface = Surface::from_pixels(sheet_w, sheet_h, (uint32_t*)all_pixels.data(), window);
-  if (!surface)
+  auto pixels = load_tilesets(paths, {CHAR_W, CHAR_H, CHAR_STRIDE, 0}, misc::string_format(FONT_CACHE_FILENAME_FMT, episode));
+  if (pixels.empty())
   {
-    LOG_CRITICAL("Could not load '%ls'", path.c_str());
+    LOG_CRITICAL("Could not load font files");
   }
-  return surface;
+  return pixels;
 }
 
-std::unique_ptr<Surface> load_tiles(Window& window, const int episode)
+bool SpriteManager::load_tilesets(Window& window, const int episode)
 {
-  // Load tileset
-  const auto path = get_data_path(misc::string_format(GFX_FILENAME_FMT, episode));
-  return load_surface(path, window, SPRITE_W, SPRITE_H, SPRITE_STRIDE, FILLER);
+  return decode_tilesets(episode) && upload_tilesets(window);
 }
 
-bool try_load_char_pixels(const std::filesystem::path& path, std::string& all_pixels, int& all_sheet_w, int& all_sheet_h)
+bool SpriteManager::decode_tilesets(const int episode)
 {
-  if (path.empty())
+  if (!atlas_.get_pages().empty())
   {
-    return false;
+    return true;
   }
-  int sheet_w, sheet_h;
-  const auto pixels = load_pixels(path, CHAR_W, CHAR_H, CHAR_STRIDE, 0, sheet_w, sheet_h);
-  if (pixels.empty())
+  const auto sprite_pixels = decode_tiles(episode);
+  if (sprite_pixels.empty())
   {
     return false;
   }
-  all_pixels += pixels;
-  all_sheet_w = sheet_w;
-  all_sheet_h += sheet_h;
-  return true;
-}
-
-std::unique_ptr<Surface> load_chars(Window& window, const int episode)
-{
-  // Load fonts/characters
-  std::string all_pixels = "";
-  int all_sheet_w = 0;
-  int all_sheet_h = 0;
-  for (int i = 1;; i++)
+  const auto char_pixels = decode_chars(episode);
+  if (char_pixels.empty())
   {
-    const auto path = get_data_path(misc::string_format(FONT_FILENAME_FMT, episode, i));
-    if (!try_load_char_pixels(path, all_pixels, all_sheet_w, all_sheet_h))
-    {
-      break;
-    }
+    return false;
   }
-  const auto spl_path = get_data_path(misc::string_format(SPL_FILENAME_FMT, episode));
-  try_load_char_pixels(spl_path, all_pixels, all_sheet_w, all_sheet_h);
-  if (all_pixels.empty())
+  const auto cones_pixels = Pixels::from_image(get_data_path("../cones.png"));
+  if (!cones_pixels)
   {
-    LOG_CRITICAL("Could not load font files");
-    return nullptr;
+    return false;
   }
-  auto surface = Surface::from_pixels(all_sheet_w, all_sheet_h, (uint32_t*)all_pixels.data(), window);
-  if (!surface)
+
+  if (!atlas_.pack({{sprite_pixels.width(), sprite_pixels.height(), sprite_pixels.data()},
+                    {char_pixels.width(), char_pixels.height(), char_pixels.data()},
+                    {cones_pixels->width, cones_pixels->height, cones_pixels->data.data()}},
+                   ATLAS_MAX_SIZE))
   {
-    LOG_CRITICAL("Could not load font surface");
+    LOG_CRITICAL("Could not pack sprites into an atlas");
+    return false;
   }
-  return surface;
+  sprite_region_ = atlas_.get_region(0);
+  char_region_ = atlas_.get_region(1);
+  cones_region_ = atlas_.get_region(2);
+  LOG_DEBUG("Packed sprites into %d atlas page(s)", (int)atlas_.get_pages().size());
+
+  return true;
 }
 
-bool SpriteManager::load_tilesets(Window& window, const int episode)
+bool SpriteManager::upload_tilesets(Window& window)
 {
-  if (!sprite_surface_)
-  {
-    sprite_surface_ = load_tiles(window, episode);
-    if (!sprite_surface_)
-    {
-      return false;
-    }
-  }
-  if (!char_surface_)
+  if (!atlas_surfaces_.empty())
   {
-    char_surface_ = load_chars(window, episode);
-    if (!char_surface_)
-    {
-      return false;
-    }
+    return true;
   }
-  if (!cones_surface_)
+  for (const auto& page : atlas_.get_pages())
   {
-    const auto path = get_data_path("../cones.png");
-    cones_surface_ = Surface::from_image(path, window);
-    if (!cones_surface_)
+    auto surface = Surface::from_pixels(page.width, page.height, page.pixels.data(), window);
+    if (!surface)
     {
+      LOG_CRITICAL("Could not create atlas surface");
+      atlas_surfaces_.clear();
       return false;
     }
+    atlas_surfaces_.emplace_back(std::move(surface));
   }
+  atlas_.clear_pixels();
 
   return true;
 }
 
 const Surface* SpriteManager::get_surface() const
 {
-  return sprite_surface_.get();
+  return atlas_surfaces_[sprite_region_.page].get();
 }
 
 geometry::Rectangle SpriteManager::get_rect_for_tile(const int sprite) const
 {
-  return {(sprite % (sprite_surface_->width() / SPRITE_W)) * SPRITE_W,
-          (sprite / (sprite_surface_->width() / SPRITE_H)) * SPRITE_H,
-          SPRITE_W,
-          SPRITE_H};
+  const auto stride = sprite_region_.rect.size.x() / SPRITE_W;
+  return geometry::Rectangle((sprite % stride) * SPRITE_W, (sprite / stride) * SPRITE_H, SPRITE_W, SPRITE_H) +
+         sprite_region_.rect.position;
 }
 
 void SpriteManager::render_tile(const int sprite, const geometry::Position& pos, const geometry::Position camera_position) const
@@ -283,50 +151,70 @@ void SpriteManager::render_tile(const int sprite, const geometry::Position& pos,
   }
   const auto src_rect = get_rect_for_tile(sprite);
   const geometry::Rectangle dest_rect{pos.x() - camera_position.x(), pos.y() - camera_position.y(), SPRITE_W, SPRITE_H};
-  get_surface()->blit_surface(src_rect, dest_rect);
+  blit(get_surface(), {src_rect, dest_rect});
 }
 
 const Surface* SpriteManager::get_char_surface() const
 {
-  return char_surface_.get();
+  return atlas_surfaces_[char_region_.page].get();
 }
 
 geometry::Rectangle SpriteManager::get_rect_for_char(const wchar_t ch) const
 {
-  int idx = char_map.find(L' ')->second;
-  if (auto search = char_map.find(ch); search != char_map.end())
+  return get_rect_for_icon(get_char_index(ch));
+}
+
+geometry::Position SpriteManager::render_text(const std::wstring& text, const geometry::Position& pos, const Color tint) const
+{
+  const auto& shaped = shape_text(text, tint);
+  begin_batch();
+  for (const auto& quad : shaped.quads)
   {
-    idx = search->second;
+    blit(get_char_surface(), {quad.source, quad.dest + pos, quad.flip, quad.color});
   }
-  return get_rect_for_icon(idx);
+  end_batch();
+  return pos + shaped.end;
 }
 
-geometry::Position SpriteManager::render_text(const std::wstring& text, const geometry::Position& pos, const Color tint) const
+const SpriteManager::ShapedText& SpriteManager::shape_text(const std::wstring& text, const Color tint) const
 {
-  int x = pos.x();
-  int y = pos.y();
+  const TextKey key{text, tint.red, tint.green, tint.blue};
+  if (auto search = text_cache_.find(key); search != text_cache_.end())
+  {
+    return search->second;
+  }
+  if (text_cache_.size() >= TEXT_CACHE_SIZE)
+  {
+    // Mostly text that changes every frame, e.g. the FPS counter, so start over instead of tracking use
+    text_cache_.clear();
+  }
+
+  ShapedText shaped;
+  int x = 0;
+  int y = 0;
   for (const auto& ch : text)
   {
     if (ch == L'\n')
     {
-      x = pos.x();
+      x = 0;
       y += CHAR_H;
     }
     else
     {
       const auto src_rect = get_rect_for_char(ch);
       const geometry::Rectangle dest_rect{x, y, CHAR_W, CHAR_H};
-      get_char_surface()->blit_surface(src_rect, dest_rect, false, tint);
+      shaped.quads.push_back({src_rect, dest_rect, false, tint});
       x += CHAR_W;
     }
   }
-  return Vector<int>(x, y);
+  shaped.end = geometry::Position(x, y);
+  return text_cache_.emplace(key, std::move(shaped)).first->second;
 }
 
 void SpriteManager::render_cones(const geometry::Position& pos, const geometry::Position camera_position) const
 {
   const geometry::Rectangle dest_rect{pos.x() - camera_position.x(), pos.y() - camera_position.y(), SPRITE_W, SPRITE_H};
-  cones_surface_->blit_surface({0, 0, SPRITE_W, SPRITE_H}, dest_rect);
+  blit(atlas_surfaces_[cones_region_.page].get(), {{cones_region_.rect.position, SPRITE_W, SPRITE_H}, dest_rect});
 }
 
 geometry::Rectangle SpriteManager::get_rect_for_number(const char ch) const
@@ -339,25 +227,66 @@ geometry::Position SpriteManager::render_number(const int num, const geometry::P
   const auto text = std::to_string(num);
   // Numbers are right-aligned
   int x = pos.x() - CHAR_W;
+  begin_batch();
   // Iterate in reverse due to right align
   for (auto it = text.crbegin(); it != text.crend(); ++it)
   {
     const auto src_rect = get_rect_for_number(*it);
     const geometry::Rectangle dest_rect{x, pos.y(), CHAR_W, CHAR_H};
-    get_char_surface()->blit_surface(src_rect, dest_rect);
+    blit(get_char_surface(), {src_rect, dest_rect});
     x -= CHAR_W;
   }
+  end_batch();
   return Vector<int>(x, pos.y());
 }
 
 geometry::Rectangle SpriteManager::get_rect_for_icon(const int idx) const
 {
-  return {(idx % (char_surface_->width() / CHAR_W)) * CHAR_W, (idx / (char_surface_->width() / CHAR_H)) * CHAR_H, CHAR_W, CHAR_H};
+  const auto stride = char_region_.rect.size.x() / CHAR_W;
+  return geometry::Rectangle((idx % stride) * CHAR_W, (idx / stride) * CHAR_H, CHAR_W, CHAR_H) + char_region_.rect.position;
 }
 
 void SpriteManager::render_icon(const Icon icon, const geometry::Position& pos, const bool flip, const Color tint) const
 {
   const auto src_rect = get_rect_for_icon(static_cast<int>(icon));
   const geometry::Rectangle dest_rect{pos.x(), pos.y(), CHAR_W, CHAR_H};
-  get_char_surface()->blit_surface(src_rect, dest_rect, flip, tint);
+  blit(get_char_surface(), {src_rect, dest_rect, flip, tint});
+}
+
+void SpriteManager::begin_batch() const
+{
+  batch_depth_++;
+}
+
+void SpriteManager::end_batch() const
+{
+  if (--batch_depth_ == 0)
+  {
+    flush_batch();
+  }
+}
+
+void SpriteManager::blit(const Surface* surface, const BlitQuad& quad) const
+{
+  if (batch_depth_ == 0)
+  {
+    surface->blit_surface(quad.source, quad.dest, quad.flip, quad.color);
+    return;
+  }
+  if (surface != batch_surface_)
+  {
+    flush_batch();
+    batch_surface_ = surface;
+  }
+  batch_.push_back(quad);
+}
+
+void SpriteManager::flush_batch() const
+{
+  if (!batch_.empty())
+  {
+    batch_surface_->blit_batch(batch_.data(), batch_.size());
+    batch_.clear();
+  }
+  batch_surface_ = nullptr;
 }
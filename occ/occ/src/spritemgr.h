@@ -1,8 +1,14 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
+#include "atlas.h"
 #include "geometry.h"
 #include "graphics.h"
 
@@ -44,13 +50,34 @@ enum class Icon : int
 class SpriteManager
 {
  public:
-  SpriteManager() : sprite_surface_(), char_surface_(), cones_surface_() {}
+  SpriteManager()
+    : atlas_(),
+      atlas_surfaces_(),
+      sprite_region_(),
+      char_region_(),
+      cones_region_(),
+      text_cache_(),
+      batch_(),
+      batch_surface_(nullptr),
+      batch_depth_(0)
+  {
+  }
 
+  // Same as decode_tilesets followed by upload_tilesets
   bool load_tilesets(Window& window, const int episode);
+  // Decodes the sprites, font and cones and packs them into an atlas, does not use the window so it can be
+  // called on any thread
+  bool decode_tilesets(const int episode);
+  // Creates surfaces from the atlas, must be called on the thread that renders to the window
+  bool upload_tilesets(Window& window);
+
+  // The sprites, font and cones share atlas surfaces, so all rects are in atlas coordinates
   const Surface* get_surface() const;
+  geometry::Rectangle get_sprite_sheet_rect() const { return sprite_region_.rect; }
   geometry::Rectangle get_rect_for_tile(const int sprite) const;
   void render_tile(const int sprite, const geometry::Position& pos, const geometry::Position camera_position = {0, 0}) const;
   const Surface* get_char_surface() const;
+  geometry::Rectangle get_char_sheet_rect() const { return char_region_.rect; }
   geometry::Rectangle get_rect_for_char(const wchar_t ch) const;
   geometry::Position render_text(const std::wstring& text, const geometry::Position& pos, const Color tint = {0xff, 0xff, 0xff}) const;
   geometry::Rectangle get_rect_for_number(const char ch) const;
@@ -59,8 +86,55 @@ class SpriteManager
   void render_icon(const Icon icon, const geometry::Position& pos, const bool flip = false, const Color tint = {0xff, 0xff, 0xff}) const;
   void render_cones(const geometry::Position& pos, const geometry::Position camera_position = {0, 0}) const;
 
+  // While a batch is open tiles, text and icons are queued and then rendered with a single Surface::blit_batch
+  // per surface when the batch ends or when the next sprite is on another surface. Batches can be nested.
+  // Sprites in a batch with different tints must not overlap, and anything rendered in other ways while a
+  // batch is open ends up behind the queued sprites.
+  void begin_batch() const;
+  void end_batch() const;
+
  private:
-  std::unique_ptr<Surface> sprite_surface_;
-  std::unique_ptr<Surface> char_surface_;
-  std::unique_ptr<Surface> cones_surface_;
+  // Quads of the characters of a string relative to where it is rendered, and where the next character would go
+  struct ShapedText
+  {
+    std::vector<BlitQuad> quads;
+    geometry::Position end;
+  };
+
+  struct TextKey
+  {
+    std::wstring text;
+    std::uint8_t red;
+    std::uint8_t green;
+    std::uint8_t blue;
+
+    bool operator==(const TextKey& other) const
+    {
+      return text == other.text && red == other.red && green == other.green && blue == other.blue;
+    }
+  };
+
+  struct TextKeyHash
+  {
+    std::size_t operator()(const TextKey& key) const
+    {
+      return std::hash<std::wstring>()(key.text) ^ ((key.red << 16) | (key.green << 8) | key.blue);
+    }
+  };
+
+  const ShapedText& shape_text(const std::wstring& text, const Color tint) const;
+  void blit(const Surface* surface, const BlitQuad& quad) const;
+  void flush_batch() const;
+
+  // The pixels of the atlas are freed once they are uploaded
+  Atlas atlas_;
+  std::vector<std::unique_ptr<Surface>> atlas_surfaces_;
+  Atlas::Region sprite_region_;
+  Atlas::Region char_region_;
+  Atlas::Region cones_region_;
+
+  mutable std::unordered_map<TextKey, ShapedText, TextKeyHash> text_cache_;
+  mutable std::vector<BlitQuad> batch_;
+  mutable const Surface* batch_surface_;
+  mutable int batch_depth_;
 };
@@ -12,6 +12,18 @@
 
 static constexpr int FADE_TICKS = 15;
 
+// Logs the draw calls made by GameRenderer::render_game while playing a level
+static void log_draw_call_stats(const GameRenderer::DrawCallStats& stats)
+{
+  if (stats.num_frames > 0u)
+  {
+    LOG_INFO("Rendered %u frames with %.1f draw calls per frame on average, at most %u",
+             stats.num_frames,
+             static_cast<double>(stats.total) / stats.num_frames,
+             stats.max);
+  }
+}
+
 const std::vector<Panel> makeInstructionsPanels(const ExeData& exe_data)
 {
   return {{
@@ -133,12 +145,26 @@ void SkipState::update(const Input& input)
   }
 }
 
-SplashState::SplashState(std::vector<Surface*>& images, Window& window) : State(FADE_TICKS, 0, window), images_(images) {}
+SplashState::SplashState(ImageManager& image_manager, const size_t episode, Window& window)
+  : State(FADE_TICKS, 0, window),
+    image_manager_(image_manager),
+    episode_(episode)
+{
+}
+
+void SplashState::prefetch()
+{
+  image_manager_.prefetch(episode_, CCImage::IMAGE_APOGEE);
+}
 
 void SplashState::draw(Window& window) const
 {
-  images_[0]->blit_surface(geometry::Rectangle(0, 0, images_[0]->size()),
-                           geometry::Rectangle((WINDOW_SIZE - CAMERA_SIZE_SCALED) / 2, CAMERA_SIZE_SCALED));
+  const auto images = image_manager_.get_images(episode_, CCImage::IMAGE_APOGEE);
+  if (!images.empty())
+  {
+    images[0]->blit_surface(geometry::Rectangle(0, 0, images[0]->size()),
+                            geometry::Rectangle((WINDOW_SIZE - CAMERA_SIZE_SCALED) / 2, CAMERA_SIZE_SCALED));
+  }
   State::draw(window);
 }
 
@@ -152,13 +178,15 @@ void SplashState::draw(Window& window) const
 
 TitleState::TitleState(SpriteManager& sprite_manager,
                        Surface& game_surface,
-                       std::vector<Surface*>& images,
+                       ImageManager& image_manager,
+                       const size_t episode,
                        Window& window,
                        ExeData& exe_data)
   : State(FADE_TICKS, FADE_TICKS, window),
     sprite_manager_(sprite_manager),
     game_surface_(game_surface),
-    images_(images),
+    image_manager_(image_manager),
+    episode_(episode),
     panel_(
       // TODO: add options menu here
       {
@@ -194,6 +222,12 @@ TitleState::TitleState(SpriteManager& sprite_manager,
 {
 }
 
+void TitleState::prefetch()
+{
+  image_manager_.prefetch(episode_, CCImage::IMAGE_TITLE);
+  image_manager_.prefetch(episode_, CCImage::IMAGE_CREDITS);
+}
+
 void TitleState::update(const Input& input)
 {
   State::update(input);
@@ -247,18 +281,25 @@ void TitleState::draw(Window& window) const
   constexpr unsigned last_ticks = 50;
   const auto period_ticks = first_ticks + scroll_ticks * 2 + last_ticks;
   const auto ticks = scroll_ticks_ % period_ticks;
-  if (ticks < first_ticks)
+  auto images = image_manager_.get_images(episode_, CCImage::IMAGE_TITLE);
+  const auto credits_images = image_manager_.get_images(episode_, CCImage::IMAGE_CREDITS);
+  images.insert(images.end(), credits_images.begin(), credits_images.end());
+  if (images.empty())
+  {
+    // Images that could not be decoded are skipped, so there may be nothing to show
+  }
+  else if (ticks < first_ticks)
   {
     // Show first image
-    images_[0]->blit_surface(geometry::Rectangle(0, 0, images_[0]->size()),
-                             geometry::Rectangle((WINDOW_SIZE - CAMERA_SIZE_SCALED) / 2, CAMERA_SIZE_SCALED));
+    images[0]->blit_surface(geometry::Rectangle(0, 0, images[0]->size()),
+                            geometry::Rectangle((WINDOW_SIZE - CAMERA_SIZE_SCALED) / 2, CAMERA_SIZE_SCALED));
   }
   else if (ticks < first_ticks + scroll_ticks)
   {
     // Show scrolling from first image to last
     const auto scroll = (float)(ticks - first_ticks) / scroll_ticks * CAMERA_SIZE_SCALED.y();
     auto y = -(int)scroll;
-    for (auto& image : images_)
+    for (auto& image : images)
     {
       image->blit_surface(geometry::Rectangle(0, 0, image->size()), geometry::Rectangle(0, y, CAMERA_SIZE_SCALED));
       y += CAMERA_SIZE_SCALED.y();
@@ -267,15 +308,15 @@ void TitleState::draw(Window& window) const
   else if (ticks < first_ticks + scroll_ticks + last_ticks)
   {
     // Show last image
-    images_.back()->blit_surface(geometry::Rectangle(0, 0, images_.back()->size()),
-                                 geometry::Rectangle((WINDOW_SIZE - CAMERA_SIZE_SCALED) / 2, CAMERA_SIZE_SCALED));
+    images.back()->blit_surface(geometry::Rectangle(0, 0, images.back()->size()),
+                                geometry::Rectangle((WINDOW_SIZE - CAMERA_SIZE_SCALED) / 2, CAMERA_SIZE_SCALED));
   }
   else
   {
     // Show scrolling from last image to first
     const auto scroll = (1 - (float)(ticks - first_ticks - scroll_ticks - last_ticks) / scroll_ticks) * CAMERA_SIZE_SCALED.y();
     auto y = -(int)scroll;
-    for (auto& image : images_)
+    for (auto& image : images)
     {
       image->blit_surface(geometry::Rectangle(0, 0, image->size()), geometry::Rectangle(0, y, CAMERA_SIZE_SCALED));
       y += CAMERA_SIZE_SCALED.y();
@@ -332,8 +373,26 @@ GameState::GameState(Game& game, SpriteManager& sprite_manager, Surface& game_su
             {4, {PanelType::PANEL_TYPE_QUIT_TO_MAIN_LEVEL}},
           }}},
       }),
-    warp_panel_({PanelText::PANEL_TEXT_WARP, exe_data, {}, {}, PanelType::PANEL_TYPE_WARP_TO_LEVEL})
+    warp_panel_({PanelText::PANEL_TEXT_WARP, exe_data, {}, {}, PanelType::PANEL_TYPE_WARP_TO_LEVEL}),
+    rewind_(REWIND_BUFFER_SIZE, REWIND_TICKS, REWIND_KEYFRAME_INTERVAL)
 {
+  game_.set_activity_area(CAMERA_SIZE, ACTIVITY_RADIUS);
+  game_.set_prefetch_distance(LEVEL_PREFETCH_DISTANCE);
+}
+
+GameState::~GameState()
+{
+  log_draw_call_stats(game_renderer_.get_draw_call_stats());
+  if (demo_ && demo_->save(demo_path_))
+  {
+    LOG_INFO("Recorded %u ticks to demo '%s'", demo_->get_num_ticks(), demo_path_.string().c_str());
+  }
+}
+
+void GameState::record_demo(const std::filesystem::path& path)
+{
+  demo_ = std::make_unique<Demo>(game_.get_seed(), CAMERA_SIZE, ACTIVITY_RADIUS);
+  demo_path_ = path;
 }
 
 void GameState::reset()
@@ -342,11 +401,19 @@ void GameState::reset()
   paused_ = false;
   panel_current_ = nullptr;
   panel_next_ = nullptr;
+  // The renderer is reset for the new level below
+  log_draw_call_stats(game_renderer_.get_draw_call_stats());
   if (!game_.init(exe_data_, level_))
   {
     LOG_CRITICAL("Could not initialize Game level %d", static_cast<int>(level_));
     finish();
   }
+  else if (demo_)
+  {
+    demo_->start_level(level_, game_tick_);
+  }
+  rewind_.clear();
+  game_renderer_.reset();
 }
 
 void GameState::update(const Input& input)
@@ -481,10 +548,24 @@ void GameState::update(const Input& input)
       paused_ = !paused_;
     }
 
-    if (!paused_ || (paused_ && input.space.pressed()))
+    // Demos can only be replayed forwards, so there is no rewinding while recording one
+    if (input.backspace.down && !demo_)
+    {
+      if (rewind_.step_back(game_))
+      {
+        game_tick_ -= 1;
+      }
+    }
+    else if (!paused_ || (paused_ && input.space.pressed()))
     {
       // Call game loop
-      game_.update(game_tick_, input_to_player_input(input));
+      const auto player_input = input_to_player_input(input);
+      if (demo_)
+      {
+        demo_->add(player_input);
+      }
+      game_.update(game_tick_, player_input);
+      rewind_.capture(game_);
       game_tick_ += 1;
     }
     game_renderer_.update(game_tick_);
@@ -530,8 +611,8 @@ void GameState::draw(Window& window) const
     }
 
     // Put a black box where we're going to the draw the debug text
-    // 20 pixels per line (1 line + Game's lines)
-    window.fill_rect({0, 24, 200, 20 + (20 * static_cast<int>(game_debug_infos.size()))}, {0u, 0u, 0u});
+    // 20 pixels per line (3 lines + Game's lines)
+    window.fill_rect({0, 24, 200, 60 + (20 * static_cast<int>(game_debug_infos.size()))}, {0u, 0u, 0u});
 
     // Render debug text
     auto pos_y = 25;
@@ -540,6 +621,15 @@ void GameState::draw(Window& window) const
       L"camera position: (" + std::to_wstring(game_camera.position.x()) + L", " + std::to_wstring(game_camera.position.y()) + L")";
     sprite_manager_.render_text(camera_position_str, geometry::Position(5, pos_y));
     pos_y += 20;
+    const auto& draw_call_stats = game_renderer_.get_draw_call_stats();
+    const auto draw_calls_str = L"draw calls: " + std::to_wstring(game_renderer_.get_num_draw_calls()) + L", max " +
+                                std::to_wstring(draw_call_stats.max);
+    sprite_manager_.render_text(draw_calls_str, geometry::Position(5, pos_y));
+    pos_y += 20;
+    const auto rewind_str = L"rewind: " + std::to_wstring(rewind_.get_num_ticks() * MS_PER_UPDATE / 1000) + L" s, " +
+                            std::to_wstring(rewind_.get_bytes_used() / 1024) + L" KiB";
+    sprite_manager_.render_text(rewind_str, geometry::Position(5, pos_y));
+    pos_y += 20;
 
     for (const auto& game_debug_info : game_debug_infos)
     {
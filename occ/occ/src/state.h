@@ -3,11 +3,17 @@
 #include "event.h"
 #include "game_renderer.h"
 #include "graphics.h"
+#include "imagemgr.h"
 #include "sdl_wrapper.h"
 #include "spritemgr.h"
 
+#include "demo.h"
 #include "game.h"
 #include "panel.h"
+#include "rewind.h"
+
+#include <filesystem>
+#include <memory>
 
 /// Represents a game state (e.g. splash, title, game)
 /// Contains base logic for fading in/out
@@ -24,8 +30,15 @@ class State
   {
     ticks_ = 0;
     fade_out_start_ticks_ = 0;
+    if (next_state_)
+    {
+      next_state_->prefetch();
+    }
   }
 
+  // Called when the previous state is entered, to start loading what this state needs
+  virtual void prefetch() {}
+
   virtual void update(const Input& input);
 
   // Called whenever state should start finishing
@@ -66,24 +79,32 @@ class SplashState : public SkipState
 {
  public:
   // TODO: play sound when entering this state
-  SplashState(std::vector<Surface*>& images, Window& window);
+  SplashState(ImageManager& image_manager, const size_t episode, Window& window);
 
+  virtual void prefetch() override;
   virtual void draw(Window& window) const override;
 
  private:
-  std::vector<Surface*>& images_;
+  ImageManager& image_manager_;
+  size_t episode_;
 };
 
 class TitleState : public State
 {
  public:
-  TitleState(SpriteManager& sprite_manager, Surface& game_surface, std::vector<Surface*>& images, Window& window, ExeData& exe_data);
+  TitleState(SpriteManager& sprite_manager,
+             Surface& game_surface,
+             ImageManager& image_manager,
+             const size_t episode,
+             Window& window,
+             ExeData& exe_data);
 
   virtual void reset() override
   {
     panel_current_ = nullptr;
     State::reset();
   }
+  virtual void prefetch() override;
   virtual void update(const Input& input) override;
   virtual void draw(Window& window) const override;
   virtual State* next_state() override
@@ -98,7 +119,8 @@ class TitleState : public State
  private:
   SpriteManager& sprite_manager_;
   Surface& game_surface_;
-  std::vector<Surface*>& images_;
+  ImageManager& image_manager_;
+  size_t episode_;
   unsigned scroll_ticks_ = 0;
   Panel panel_;
   Panel* panel_current_ = nullptr;
@@ -108,6 +130,10 @@ class GameState : public State
 {
  public:
   GameState(Game& game, SpriteManager& sprite_manager, Surface& game_surface, Window& window, ExeData& exe_data);
+  ~GameState() override;
+
+  // Records all levels played from now on to a demo file at path, which is written when the game state is destroyed
+  void record_demo(const std::filesystem::path& path);
 
   virtual void reset() override;
   virtual void update(const Input& input) override;
@@ -128,6 +154,10 @@ class GameState : public State
   Panel warp_panel_;
   Panel* panel_current_ = nullptr;
   Panel* panel_next_ = nullptr;
+  std::unique_ptr<Demo> demo_;
+  std::filesystem::path demo_path_;
+  // Holding backspace steps the game backwards
+  Rewind rewind_;
 };
 
 // TODO: end state
@@ -1,8 +1,16 @@
 ﻿#pragma once
 
-#include <map>
+#include <array>
+#include <cstddef>
 
-const std::map<wchar_t, int> char_map{
+struct CharIndex
+{
+  wchar_t ch;
+  int index;
+};
+
+// Index of each character in the font sheet
+constexpr CharIndex char_indices[]{
   {' ', 10}, {'!', 11}, {'"', 12}, {'#', 13},  {'$', 14}, {'%', 15}, {'&', 16}, {'@', 17}, {'(', 18}, {')', 19}, {'*', 20}, {'+', 21},
   {',', 22}, {'-', 23}, {'.', 24}, {L'£', 25}, {'0', 26}, {'1', 27}, {'2', 28}, {'3', 29}, {'4', 30}, {'5', 31}, {'6', 32}, {'7', 33},
   {'8', 34}, {'9', 35}, {':', 36}, {'?', 41},  {'A', 43}, {'B', 44}, {'C', 45}, {'D', 46}, {'E', 47}, {'F', 48}, {'G', 49}, {'H', 50},
@@ -11,3 +19,35 @@ const std::map<wchar_t, int> char_map{
   {'g', 75}, {'h', 76}, {'i', 77}, {'j', 78},  {'k', 79}, {'l', 80}, {'m', 81}, {'n', 82}, {'o', 83}, {'p', 84}, {'q', 85}, {'r', 86},
   {'s', 87}, {'t', 88}, {'u', 89}, {'v', 90},  {'w', 91}, {'x', 92}, {'y', 93}, {'z', 94},
 };
+
+// Dense table of char_indices, generated at compile time so that looking up a character is a single load
+// Characters that are not in the font are drawn as spaces
+constexpr std::array<int, 256> make_char_table()
+{
+  std::array<int, 256> table{};
+  for (auto& index : table)
+  {
+    index = -1;
+  }
+  for (const auto& char_index : char_indices)
+  {
+    table[static_cast<std::size_t>(char_index.ch)] = char_index.index;
+  }
+  const auto space = table[static_cast<std::size_t>(L' ')];
+  for (auto& index : table)
+  {
+    if (index == -1)
+    {
+      index = space;
+    }
+  }
+  return table;
+}
+
+constexpr auto char_table = make_char_table();
+
+constexpr int get_char_index(const wchar_t ch)
+{
+  const auto i = static_cast<std::size_t>(ch);
+  return i < char_table.size() ? char_table[i] : char_table[static_cast<std::size_t>(L' ')];
+}
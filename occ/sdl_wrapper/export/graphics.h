@@ -1,8 +1,10 @@
 #pragma once
 
+#include <cstddef>
 #include <filesystem>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "geometry.h"
 
@@ -30,6 +32,9 @@ class Window
   virtual void fill_rect(const geometry::Rectangle& rect, const Color& color) = 0;
   virtual void render_line(const geometry::Position& from, const geometry::Position& to, const Color& color) = 0;
   virtual void render_rectangle(const geometry::Rectangle& rect, const Color& color) = 0;
+
+  // Returns the total number of draw calls (fills, lines and blits) made to this window's renderer
+  virtual unsigned get_num_draw_calls() const = 0;
 };
 
 enum class BlitType
@@ -38,6 +43,25 @@ enum class BlitType
   SCALE
 };
 
+struct BlitQuad
+{
+  geometry::Rectangle source;
+  geometry::Rectangle dest;
+  bool flip = false;
+  Color color = {0xff, 0xff, 0xff};
+};
+
+// Decoded ARGB8888 pixels of an image file
+// Decoding does not use the renderer, so unlike creating a Surface it can be done on any thread
+struct Pixels
+{
+  static std::unique_ptr<Pixels> from_image(const std::filesystem::path& filename);
+
+  int width = 0;
+  int height = 0;
+  std::vector<uint32_t> data;
+};
+
 class Surface
 {
  public:
@@ -54,4 +78,8 @@ class Surface
 
 	virtual void blit_surface(const geometry::Rectangle& source, const geometry::Rectangle& dest, const bool flip = false, const Color color = {0xff, 0xff, 0xff}) const = 0;
   virtual void blit_surface() const = 0;
+  // Blits all quads with as few draw calls and state changes as possible
+  // Quads with the same color are drawn in order, but quads with different colors may be reordered
+  // so they should not overlap each other
+  virtual void blit_batch(const BlitQuad* quads, const std::size_t count) const = 0;
 };
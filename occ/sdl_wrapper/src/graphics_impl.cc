@@ -3,6 +3,8 @@
 #include <algorithm>
 #include <cassert>
 #include <cstdlib>
+#include <mutex>
+#include <tuple>
 #include <utility>
 
 #include "logger.h"
@@ -70,7 +72,7 @@ std::unique_ptr<Surface> WindowImpl::create_target_surface(geometry::Size size)
     LOG_CRITICAL("Could not get texture: %s", SDL_GetError());
     return std::unique_ptr<Surface>();
   }
-  return std::make_unique<SurfaceImpl>(size.x(), size.y(), std::move(sdl_texture), *sdl_renderer_.get());
+  return std::make_unique<SurfaceImpl>(size.x(), size.y(), std::move(sdl_texture), *this);
 }
 
 void WindowImpl::refresh()
@@ -84,6 +86,7 @@ void WindowImpl::fill_rect(const geometry::Rectangle& rect, const Color& color)
   // TODO: check error
   SDL_SetRenderDrawColor(sdl_renderer_.get(), color.red, color.green, color.blue, color.alpha);
   SDL_RenderFillRect(sdl_renderer_.get(), &sdl_rect);
+  count_draw_call();
 }
 
 void WindowImpl::render_rectangle(const geometry::Rectangle& rect, const Color& color)
@@ -115,6 +118,7 @@ void WindowImpl::render_line(const geometry::Position& from, const geometry::Pos
   // TODO: check error
   SDL_SetRenderDrawColor(sdl_renderer_.get(), color.red, color.green, color.blue, 0xff);
   SDL_RenderDrawLine(sdl_renderer_.get(), from.x(), from.y(), to.x(), to.y());
+  count_draw_call();
 }
 
 std::unique_ptr<Surface> create_surface(SDL_Surface* surface, Window& window)
@@ -125,15 +129,15 @@ std::unique_ptr<Surface> create_surface(SDL_Surface* surface, Window& window)
     LOG_CRITICAL("Could not load surface: %s", SDL_GetError());
     return std::unique_ptr<Surface>();
   }
-  auto sdl_renderer = static_cast<WindowImpl&>(window).get_renderer();
+  auto& window_impl = static_cast<WindowImpl&>(window);
   auto sdl_texture = std::unique_ptr<SDL_Texture, decltype(&SDL_DestroyTexture)>(
-    SDL_CreateTextureFromSurface(sdl_renderer, sdl_surface.get()), SDL_DestroyTexture);
+    SDL_CreateTextureFromSurface(window_impl.get_renderer(), sdl_surface.get()), SDL_DestroyTexture);
   if (!sdl_texture)
   {
     LOG_CRITICAL("Could not get texture: %s", SDL_GetError());
     return std::unique_ptr<Surface>();
   }
-  return std::make_unique<SurfaceImpl>(sdl_surface->w, sdl_surface->h, std::move(sdl_texture), *sdl_renderer);
+  return std::make_unique<SurfaceImpl>(sdl_surface->w, sdl_surface->h, std::move(sdl_texture), window_impl);
 }
 
 std::unique_ptr<Surface> Surface::from_bmp(const std::filesystem::path& filename, Window& window)
@@ -147,6 +151,41 @@ std::unique_ptr<Surface> Surface::from_image(const std::filesystem::path& filena
   return create_surface(sdl_surface, window);
 }
 
+std::unique_ptr<Pixels> Pixels::from_image(const std::filesystem::path& filename)
+{
+  // SDL_image loads the PNG library on first use, which is not thread safe
+  static std::once_flag png_init;
+  std::call_once(png_init, []() { IMG_Init(IMG_INIT_PNG); });
+
+  auto image = std::unique_ptr<SDL_Surface, decltype(&SDL_FreeSurface)>(IMG_Load(filename.string().c_str()), SDL_FreeSurface);
+  if (!image)
+  {
+    LOG_CRITICAL("Could not load image: %s", SDL_GetError());
+    return nullptr;
+  }
+  auto argb = std::unique_ptr<SDL_Surface, decltype(&SDL_FreeSurface)>(
+    SDL_ConvertSurfaceFormat(image.get(), SDL_PIXELFORMAT_ARGB8888, 0), SDL_FreeSurface);
+  if (!argb)
+  {
+    LOG_CRITICAL("Could not convert image: %s", SDL_GetError());
+    return nullptr;
+  }
+  auto pixels = std::make_unique<Pixels>();
+  pixels->width = argb->w;
+  pixels->height = argb->h;
+  pixels->data.resize(static_cast<std::size_t>(argb->w) * argb->h);
+  // TODO: check error
+  SDL_LockSurface(argb.get());
+  for (int y = 0; y < argb->h; y++)
+  {
+    memcpy(pixels->data.data() + static_cast<std::size_t>(y) * argb->w,
+           static_cast<const uint8_t*>(argb->pixels) + static_cast<std::size_t>(y) * argb->pitch,
+           argb->w * sizeof(uint32_t));
+  }
+  SDL_UnlockSurface(argb.get());
+  return pixels;
+}
+
 std::unique_ptr<Surface> Surface::from_pixels(const int w, const int h, const uint32_t* pixels, Window& window)
 {
   auto sdl_surface = SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, SDL_PIXELFORMAT_ARGB8888);
@@ -163,11 +202,13 @@ std::unique_ptr<Surface> Surface::from_pixels(const int w, const int h, const ui
 SurfaceImpl::SurfaceImpl(const int w,
                          const int h,
                          std::unique_ptr<SDL_Texture, decltype(&SDL_DestroyTexture)> sdl_texture,
-                         SDL_Renderer& sdl_renderer)
+                         WindowImpl& window)
   : w_(w),
     h_(h),
     sdl_texture_(std::move(sdl_texture)),
-    sdl_renderer_(sdl_renderer)
+    window_(window),
+    sdl_renderer_(*window.get_renderer()),
+    alpha_(0xffu)
 {
   if (SDL_SetTextureBlendMode(sdl_texture_.get(), SDL_BLENDMODE_BLEND) != 0)
   {
@@ -188,6 +229,7 @@ void SurfaceImpl::blit_surface(const geometry::Rectangle& source, const geometry
   {
 	  LOG_ERROR("Could not render texture: %s", SDL_GetError());
   }
+  window_.count_draw_call();
 	// reset tint
 	if (SDL_SetTextureColorMod(sdl_texture_.get(), 0xff, 0xff, 0xff) != 0)
 	{
@@ -199,6 +241,105 @@ void SurfaceImpl::blit_surface() const
 {
   // TODO: check error
   SDL_RenderCopy(&sdl_renderer_, sdl_texture_.get(), nullptr, nullptr);
+  window_.count_draw_call();
+}
+
+void SurfaceImpl::blit_batch(const BlitQuad* quads, const std::size_t count) const
+{
+  if (count == 0u)
+  {
+    return;
+  }
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+  if (window_.is_render_geometry_supported())
+  {
+    // Tint is applied per vertex, so the whole batch is a single draw call
+    batch_vertices_.clear();
+    batch_indices_.clear();
+    for (std::size_t i = 0; i < count; i++)
+    {
+      const auto& quad = quads[i];
+      const auto color = SDL_Color{quad.color.red, quad.color.green, quad.color.blue, alpha_};
+      auto u0 = static_cast<float>(quad.source.position.x()) / w_;
+      auto u1 = static_cast<float>(quad.source.position.x() + quad.source.size.x()) / w_;
+      const auto v0 = static_cast<float>(quad.source.position.y()) / h_;
+      const auto v1 = static_cast<float>(quad.source.position.y() + quad.source.size.y()) / h_;
+      if (quad.flip)
+      {
+        std::swap(u0, u1);
+      }
+      const auto x0 = static_cast<float>(quad.dest.position.x());
+      const auto x1 = static_cast<float>(quad.dest.position.x() + quad.dest.size.x());
+      const auto y0 = static_cast<float>(quad.dest.position.y());
+      const auto y1 = static_cast<float>(quad.dest.position.y() + quad.dest.size.y());
+
+      const auto first = static_cast<int>(batch_vertices_.size());
+      batch_vertices_.push_back({{x0, y0}, color, {u0, v0}});
+      batch_vertices_.push_back({{x1, y0}, color, {u1, v0}});
+      batch_vertices_.push_back({{x1, y1}, color, {u1, v1}});
+      batch_vertices_.push_back({{x0, y1}, color, {u0, v1}});
+      for (const auto index : {0, 1, 2, 0, 2, 3})
+      {
+        batch_indices_.push_back(first + index);
+      }
+    }
+    if (SDL_RenderGeometry(&sdl_renderer_,
+                           sdl_texture_.get(),
+                           batch_vertices_.data(),
+                           static_cast<int>(batch_vertices_.size()),
+                           batch_indices_.data(),
+                           static_cast<int>(batch_indices_.size())) == 0)
+    {
+      window_.count_draw_call();
+      return;
+    }
+    // Not supported by all renderers, fall back to one copy per quad from now on
+    LOG_DEBUG("Could not render geometry: %s", SDL_GetError());
+    window_.set_render_geometry_unsupported();
+  }
+#endif
+
+  // Sort by color so that the color mod only changes once per color
+  batch_quads_.clear();
+  for (std::size_t i = 0; i < count; i++)
+  {
+    batch_quads_.push_back(&quads[i]);
+  }
+  std::stable_sort(batch_quads_.begin(),
+                   batch_quads_.end(),
+                   [](const BlitQuad* a, const BlitQuad* b)
+                   {
+                     return std::tie(a->color.red, a->color.green, a->color.blue) <
+                            std::tie(b->color.red, b->color.green, b->color.blue);
+                   });
+
+  const Color* current_color = nullptr;
+  for (const auto* quad : batch_quads_)
+  {
+    if (!current_color || quad->color.red != current_color->red || quad->color.green != current_color->green ||
+        quad->color.blue != current_color->blue)
+    {
+      current_color = &quad->color;
+      if (SDL_SetTextureColorMod(sdl_texture_.get(), current_color->red, current_color->green, current_color->blue) != 0)
+      {
+        LOG_ERROR("Could not set texture color mod: %s", SDL_GetError());
+      }
+    }
+    const auto src_rect = to_sdl_rect(quad->source);
+    const auto dest_rect = to_sdl_rect(quad->dest);
+    const SDL_RendererFlip sdl_flip = quad->flip ? SDL_FLIP_HORIZONTAL : SDL_FLIP_NONE;
+    if (SDL_RenderCopyEx(&sdl_renderer_, sdl_texture_.get(), &src_rect, &dest_rect, 0.0, nullptr, sdl_flip) != 0)
+    {
+      LOG_ERROR("Could not render texture: %s", SDL_GetError());
+    }
+    window_.count_draw_call();
+  }
+  // reset tint
+  if (SDL_SetTextureColorMod(sdl_texture_.get(), 0xff, 0xff, 0xff) != 0)
+  {
+    LOG_ERROR("Could not reset texture color mod: %s", SDL_GetError());
+  }
 }
 
 void SurfaceImpl::set_render_target()
@@ -208,5 +349,6 @@ void SurfaceImpl::set_render_target()
 
 void SurfaceImpl::set_alpha(const uint8_t alpha)
 {
+  alpha_ = alpha;
   SDL_SetTextureAlphaMod(sdl_texture_.get(), alpha);
 }
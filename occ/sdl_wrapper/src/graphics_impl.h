@@ -4,6 +4,7 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include <SDL.h>
 #include <SDL_image.h>
@@ -16,7 +17,9 @@ class WindowImpl : public Window
   WindowImpl(std::unique_ptr<SDL_Window, decltype(&SDL_DestroyWindow)> sdl_window,
              std::unique_ptr<SDL_Renderer, decltype(&SDL_DestroyRenderer)> sdl_renderer)
     : sdl_window_(std::move(sdl_window)),
-      sdl_renderer_(std::move(sdl_renderer))
+      sdl_renderer_(std::move(sdl_renderer)),
+      num_draw_calls_(0u),
+      render_geometry_supported_(true)
   {
   }
 
@@ -27,12 +30,20 @@ class WindowImpl : public Window
   void fill_rect(const geometry::Rectangle& rect, const Color& color) override;
   void render_line(const geometry::Position& from, const geometry::Position& to, const Color& color) override;
   void render_rectangle(const geometry::Rectangle& rect, const Color& color) override;
+  unsigned get_num_draw_calls() const override { return num_draw_calls_; }
 
   SDL_Renderer* get_renderer() const { return sdl_renderer_.get(); }
+  void count_draw_call() { num_draw_calls_++; }
+
+  // Set once SDL_RenderGeometry has failed, so that batches go straight to the fallback
+  bool is_render_geometry_supported() const { return render_geometry_supported_; }
+  void set_render_geometry_unsupported() { render_geometry_supported_ = false; }
 
  private:
   std::unique_ptr<SDL_Window, decltype(&SDL_DestroyWindow)> sdl_window_;
   std::unique_ptr<SDL_Renderer, decltype(&SDL_DestroyRenderer)> sdl_renderer_;
+  unsigned num_draw_calls_;
+  bool render_geometry_supported_;
 };
 
 class SurfaceImpl : public Surface
@@ -41,13 +52,14 @@ class SurfaceImpl : public Surface
   SurfaceImpl(const int w,
               const int h,
               std::unique_ptr<SDL_Texture, decltype(&SDL_DestroyTexture)> sdl_texture,
-              SDL_Renderer& sdl_renderer);
+              WindowImpl& window);
 
   int width() const override { return w_; }
   int height() const override { return h_; }
 
 	void blit_surface(const geometry::Rectangle& source, const geometry::Rectangle& dest, const bool flip = false, const Color color = {0xff, 0xff, 0xff}) const override;
   void blit_surface() const override;
+  void blit_batch(const BlitQuad* quads, const std::size_t count) const override;
   void set_render_target();
   void set_alpha(const uint8_t alpha) override;
 
@@ -55,5 +67,14 @@ class SurfaceImpl : public Surface
   int w_;
   int h_;
   std::unique_ptr<SDL_Texture, decltype(&SDL_DestroyTexture)> sdl_texture_;
+  WindowImpl& window_;
   SDL_Renderer& sdl_renderer_;
+  uint8_t alpha_;
+
+  // Reused by blit_batch to avoid allocating each frame
+  mutable std::vector<const BlitQuad*> batch_quads_;
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+  mutable std::vector<SDL_Vertex> batch_vertices_;
+  mutable std::vector<int> batch_indices_;
+#endif
 };
@@ -1,10 +1,13 @@
 #include <gtest/gtest.h>
 
+#include <iterator>
+
 #include "geometry.h"
 #include "graphics.h"
 #include "sdl_stub.h"
 
 using ::testing::_;
+using ::testing::Mock;
 using ::testing::Return;
 using ::testing::StrEq;
 
@@ -14,6 +17,9 @@ struct SDL_Window
 struct SDL_Renderer
 {
 };
+struct SDL_Texture
+{
+};
 
 class GraphicsTest : public ::testing::Test
 {
@@ -86,3 +92,100 @@ TEST_F(GraphicsTest, surface_fill_rect)
   EXPECT_CALL(SDLStub::get(), SDL_DestroyRenderer(&sdl_renderer));
   window.reset();
 }
+
+TEST_F(GraphicsTest, window_num_draw_calls)
+{
+  SDL_Window sdl_window;
+  EXPECT_CALL(SDLStub::get(), SDL_CreateWindow(_, _, _, _, _, _)).WillOnce(Return(&sdl_window));
+  SDL_Renderer sdl_renderer;
+  EXPECT_CALL(SDLStub::get(), SDL_CreateRenderer(_, _, _)).WillOnce(Return(&sdl_renderer));
+  auto window = Window::create("test", geometry::Size(100, 100), "");
+  EXPECT_EQ(0u, window->get_num_draw_calls());
+
+  EXPECT_CALL(SDLStub::get(), SDL_SetRenderDrawColor(&sdl_renderer, _, _, _, _)).Times(2);
+  EXPECT_CALL(SDLStub::get(), SDL_RenderFillRect(&sdl_renderer, _));
+  EXPECT_CALL(SDLStub::get(), SDL_RenderDrawLine(&sdl_renderer, _, _, _, _));
+  window->fill_rect(geometry::Rectangle(0, 0, 100, 100), {255u, 255u, 255u});
+  window->render_line(geometry::Position(0, 0), geometry::Position(10, 10), {255u, 255u, 255u});
+  EXPECT_EQ(2u, window->get_num_draw_calls());
+
+  EXPECT_CALL(SDLStub::get(), SDL_DestroyWindow(&sdl_window));
+  EXPECT_CALL(SDLStub::get(), SDL_DestroyRenderer(&sdl_renderer));
+  window.reset();
+}
+
+TEST_F(GraphicsTest, surface_blit_batch)
+{
+  SDL_Window sdl_window;
+  EXPECT_CALL(SDLStub::get(), SDL_CreateWindow(_, _, _, _, _, _)).WillOnce(Return(&sdl_window));
+  SDL_Renderer sdl_renderer;
+  EXPECT_CALL(SDLStub::get(), SDL_CreateRenderer(_, _, _)).WillOnce(Return(&sdl_renderer));
+  auto window = Window::create("test", geometry::Size(100, 100), "");
+
+  SDL_Texture sdl_texture;
+  EXPECT_CALL(SDLStub::get(), SDL_CreateTexture(&sdl_renderer, _, _, 64, 32)).WillOnce(Return(&sdl_texture));
+  EXPECT_CALL(SDLStub::get(), SDL_SetTextureBlendMode(&sdl_texture, _)).WillOnce(Return(0));
+  auto surface = window->create_target_surface(geometry::Size(64, 32));
+
+  // All quads, regardless of tint, are submitted in one call
+  const BlitQuad quads[] = {
+    {geometry::Rectangle(0, 0, 16, 16), geometry::Rectangle(0, 0, 16, 16)},
+    {geometry::Rectangle(16, 0, 16, 16), geometry::Rectangle(16, 0, 16, 16), true},
+    {geometry::Rectangle(32, 16, 16, 16), geometry::Rectangle(32, 0, 16, 16), false, {0xff, 0xff, 0x00}},
+  };
+  EXPECT_CALL(SDLStub::get(), SDL_RenderGeometry(&sdl_renderer, &sdl_texture, _, 12, _, 18)).WillOnce(Return(0));
+  surface->blit_batch(quads, std::size(quads));
+  EXPECT_EQ(1u, window->get_num_draw_calls());
+
+  EXPECT_CALL(SDLStub::get(), SDL_DestroyTexture(&sdl_texture));
+  surface.reset();
+  EXPECT_CALL(SDLStub::get(), SDL_DestroyWindow(&sdl_window));
+  EXPECT_CALL(SDLStub::get(), SDL_DestroyRenderer(&sdl_renderer));
+  window.reset();
+}
+
+TEST_F(GraphicsTest, surface_blit_batch_fallback)
+{
+  SDL_Window sdl_window;
+  EXPECT_CALL(SDLStub::get(), SDL_CreateWindow(_, _, _, _, _, _)).WillOnce(Return(&sdl_window));
+  SDL_Renderer sdl_renderer;
+  EXPECT_CALL(SDLStub::get(), SDL_CreateRenderer(_, _, _)).WillOnce(Return(&sdl_renderer));
+  auto window = Window::create("test", geometry::Size(100, 100), "");
+
+  SDL_Texture sdl_texture;
+  EXPECT_CALL(SDLStub::get(), SDL_CreateTexture(&sdl_renderer, _, _, 64, 32)).WillOnce(Return(&sdl_texture));
+  EXPECT_CALL(SDLStub::get(), SDL_SetTextureBlendMode(&sdl_texture, _)).WillOnce(Return(0));
+  auto surface = window->create_target_surface(geometry::Size(64, 32));
+
+  const BlitQuad quads[] = {
+    {geometry::Rectangle(0, 0, 16, 16), geometry::Rectangle(0, 0, 16, 16)},
+    {geometry::Rectangle(16, 0, 16, 16), geometry::Rectangle(16, 0, 16, 16), false, {0xff, 0xff, 0x00}},
+    {geometry::Rectangle(32, 16, 16, 16), geometry::Rectangle(32, 0, 16, 16), true},
+  };
+  EXPECT_CALL(SDLStub::get(), SDL_GetError()).WillRepeatedly(Return(""));
+
+  // The renderer does not support geometry, so each quad is copied on its own, and the color mod is set once per
+  // tint (sorted, so yellow before white) and then reset to white
+  EXPECT_CALL(SDLStub::get(), SDL_RenderGeometry(&sdl_renderer, &sdl_texture, _, 12, _, 18)).WillOnce(Return(-1));
+  EXPECT_CALL(SDLStub::get(), SDL_SetTextureColorMod(&sdl_texture, 0xff, 0xff, 0x00)).WillOnce(Return(0));
+  EXPECT_CALL(SDLStub::get(), SDL_SetTextureColorMod(&sdl_texture, 0xff, 0xff, 0xff)).Times(2).WillRepeatedly(Return(0));
+  EXPECT_CALL(SDLStub::get(), SDL_RenderCopyEx(&sdl_renderer, &sdl_texture, _, _, _, _, SDL_FLIP_NONE)).Times(2).WillRepeatedly(Return(0));
+  EXPECT_CALL(SDLStub::get(), SDL_RenderCopyEx(&sdl_renderer, &sdl_texture, _, _, _, _, SDL_FLIP_HORIZONTAL)).WillOnce(Return(0));
+  surface->blit_batch(quads, std::size(quads));
+  EXPECT_EQ(3u, window->get_num_draw_calls());
+  Mock::VerifyAndClearExpectations(&SDLStub::get());
+
+  // Later batches go straight to the fallback
+  EXPECT_CALL(SDLStub::get(), SDL_RenderGeometry(_, _, _, _, _, _)).Times(0);
+  EXPECT_CALL(SDLStub::get(), SDL_SetTextureColorMod(&sdl_texture, 0xff, 0xff, 0x00)).WillOnce(Return(0));
+  EXPECT_CALL(SDLStub::get(), SDL_SetTextureColorMod(&sdl_texture, 0xff, 0xff, 0xff)).Times(2).WillRepeatedly(Return(0));
+  EXPECT_CALL(SDLStub::get(), SDL_RenderCopyEx(&sdl_renderer, &sdl_texture, _, _, _, _, _)).Times(3).WillRepeatedly(Return(0));
+  surface->blit_batch(quads, std::size(quads));
+  EXPECT_EQ(6u, window->get_num_draw_calls());
+
+  EXPECT_CALL(SDLStub::get(), SDL_DestroyTexture(&sdl_texture));
+  surface.reset();
+  EXPECT_CALL(SDLStub::get(), SDL_DestroyWindow(&sdl_window));
+  EXPECT_CALL(SDLStub::get(), SDL_DestroyRenderer(&sdl_renderer));
+  window.reset();
+}
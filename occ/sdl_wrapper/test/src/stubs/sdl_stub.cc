@@ -196,6 +196,27 @@ int SDL_RenderCopy(SDL_Renderer* renderer, SDL_Texture* texture, const SDL_Rect*
   return SDLStub::get().SDL_RenderCopy(renderer, texture, srcrect, dstrect);
 }
 
+int SDL_RenderCopyEx(SDL_Renderer* renderer,
+                     SDL_Texture* texture,
+                     const SDL_Rect* srcrect,
+                     const SDL_Rect* dstrect,
+                     double angle,
+                     const SDL_Point* center,
+                     SDL_RendererFlip flip)
+{
+  return SDLStub::get().SDL_RenderCopyEx(renderer, texture, srcrect, dstrect, angle, center, flip);
+}
+
+int SDL_RenderGeometry(SDL_Renderer* renderer,
+                       SDL_Texture* texture,
+                       const SDL_Vertex* vertices,
+                       int num_vertices,
+                       const int* indices,
+                       int num_indices)
+{
+  return SDLStub::get().SDL_RenderGeometry(renderer, texture, vertices, num_vertices, indices, num_indices);
+}
+
 int SDL_PollEvent(SDL_Event* event)
 {
   return SDLStub::get().SDL_PollEvent(event);
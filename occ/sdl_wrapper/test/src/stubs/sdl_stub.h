@@ -42,6 +42,9 @@ class SDLStub
   MOCK_METHOD2(SDL_SetTextureBlendMode, int(SDL_Texture*, SDL_BlendMode));
   MOCK_METHOD4(SDL_SetTextureColorMod, int(SDL_Texture*, Uint8, Uint8, Uint8));
   MOCK_METHOD4(SDL_RenderCopy, int(SDL_Renderer*, SDL_Texture*, const SDL_Rect*, const SDL_Rect*));
+  MOCK_METHOD7(SDL_RenderCopyEx,
+               int(SDL_Renderer*, SDL_Texture*, const SDL_Rect*, const SDL_Rect*, double, const SDL_Point*, SDL_RendererFlip));
+  MOCK_METHOD6(SDL_RenderGeometry, int(SDL_Renderer*, SDL_Texture*, const SDL_Vertex*, int, const int*, int));
 
   MOCK_METHOD1(SDL_PollEvent, int(SDL_Event*));
   MOCK_METHOD5(SDL_MapRGBA, Uint32(const SDL_PixelFormat*, Uint8, Uint8, Uint8, Uint8));
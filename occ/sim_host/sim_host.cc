@@ -0,0 +1,260 @@
+/*
+Simulate many independent games in one process, e.g. for bulk replays or training bots, and report how the
+aggregate number of ticks per second scales with the number of threads
+
+Usage: sim_host [episode] [games] [ticks] [max threads]
+
+The games are spread over the levels of the episode, and each game plays with its own random input. All games are
+stepped one tick at a time on a WorkStealingPool, first with one thread and then with twice as many threads each
+time up to max threads (by default the number of cores). Each run starts the games from scratch, and all runs must
+end with the same checksum of the game states, as the games only share level prototypes that are never modified.
+*/
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "activity_area.h"
+#include "exe_data.h"
+#include "game.h"
+#include "level_cache.h"
+#include "level_id.h"
+#include "logger.h"
+#include "misc.h"
+#include "player_input.h"
+#include "random.h"
+#include "work_stealing_pool.h"
+
+namespace
+{
+constexpr int DEFAULT_EPISODE = 1;
+constexpr unsigned DEFAULT_NUM_GAMES = 1000u;
+constexpr unsigned DEFAULT_NUM_TICKS = 1000u;
+constexpr int NUM_MAIN_LEVELS = static_cast<int>(LevelId::LEVEL_16) - static_cast<int>(LevelId::LEVEL_1) + 1;
+
+// A game with its own input stream, which holds a random combination of keys for a random number of ticks
+struct Instance
+{
+  std::unique_ptr<Game> game;
+  LevelId level;
+  Random random;
+  PlayerInput input;
+  unsigned num_held;
+  unsigned tick;
+  unsigned num_messages;
+  bool failed;
+};
+
+// Counts the messages of an instance instead of printing them, see Logger::set_thread_sink
+void count_message(void* user_data, Logger::Level, const char*)
+{
+  static_cast<Instance*>(user_data)->num_messages++;
+}
+
+void next_input(Instance& instance)
+{
+  if (instance.num_held > 0u)
+  {
+    instance.num_held--;
+    instance.input.left_pressed = false;
+    instance.input.right_pressed = false;
+    instance.input.jump_pressed = false;
+    instance.input.shoot_pressed = false;
+    return;
+  }
+
+  const auto previous = instance.input;
+  const auto direction = instance.random.range(0, 2);
+  instance.input = PlayerInput();
+  instance.input.left = direction == 1;
+  instance.input.right = direction == 2;
+  instance.input.jump = instance.random.range(0, 3) == 0;
+  instance.input.shoot = instance.random.range(0, 3) == 0;
+  instance.input.left_pressed = instance.input.left && !previous.left;
+  instance.input.right_pressed = instance.input.right && !previous.right;
+  instance.input.jump_pressed = instance.input.jump && !previous.jump;
+  instance.input.shoot_pressed = instance.input.shoot && !previous.shoot;
+  instance.num_held = instance.random.range(4u, 40u);
+}
+
+// Starts the level the game is entering, like GameState does
+bool init_level(const ExeData& exe_data, Instance& instance)
+{
+  instance.level = instance.game->entering_level;
+  if (!instance.game->init(exe_data, instance.level))
+  {
+    return false;
+  }
+  instance.game->set_activity_area(CAMERA_SIZE, ACTIVITY_RADIUS);
+  return true;
+}
+
+void step(const ExeData& exe_data, Instance& instance)
+{
+  if (instance.failed)
+  {
+    return;
+  }
+  Logger::set_thread_sink(&count_message, &instance);
+  next_input(instance);
+  instance.game->update(instance.tick++, instance.input);
+  if (instance.game->entering_level != instance.level && !init_level(exe_data, instance))
+  {
+    instance.failed = true;
+  }
+  Logger::set_thread_sink(nullptr, nullptr);
+}
+
+uint64_t get_checksum(const std::vector<Instance>& instances)
+{
+  std::vector<int> state;
+  for (const auto& instance : instances)
+  {
+    const auto& player = instance.game->get_player();
+    state.insert(state.end(),
+                 {static_cast<int>(instance.level),
+                  player.position.x(),
+                  player.position.y(),
+                  static_cast<int>(instance.game->get_score()),
+                  static_cast<int>(instance.game->get_num_lives())});
+    for (const auto& object : instance.game->get_objects())
+    {
+      state.insert(state.end(), {object.position.x(), object.position.y(), object.sprite_id});
+    }
+  }
+  return misc::hash_fnv1a(reinterpret_cast<const char*>(state.data()), state.size() * sizeof(int));
+}
+
+struct Result
+{
+  double seconds;
+  uint64_t num_stolen;
+  uint64_t checksum;
+  unsigned num_messages;
+  unsigned num_failed;
+};
+
+bool run(const ExeData& exe_data, const unsigned num_games, const unsigned num_ticks, const unsigned num_threads, Result* result)
+{
+  WorkStealingPool pool(num_threads);
+
+  // Shared by all games, so that each level is only loaded once and kept once besides the copies being played
+  const auto level_cache = std::make_shared<LevelCache>();
+  std::vector<Instance> instances(num_games);
+  for (unsigned i = 0u; i < num_games; i++)
+  {
+    auto& instance = instances[i];
+    instance.game = Game::create(i, level_cache);
+    instance.game->entering_level = static_cast<LevelId>(static_cast<int>(LevelId::LEVEL_1) + (i % NUM_MAIN_LEVELS));
+    instance.random.seed(i);
+    instance.num_held = 0u;
+    instance.tick = 0u;
+    instance.num_messages = 0u;
+    instance.failed = false;
+  }
+  // Levels are cloned from the shared level cache in parallel as well
+  pool.run(num_games,
+           [&exe_data, &instances](const std::size_t index)
+           {
+             Logger::set_thread_sink(&count_message, &instances[index]);
+             instances[index].failed = !init_level(exe_data, instances[index]);
+             Logger::set_thread_sink(nullptr, nullptr);
+           });
+  for (unsigned i = 0u; i < num_games; i++)
+  {
+    if (instances[i].failed)
+    {
+      LOG_CRITICAL("Could not load level %d", static_cast<int>(instances[i].game->entering_level));
+      return false;
+    }
+  }
+
+  const auto step_instance = [&exe_data, &instances](const std::size_t index)
+  {
+    step(exe_data, instances[index]);
+  };
+  const auto stolen_before = pool.get_num_stolen();
+  const auto start = std::chrono::steady_clock::now();
+  for (unsigned tick = 0u; tick < num_ticks; tick++)
+  {
+    pool.run(num_games, step_instance);
+  }
+  const auto end = std::chrono::steady_clock::now();
+
+  result->seconds = std::chrono::duration<double>(end - start).count();
+  result->num_stolen = pool.get_num_stolen() - stolen_before;
+  result->checksum = get_checksum(instances);
+  result->num_messages = 0u;
+  result->num_failed = 0u;
+  for (const auto& instance : instances)
+  {
+    result->num_messages += instance.num_messages;
+    result->num_failed += instance.failed ? 1u : 0u;
+  }
+  return true;
+}
+}
+
+int main(int argc, char* argv[])
+{
+  const int episode = argc > 1 ? atoi(argv[1]) : DEFAULT_EPISODE;
+  const unsigned num_games = argc > 2 ? static_cast<unsigned>(atoi(argv[2])) : DEFAULT_NUM_GAMES;
+  const unsigned num_ticks = argc > 3 ? static_cast<unsigned>(atoi(argv[3])) : DEFAULT_NUM_TICKS;
+  const unsigned max_threads = argc > 4 ? static_cast<unsigned>(atoi(argv[4])) : std::max(1u, std::thread::hardware_concurrency());
+  if (num_games == 0u || num_ticks == 0u || max_threads == 0u)
+  {
+    LOG_CRITICAL("Number of games, ticks and threads must be greater than zero");
+    return 1;
+  }
+
+  ExeData exe_data{episode};
+  std::vector<unsigned> thread_counts;
+  for (unsigned num_threads = 1u; num_threads < max_threads; num_threads *= 2u)
+  {
+    thread_counts.push_back(num_threads);
+  }
+  thread_counts.push_back(max_threads);
+
+  printf("%u games, %u ticks\n", num_games, num_ticks);
+  printf("%8s %12s %14s %10s %12s %10s %18s\n", "threads", "time (s)", "ticks/s", "speedup", "efficiency", "stolen", "checksum");
+  double base_ticks_per_second = 0.0;
+  uint64_t checksum = 0u;
+  for (const auto num_threads : thread_counts)
+  {
+    Result result;
+    if (!run(exe_data, num_games, num_ticks, num_threads, &result))
+    {
+      return 1;
+    }
+    const auto ticks_per_second = static_cast<double>(num_games) * num_ticks / result.seconds;
+    if (num_threads == thread_counts.front())
+    {
+      base_ticks_per_second = ticks_per_second;
+      checksum = result.checksum;
+    }
+    const auto speedup = ticks_per_second / base_ticks_per_second;
+    printf("%8u %12.3f %14.0f %9.2fx %11.0f%% %10llu %18llx\n",
+           num_threads,
+           result.seconds,
+           ticks_per_second,
+           speedup,
+           100.0 * speedup / num_threads,
+           static_cast<unsigned long long>(result.num_stolen),
+           static_cast<unsigned long long>(result.checksum));
+    if (result.num_failed > 0u)
+    {
+      LOG_CRITICAL("%u games could not enter a level", result.num_failed);
+      return 1;
+    }
+    if (result.checksum != checksum)
+    {
+      LOG_CRITICAL("Games with %u threads ended in another state than with %u", num_threads, thread_counts.front());
+      return 1;
+    }
+  }
+  return 0;
+}
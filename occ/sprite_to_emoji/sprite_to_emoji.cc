@@ -4,6 +4,7 @@ https://moddingwiki.shikadi.net/wiki/ProGraphx_Toolbox_tileset_format
 #include <fstream>
 #include <iostream>
 
+#include <ega.h>
 #include <misc.h>
 #include <path.h>
 
@@ -49,34 +50,18 @@ int main()
     {
       std::string pixels(size, '\0');
       input.read(&pixels[0], size);
-      uint8_t* pp = (uint8_t*)(&pixels[0]);
+      const auto* pp = reinterpret_cast<const uint8_t*>(pixels.data());
+      uint8_t indices[ega::PIXELS_PER_GROUP];
       for (int i = 0; i < header.count; i++, idx++)
       {
         for (int h = 0; h < header.height; h++)
         {
-          for (int w = 0; w < header.width; w++)
+          for (int w = 0; w < header.width; w++, pp += ega::GROUP_SIZE)
           {
-            const uint8_t t_plane = *pp++;
-            const uint8_t b_plane = *pp++;
-            const uint8_t g_plane = *pp++;
-            const uint8_t r_plane = *pp++;
-            const uint8_t i_plane = *pp++;
-            for (int bit = 7; bit >= 0; bit--)
+            ega::decode_indices(pp, 1, indices);
+            for (const auto index : indices)
             {
-              const bool t = (t_plane >> bit) & 1;
-              if (!t)
-              {
-                std::cout << colors[0];
-              }
-              else
-              {
-                const bool b = (b_plane >> bit) & 1;
-                const bool g = (g_plane >> bit) & 1;
-                const bool r = (r_plane >> bit) & 1;
-                const bool i_ = (i_plane >> bit) & 1;
-                std::cout
-                  << colors[(static_cast<int>(i_) << 3) | (static_cast<int>(r) << 2) | (static_cast<int>(g) << 1) | static_cast<int>(b)];
-              }
+              std::cout << colors[index == ega::TRANSPARENT ? 0 : index];
             }
           }
           std::cout << "\n";
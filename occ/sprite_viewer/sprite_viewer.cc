@@ -41,8 +41,10 @@ int main(int argc, char* argv[])
     LOG_CRITICAL("Could not load tilesets");
     return 1;
   }
+  // The sheet is part of the sprite atlas
   const auto surface = sprite_manager.get_surface();
-  window->set_size(surface->size());
+  const auto sheet_rect = sprite_manager.get_sprite_sheet_rect();
+  window->set_size(sheet_rect.size);
   auto event = Event::create();
   if (!event)
   {
@@ -58,8 +60,8 @@ int main(int argc, char* argv[])
     {
       break;
     }
-    window->fill_rect(geometry::Rectangle(0, 0, surface->size()), {33u, 33u, 33u});
-    surface->blit_surface();
+    window->fill_rect(geometry::Rectangle(0, 0, sheet_rect.size), {33u, 33u, 33u});
+    surface->blit_surface(sheet_rect, geometry::Rectangle(0, 0, sheet_rect.size));
     // Show hovered sprite and draw its index
     const int x = input.mouse.x() / SPRITE_W;
     const int y = input.mouse.y() / SPRITE_H;
@@ -0,0 +1,182 @@
+/*
+Measure the throughput of each EGA decoder path supported by this CPU on synthetic planar data.
+
+Then measure how long it takes to get the decoded tilesets (sprites and fonts) of an episode, by decoding
+them and by using the tileset cache. Cold runs remove the cache file first so they decode the
+tilesets and write the cache, warm runs memory-map the cache file.
+
+Usage: tileset_bench [episode] [iterations]
+*/
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "ega.h"
+#include "logger.h"
+#include "misc.h"
+#include "path.h"
+#include "tileset.h"
+
+namespace
+{
+constexpr int DEFAULT_NUM_ITERATIONS = 20;
+
+// Same size as a chunk of 50 16x16 sprites, which is what decode_tilesets decodes at a time
+constexpr std::size_t DECODER_NUM_GROUPS = 50 * 32;
+constexpr int DECODER_ITERATIONS_MULTIPLIER = 100;
+
+struct Tileset
+{
+  std::string name;
+  std::vector<std::filesystem::path> paths;
+  TilesetFormat format;
+  std::string cache_name;
+};
+
+// Same files and formats as SpriteManager::load_tilesets
+std::vector<Tileset> get_tilesets(const int episode)
+{
+  std::vector<Tileset> tilesets;
+
+  const auto gfx_path = get_data_path(misc::string_format("CC%d.GFX", episode));
+  if (!gfx_path.empty())
+  {
+    tilesets.push_back({"sprites", {gfx_path}, {16, 16, 52, 2}, misc::string_format("CC%d.GFX.pixels", episode)});
+  }
+
+  Tileset fonts{"fonts", {}, {8, 8, 50, 0}, misc::string_format("CC%d-F.pixels", episode)};
+  for (int i = 1;; i++)
+  {
+    const auto path = get_data_path(misc::string_format("CC%d-F%d.MNI", episode, i));
+    if (path.empty())
+    {
+      break;
+    }
+    fonts.paths.push_back(path);
+  }
+  const auto spl_path = get_data_path(misc::string_format("CC%d-SPL.MNI", episode));
+  if (!spl_path.empty())
+  {
+    fonts.paths.push_back(spl_path);
+  }
+  if (!fonts.paths.empty())
+  {
+    tilesets.push_back(std::move(fonts));
+  }
+  return tilesets;
+}
+
+// Returns the average time in milliseconds of f, or a negative value if f failed
+double measure(const int num_iterations, const std::function<bool()>& f)
+{
+  std::chrono::steady_clock::duration total{};
+  for (int i = 0; i < num_iterations; i++)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    const auto ok = f();
+    total += std::chrono::steady_clock::now() - start;
+    if (!ok)
+    {
+      return -1.0;
+    }
+  }
+  return std::chrono::duration<double, std::milli>(total).count() / num_iterations;
+}
+
+void bench_decoder(const int num_iterations)
+{
+  std::vector<uint8_t> planes(DECODER_NUM_GROUPS * ega::GROUP_SIZE);
+  uint32_t state = 1u;
+  for (auto& plane : planes)
+  {
+    state = state * 1664525u + 1013904223u;
+    plane = static_cast<uint8_t>(state >> 24);
+  }
+  std::vector<uint32_t> pixels(DECODER_NUM_GROUPS * ega::PIXELS_PER_GROUP);
+
+  printf("%-8s %10s %10s\n", "decoder", "us", "MB/s");
+  for (const auto path : {ega::DecodePath::SCALAR, ega::DecodePath::SWAR, ega::DecodePath::SSE2, ega::DecodePath::AVX2})
+  {
+    if (!ega::is_supported(path))
+    {
+      continue;
+    }
+    const auto ms = measure(num_iterations * DECODER_ITERATIONS_MULTIPLIER,
+                            [&planes, &pixels, path]()
+                            {
+                              ega::decode_argb(path, planes.data(), DECODER_NUM_GROUPS, pixels.data());
+                              return pixels[0] != 1u;
+                            });
+    const auto mb_per_s = (planes.size() / (1024.0 * 1024.0)) / (ms / 1000.0);
+    printf("%-8s %10.3f %10.1f%s\n", ega::to_string(path), ms * 1000.0, mb_per_s, path == ega::get_best_path() ? " (used)" : "");
+  }
+  printf("\n");
+}
+}
+
+int main(int argc, char* argv[])
+{
+  const int episode = argc > 1 ? atoi(argv[1]) : 1;
+  const int num_iterations = argc > 2 ? atoi(argv[2]) : DEFAULT_NUM_ITERATIONS;
+  if (num_iterations <= 0)
+  {
+    LOG_CRITICAL("Number of iterations must be greater than zero");
+    return 1;
+  }
+
+  bench_decoder(num_iterations);
+
+  const auto tilesets = get_tilesets(episode);
+  if (tilesets.empty())
+  {
+    LOG_CRITICAL("Could not find the tilesets of episode %d", episode);
+    return 1;
+  }
+  if (get_cache_path("").empty())
+  {
+    LOG_CRITICAL("No usable cache directory");
+    return 1;
+  }
+
+  printf("%-8s %10s %10s %10s %12s\n", "tileset", "size", "decode ms", "cold ms", "warm ms");
+  double total_decode = 0.0;
+  double total_cold = 0.0;
+  double total_warm = 0.0;
+  for (const auto& tileset : tilesets)
+  {
+    const auto decode_ms = measure(num_iterations, [&tileset]() { return !decode_tilesets(tileset.paths, tileset.format).empty(); });
+    const auto cold_ms = measure(num_iterations,
+                                 [&tileset]()
+                                 {
+                                   std::error_code ec;
+                                   std::filesystem::remove(get_cache_path(tileset.cache_name), ec);
+                                   const auto pixels = load_tilesets(tileset.paths, tileset.format, tileset.cache_name);
+                                   return !pixels.empty() && !pixels.is_cached();
+                                 });
+    const auto warm_ms = measure(num_iterations,
+                                 [&tileset]()
+                                 {
+                                   const auto pixels = load_tilesets(tileset.paths, tileset.format, tileset.cache_name);
+                                   return !pixels.empty() && pixels.is_cached();
+                                 });
+    if (decode_ms < 0.0 || cold_ms < 0.0 || warm_ms < 0.0)
+    {
+      LOG_CRITICAL("Could not load the %s tileset", tileset.name.c_str());
+      return 1;
+    }
+    const auto pixels = load_tilesets(tileset.paths, tileset.format, tileset.cache_name);
+    const auto size = std::to_string(pixels.width()) + "x" + std::to_string(pixels.height());
+    printf("%-8s %10s %10.3f %10.3f %12.3f\n", tileset.name.c_str(), size.c_str(), decode_ms, cold_ms, warm_ms);
+    total_decode += decode_ms;
+    total_cold += cold_ms;
+    total_warm += warm_ms;
+  }
+  printf("%-8s %10s %10.3f %10.3f %12.3f\n", "total", "", total_decode, total_cold, total_warm);
+  return 0;
+}
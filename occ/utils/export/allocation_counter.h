@@ -0,0 +1,8 @@
+#pragma once
+
+#include <cstddef>
+
+// Programs linking the allocation_counter library have the global operator new and delete replaced, so that they can
+// count the heap allocations made by e.g. a game tick
+// Returns the number of allocations made by all threads since the program started.
+std::size_t get_num_allocations();
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "geometry.h"
+
+// ARGB8888 pixels of an image to pack into an atlas, the pixels are copied by Atlas::pack
+struct AtlasImage
+{
+  int width;
+  int height;
+  const uint32_t* pixels;
+};
+
+// Images packed into as few textures (pages) as possible, so that they can be drawn without switching textures
+class Atlas
+{
+ public:
+  struct Page
+  {
+    int width = 0;
+    int height = 0;
+    std::vector<uint32_t> pixels;
+  };
+
+  struct Region
+  {
+    int page = 0;
+    geometry::Rectangle rect;
+  };
+
+  // Packs the images into pages of at most max_size x max_size pixels, in rows of images sorted by height.
+  // Returns false if an image does not fit in a page.
+  bool pack(const std::vector<AtlasImage>& images, const int max_size);
+
+  const std::vector<Page>& get_pages() const { return pages_; }
+  // Where images[index] passed to pack ended up
+  const Region& get_region(const int index) const { return regions_[index]; }
+
+  // Frees the pixels of the pages, e.g. once they have been uploaded, but keeps the regions
+  void clear_pixels();
+
+ private:
+  std::vector<Page> pages_;
+  std::vector<Region> regions_;
+};
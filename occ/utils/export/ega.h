@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Decoding of EGA planar pixel data as stored in ProGraphx Toolbox tilesets
+// Pixels are stored in groups of 5 bytes: the transparency, blue, green, red and intensity planes of
+// 8 pixels, with the leftmost pixel in the most significant bit. A pixel is transparent if its
+// transparency bit is 0.
+namespace ega
+{
+
+constexpr std::size_t GROUP_SIZE = 5;
+constexpr std::size_t PIXELS_PER_GROUP = 8;
+
+// Palette index of transparent pixels returned by decode_indices
+constexpr uint8_t TRANSPARENT = 16u;
+
+// The 16 color EGA palette in ARGB8888, indexed by IRGB
+extern const uint32_t PALETTE[16];
+
+enum class DecodePath
+{
+  SCALAR,  // One bit at a time
+  SWAR,    // 8 pixels at a time using 64-bit integers, works on any CPU
+  SSE2,    // 16 pixels at a time, x86-64 only
+  AVX2,    // 8 pixels at a time using a palette gather, x86-64 CPUs with AVX2 only
+};
+
+const char* to_string(DecodePath path);
+bool is_supported(DecodePath path);
+
+// Returns the fastest path supported by this CPU, which is used by decode_argb
+DecodePath get_best_path();
+
+// Decodes num_groups groups of planes to 8 * num_groups palette indices (or TRANSPARENT)
+void decode_indices(const uint8_t* planes, std::size_t num_groups, uint8_t* indices);
+
+// Decodes num_groups groups of planes to 8 * num_groups ARGB8888 pixels, transparent pixels are 0
+void decode_argb(const uint8_t* planes, std::size_t num_groups, uint32_t* pixels);
+// Same as above but with the given path, which must be supported
+void decode_argb(DecodePath path, const uint8_t* planes, std::size_t num_groups, uint32_t* pixels);
+
+}
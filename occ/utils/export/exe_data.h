@@ -1,12 +1,45 @@
 #pragma once
 
+#include <cstddef>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <vector>
+
+#include "mapped_file.h"
 
 class ExeData
 {
   // Crystal caves data from the .EXE file
  public:
+  // The decompressed .EXE is cached, so it is only decompressed the first time (or when the .EXE changes)
   ExeData(const int episode);
 
-  std::string data;
+  ExeData(const ExeData&) = delete;
+  ExeData& operator=(const ExeData&) = delete;
+
+  // Location of a level's rows in data
+  // Each row is a length byte followed by that many tile ids
+  struct Level
+  {
+    std::size_t offset;
+    int width;
+    int height;
+  };
+
+  // The decompressed .EXE, either memory-mapped from the cache or owned
+  std::string_view data;
+  // Indexed by LevelId, empty if data is too short to hold all levels
+  std::vector<Level> levels;
+
+  // Returns true if data is memory-mapped from the cache
+  bool is_cached() const { return mapped_ != nullptr; }
+
+ private:
+  bool load_cache(const std::string& cache_name, const MappedFile& exe_file, const uint64_t exe_hash);
+  void write_cache(const std::string& cache_name, const MappedFile& exe_file, const uint64_t exe_hash) const;
+  void index_levels();
+
+  std::string decompressed_;
+  std::unique_ptr<MappedFile> mapped_;
 };
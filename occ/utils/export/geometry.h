@@ -1,6 +1,7 @@
 #pragma once
 
 #include <algorithm>
+#include <iterator>
 #include <utility>
 #include <vector>
 
@@ -41,8 +42,13 @@ constexpr bool isColliding(const Rectangle& a, const Rectangle& b)
   return a.position.x() < b.position.x() + b.size.x() && a.position.y() < b.position.y() + b.size.y() &&
     a.position.x() + a.size.x() > b.position.x() && a.position.y() + a.size.y() > b.position.y();
 }
+// Returns true if any Rectangle in v intersects Rectangle a
 // TODO: make constexpr; available in C++20
-bool is_any_colliding(const std::vector<Rectangle>& v, const Rectangle& a);
+template <typename Rectangles>
+bool is_any_colliding(const Rectangles& v, const Rectangle& a)
+{
+  return std::any_of(std::begin(v), std::end(v), [&a](const Rectangle& r) { return isColliding(a, r); });
+}
 // Returns true if A is within B
 constexpr bool is_inside(const Rectangle& a, const Rectangle& b)
 {
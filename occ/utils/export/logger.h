@@ -24,7 +24,15 @@ class Logger
     LOG_DEBUG = 3,
   };
 
+  // Receives the messages logged on a thread instead of them being printed
+  using Sink = void (*)(void* user_data, Level level, const char* message);
+
   static void log(const char* full_filename, int line, Level level, ...);
+
+  // Sets the sink of the calling thread, or makes it print its messages again if sink is null
+  // Each thread has its own sink, so e.g. games simulated on worker threads can collect or drop their messages
+  // without sharing anything with the other threads.
+  static void set_thread_sink(Sink sink, void* user_data);
 };
 
 #define LOG_ERROR(...) Logger::log(__FILE__, __LINE__, Logger::Level::LOG_ERROR, __VA_ARGS__)
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+
+// A read-only memory mapping of a whole file
+class MappedFile
+{
+ public:
+  // Returns nullptr if the file could not be opened or mapped
+  static std::unique_ptr<MappedFile> open(const std::filesystem::path& path);
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  ~MappedFile();
+
+  const char* data() const { return data_; }
+  std::size_t size() const { return size_; }
+
+ private:
+  MappedFile(const char* data, std::size_t size, void* handle);
+
+  const char* data_;
+  std::size_t size_;
+  // File mapping handle on Windows, unused elsewhere
+  [[maybe_unused]] void* handle_;
+};
@@ -1,8 +1,10 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
-#include <random>
+#include <string>
 #include <type_traits>
 #include <utility>
 
@@ -15,15 +17,6 @@ constexpr auto make_array(T&&... values) -> std::array<typename std::decay<typen
   return std::array<typename std::decay<typename std::common_type<T...>::type>::type, sizeof...(T)>{std::forward<T>(values)...};
 }
 
-template<typename T>
-T random(T min, T max)
-{
-  static std::random_device rd;
-  static std::mt19937 gen(rd());
-  std::uniform_int_distribution<T> dis(min, max);
-  return dis(gen);
-}
-
 // TODO: use C++20 format
 template<typename... Args>
 std::string string_format(const std::string& format, Args... args)
@@ -41,4 +34,7 @@ std::string string_format(const std::string& format, Args... args)
 
 void open_url(const std::string& url);
 
+// 64-bit FNV-1a hash, used to detect changes to game data files
+uint64_t hash_fnv1a(const char* data, std::size_t size);
+
 }
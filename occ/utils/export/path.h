@@ -3,3 +3,8 @@
 #include <filesystem>
 
 std::filesystem::path get_data_path(const std::filesystem::path& filename);
+
+// Returns the path of filename in the per-user cache directory, creating the directory if needed
+// The directory can be overridden with the OCC_CACHE_DIR environment variable
+// Returns an empty path if there is no usable cache directory
+std::filesystem::path get_cache_path(const std::filesystem::path& filename);
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+// xoshiro256** pseudo-random number generator, see https://prng.di.unimi.it/
+// Each owner (e.g. a Level) has its own generator, so runs with the same seed are repeatable and generators on
+// different threads do not share state. Unlike the standard distributions, range returns the same numbers on
+// every platform.
+class Random
+{
+ public:
+  explicit Random(const uint64_t seed = 0u) : state_() { this->seed(seed); }
+
+  void seed(const uint64_t seed);
+
+  uint64_t next()
+  {
+    const auto result = rotl(state_[1] * 5u, 7) * 9u;
+    const auto t = state_[1] << 17;
+    state_[2] ^= state_[0];
+    state_[3] ^= state_[1];
+    state_[1] ^= state_[2];
+    state_[0] ^= state_[3];
+    state_[2] ^= t;
+    state_[3] = rotl(state_[3], 45);
+    return result;
+  }
+
+  // Returns a uniformly distributed integer in [min, max]
+  template <typename T>
+  T range(const T min, const T max)
+  {
+    static_assert(std::is_integral<T>::value, "range only supports integers");
+    const auto span = static_cast<uint64_t>(max) - static_cast<uint64_t>(min) + 1u;
+    if (span == 0u)
+    {
+      // All 64-bit values
+      return static_cast<T>(next());
+    }
+    // Reject the lowest values so that each result is equally likely
+    const auto threshold = (0u - span) % span;
+    auto value = next();
+    while (value < threshold)
+    {
+      value = next();
+    }
+    return static_cast<T>(static_cast<uint64_t>(min) + value % span);
+  }
+
+  bool operator==(const Random& other) const { return state_ == other.state_; }
+  bool operator!=(const Random& other) const { return state_ != other.state_; }
+
+ private:
+  static uint64_t rotl(const uint64_t x, const int k) { return (x << k) | (x >> (64 - k)); }
+
+  std::array<uint64_t, 4> state_;
+};
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Tasks with dependencies between them. Each task runs as soon as all its dependencies are done, either on
+// the thread calling run or on a worker thread, and its wall time is recorded.
+class TaskGraph
+{
+ public:
+  using Clock = std::chrono::steady_clock;
+  using TaskId = std::size_t;
+
+  enum class Thread
+  {
+    MAIN,
+    WORKER,
+  };
+
+  struct Task
+  {
+    std::string name;
+    Thread thread;
+    std::vector<TaskId> dependencies;
+    std::function<bool()> function;
+    bool done = false;
+    Clock::time_point start;
+    Clock::time_point end;
+  };
+
+  // Adds a task and returns its id. Dependencies must already be added, so the graph can not have cycles.
+  TaskId add(const std::string& name, const Thread thread, const std::vector<TaskId>& dependencies, std::function<bool()> function);
+
+  // Runs all tasks, worker tasks on num_threads worker threads and main tasks on the calling thread.
+  // If a task returns false no more tasks are started and false is returned once the running tasks are done.
+  bool run(const unsigned num_threads);
+
+  const std::vector<Task>& get_tasks() const { return tasks_; }
+
+  // Returns the chain of tasks that decided when the last task finished: starting from the last task to
+  // finish, each task is preceded by the dependency that finished last
+  std::vector<TaskId> get_critical_path() const;
+
+  // Returns the start, duration and end of each task that has run, relative to the start of run, and the
+  // critical path
+  std::string get_report() const;
+
+ private:
+  bool is_ready(const Task& task) const;
+  double to_ms(const Clock::time_point time) const;
+
+  std::vector<Task> tasks_;
+  Clock::time_point start_;
+};
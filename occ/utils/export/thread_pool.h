@@ -0,0 +1,47 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A fixed number of worker threads running submitted tasks in submission order
+class ThreadPool
+{
+ public:
+  explicit ThreadPool(const unsigned num_threads);
+  // Waits for the running tasks to finish, tasks that have not started yet are dropped and their futures
+  // report a broken promise
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  // Queues f to be called on a worker thread, the returned future holds its result
+  template <typename F>
+  auto submit(F f) -> std::future<decltype(f())>
+  {
+    // std::function must be copyable, so the task is shared
+    auto task = std::make_shared<std::packaged_task<decltype(f())()>>(std::move(f));
+    auto future = task->get_future();
+    push([task]() { (*task)(); });
+    return future;
+  }
+
+  std::size_t get_num_threads() const { return threads_.size(); }
+
+ private:
+  void push(std::function<void()> task);
+  void run();
+
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::deque<std::function<void()>> tasks_;
+  bool stopping_ = false;
+  std::vector<std::thread> threads_;
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mapped_file.h"
+
+// Layout of the sprites in ProGraphx Toolbox tileset files (e.g. CC1.GFX and the font files),
+// and of the decoded sheet
+struct TilesetFormat
+{
+  int sprite_w;
+  int sprite_h;
+  // Number of sprites per row in the decoded sheet
+  int stride;
+  // Number of empty sprite slots after each chunk of sprites
+  int filler;
+};
+
+// Decoded ARGB8888 pixels of one or more tileset files stacked vertically
+// The pixels are either owned or memory-mapped from the tileset cache
+class TilesetPixels
+{
+ public:
+  bool empty() const { return data_ == nullptr; }
+  int width() const { return width_; }
+  int height() const { return height_; }
+  const uint32_t* data() const { return data_; }
+
+  // Returns true if the pixels were loaded from the tileset cache
+  bool is_cached() const { return mapped_ != nullptr; }
+
+ private:
+  friend TilesetPixels decode_tilesets(const std::vector<std::filesystem::path>& paths, const TilesetFormat& format);
+  friend TilesetPixels load_tilesets(const std::vector<std::filesystem::path>& paths,
+                                     const TilesetFormat& format,
+                                     const std::string& cache_name);
+
+  int width_ = 0;
+  int height_ = 0;
+  const uint32_t* data_ = nullptr;
+  std::vector<uint32_t> pixels_;
+  std::unique_ptr<MappedFile> mapped_;
+};
+
+// Decodes the given tileset files, files that can not be read or have no sprites are skipped
+TilesetPixels decode_tilesets(const std::vector<std::filesystem::path>& paths, const TilesetFormat& format);
+
+// Same as decode_tilesets, but the decoded pixels are stored in the cache directory as cache_name.
+// The cached pixels are memory-mapped and reused as long as the tileset files are unchanged,
+// i.e. have the same size and modification time, or the same contents.
+TilesetPixels load_tilesets(const std::vector<std::filesystem::path>& paths, const TilesetFormat& format, const std::string& cache_name);
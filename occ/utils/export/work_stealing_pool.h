@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A fixed number of worker threads running batches of independent tasks, e.g. updating many games for one tick
+// Each worker has its own queue and takes tasks from its back, and a worker whose queue is empty steals tasks
+// from the front of the queues of the other workers. Tasks that take longer than others (e.g. a game in a busy
+// level) are then evened out between the workers without all of them taking tasks from one shared queue.
+class WorkStealingPool
+{
+ public:
+  explicit WorkStealingPool(const unsigned num_threads);
+  ~WorkStealingPool();
+
+  WorkStealingPool(const WorkStealingPool&) = delete;
+  WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+  // Calls f(index) for each index in [0, num_tasks) on the worker threads and returns once all calls are done
+  // The indices are split into one contiguous range per worker up front.
+  void run(const std::size_t num_tasks, const std::function<void(std::size_t)>& f);
+
+  std::size_t get_num_threads() const { return threads_.size(); }
+
+  // Returns the number of tasks that were run by another worker than the one they were given to
+  uint64_t get_num_stolen() const { return num_stolen_; }
+
+ private:
+  struct Queue
+  {
+    std::mutex mutex;
+    std::deque<std::size_t> tasks;
+  };
+
+  bool pop(const std::size_t worker, std::size_t& task);
+  void work(const std::size_t worker);
+
+  std::vector<std::unique_ptr<Queue>> queues_;
+  const std::function<void(std::size_t)>* function_;
+  std::mutex mutex_;
+  std::condition_variable start_condition_;
+  std::condition_variable done_condition_;
+  uint64_t batch_;
+  std::size_t num_remaining_;
+  bool stopping_;
+  std::atomic<uint64_t> num_stolen_;
+  std::vector<std::thread> threads_;
+};
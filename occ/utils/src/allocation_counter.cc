@@ -0,0 +1,84 @@
+#include "allocation_counter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Every replaceable form except the aligned ones is replaced, so that each new is paired with a matching delete
+// malloc and free are only called from allocate and release, which nothing outside this file can inline, so the
+// compiler never sees free called on memory from a new expression.
+static std::atomic<std::size_t> num_allocations{0u};
+
+static void* allocate(const std::size_t size) noexcept
+{
+  num_allocations.fetch_add(1u, std::memory_order_relaxed);
+  return std::malloc(size == 0u ? 1u : size);
+}
+
+static void release(void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+std::size_t get_num_allocations()
+{
+  return num_allocations.load(std::memory_order_relaxed);
+}
+
+void* operator new(std::size_t size)
+{
+  if (void* ptr = allocate(size))
+  {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+  if (void* ptr = allocate(size))
+  {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+  return allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+  return allocate(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+  release(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+  release(ptr);
+}
+
+void operator delete(void* ptr, [[maybe_unused]] std::size_t size) noexcept
+{
+  release(ptr);
+}
+
+void operator delete[](void* ptr, [[maybe_unused]] std::size_t size) noexcept
+{
+  release(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+  release(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+  release(ptr);
+}
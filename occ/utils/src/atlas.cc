@@ -0,0 +1,84 @@
+#include "atlas.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "logger.h"
+
+bool Atlas::pack(const std::vector<AtlasImage>& images, const int max_size)
+{
+  pages_.clear();
+  regions_.assign(images.size(), Region());
+
+  // Tallest images first so that each row wastes as little height as possible
+  std::vector<int> order(images.size());
+  for (int i = 0; i < static_cast<int>(images.size()); i++)
+  {
+    order[i] = i;
+  }
+  std::stable_sort(order.begin(), order.end(), [&images](const int a, const int b) { return images[a].height > images[b].height; });
+
+  // The current row is at row_y in the last page, and is row_height high
+  int x = 0;
+  int row_y = 0;
+  int row_height = 0;
+  for (const auto i : order)
+  {
+    const auto& image = images[i];
+    if (image.width > max_size || image.height > max_size)
+    {
+      LOG_ERROR("Image of %dx%d does not fit in an atlas of %dx%d", image.width, image.height, max_size, max_size);
+      pages_.clear();
+      regions_.clear();
+      return false;
+    }
+    if (x + image.width > max_size)
+    {
+      // Next row
+      x = 0;
+      row_y += row_height;
+      row_height = 0;
+    }
+    if (pages_.empty() || row_y + image.height > max_size)
+    {
+      // Next page
+      pages_.emplace_back();
+      x = 0;
+      row_y = 0;
+      row_height = 0;
+    }
+    regions_[i] = {static_cast<int>(pages_.size()) - 1, {x, row_y, image.width, image.height}};
+    x += image.width;
+    row_height = std::max(row_height, image.height);
+    auto& page = pages_.back();
+    page.width = std::max(page.width, x);
+    page.height = std::max(page.height, row_y + row_height);
+  }
+
+  // Pages are only as large as their images need
+  for (auto& page : pages_)
+  {
+    page.pixels.assign(static_cast<std::size_t>(page.width) * page.height, 0u);
+  }
+  for (int i = 0; i < static_cast<int>(images.size()); i++)
+  {
+    const auto& image = images[i];
+    const auto& region = regions_[i];
+    auto& page = pages_[region.page];
+    for (int y = 0; y < image.height; y++)
+    {
+      std::memcpy(page.pixels.data() + static_cast<std::size_t>(region.rect.position.y() + y) * page.width + region.rect.position.x(),
+                  image.pixels + static_cast<std::size_t>(y) * image.width,
+                  image.width * sizeof(uint32_t));
+    }
+  }
+  return true;
+}
+
+void Atlas::clear_pixels()
+{
+  for (auto& page : pages_)
+  {
+    page.pixels = std::vector<uint32_t>();
+  }
+}
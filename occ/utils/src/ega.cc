@@ -0,0 +1,336 @@
+#include "ega.h"
+
+#include <array>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define EGA_X86_64
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define TARGET_AVX2
+#else
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace ega
+{
+
+constexpr uint32_t PALETTE[16] = {
+  0xFF000000,  // "⚫",
+  0xFF0000AA,  // "🔵",
+  0xFF00AA00,  // "🟢",
+  0xFF00AAAA,  // "💧",
+  0xFFAA0000,  // "🔴",
+  0xFFAA00AA,  // "🟣",
+  0xFFAA5500,  // "🟠",
+  0xFFAAAAAA,  // "⚪",
+  0xFF555555,  // "⬛",
+  0xFF5555FF,  // "🟦",
+  0xFF55FF55,  // "🟩",
+  0xFF55FFFF,  // "🐬",
+  0xFFFF5555,  // "🟥",
+  0xFFFF55FF,  // "🟪",
+  0xFFFFFFAA,  // "🟨",
+  0xFFFFFFFF,  // "⬜",
+};
+
+namespace
+{
+// PALETTE followed by the (transparent) color of TRANSPARENT
+constexpr std::array<uint32_t, 17> make_palette_with_transparent()
+{
+  std::array<uint32_t, 17> palette = {};
+  for (int i = 0; i < 16; i++)
+  {
+    palette[i] = PALETTE[i];
+  }
+  return palette;
+}
+constexpr auto PALETTE_WITH_TRANSPARENT = make_palette_with_transparent();
+
+// The SSE2 path computes the colors instead of looking them up: each component is 0xAA if its bit is set
+// plus 0x55 if the intensity bit is set, except for brown (6) and yellow (14)
+constexpr uint32_t computed_color(const int index)
+{
+  const uint32_t i = (index & 8) ? 0x55 : 0x00;
+  uint32_t r = ((index & 4) ? 0xAA : 0x00) + i;
+  uint32_t g = ((index & 2) ? 0xAA : 0x00) + i - (index == 6 ? 0x55 : 0x00);
+  uint32_t b = ((index & 1) ? 0xAA : 0x00) + i + (index == 14 ? 0x55 : 0x00);
+  return 0xFF000000 | (r << 16) | (g << 8) | b;
+}
+
+constexpr bool is_palette_computable()
+{
+  for (int index = 0; index < 16; index++)
+  {
+    if (computed_color(index) != PALETTE[index])
+    {
+      return false;
+    }
+  }
+  return true;
+}
+static_assert(is_palette_computable(), "The SSE2 path must be updated to match the palette");
+
+// For each byte value, 8 bytes where byte n is bit 7 - n of the value, i.e. one byte per pixel
+const std::array<uint64_t, 256>& get_spread_table()
+{
+  static const auto table = []()
+  {
+    std::array<uint64_t, 256> table;
+    for (int value = 0; value < 256; value++)
+    {
+      uint8_t bytes[8];
+      for (int n = 0; n < 8; n++)
+      {
+        bytes[n] = (value >> (7 - n)) & 1;
+      }
+      std::memcpy(&table[value], bytes, sizeof(bytes));
+    }
+    return table;
+  }();
+  return table;
+}
+
+// Returns 8 palette indices (or TRANSPARENT), one per byte in pixel order
+uint64_t decode_group_swar(const std::array<uint64_t, 256>& spread, const uint8_t* group)
+{
+  constexpr uint64_t ones = 0x0101010101010101ull;
+  const uint64_t opaque = spread[group[0]] * 0xFF;
+  const uint64_t index = spread[group[1]] | (spread[group[2]] << 1) | (spread[group[3]] << 2) | (spread[group[4]] << 3);
+  return (index & opaque) | (TRANSPARENT * ones & ~opaque);
+}
+
+void decode_argb_scalar(const uint8_t* planes, std::size_t num_groups, uint32_t* pixels)
+{
+  for (std::size_t group = 0; group < num_groups; group++, planes += GROUP_SIZE)
+  {
+    const uint8_t t_plane = planes[0];
+    const uint8_t b_plane = planes[1];
+    const uint8_t g_plane = planes[2];
+    const uint8_t r_plane = planes[3];
+    const uint8_t i_plane = planes[4];
+    for (int bit = 7; bit >= 0; bit--)
+    {
+      const bool t = (t_plane >> bit) & 1;
+      if (!t)
+      {
+        *pixels++ = 0;
+      }
+      else
+      {
+        const bool b = (b_plane >> bit) & 1;
+        const bool g = (g_plane >> bit) & 1;
+        const bool r = (r_plane >> bit) & 1;
+        const bool i = (i_plane >> bit) & 1;
+        *pixels++ = PALETTE[((int)i << 3) | ((int)r << 2) | ((int)g << 1) | (int)b];
+      }
+    }
+  }
+}
+
+void decode_argb_swar(const uint8_t* planes, std::size_t num_groups, uint32_t* pixels)
+{
+  const auto& spread = get_spread_table();
+  for (std::size_t group = 0; group < num_groups; group++, planes += GROUP_SIZE, pixels += PIXELS_PER_GROUP)
+  {
+    const auto packed = decode_group_swar(spread, planes);
+    uint8_t indices[PIXELS_PER_GROUP];
+    std::memcpy(indices, &packed, sizeof(indices));
+    for (std::size_t n = 0; n < PIXELS_PER_GROUP; n++)
+    {
+      pixels[n] = PALETTE_WITH_TRANSPARENT[indices[n]];
+    }
+  }
+}
+
+#ifdef EGA_X86_64
+// Returns 0xFF in each byte whose bits are set in mask
+__m128i bit_mask_sse2(const __m128i bytes, const char mask)
+{
+  const __m128i bits = _mm_set1_epi8(mask);
+  return _mm_cmpeq_epi8(_mm_and_si128(bytes, bits), bits);
+}
+
+void decode_argb_sse2(const uint8_t* planes, std::size_t num_groups, uint32_t* pixels)
+{
+  // Two groups, 16 pixels, at a time with one byte per pixel and color component, starting from the SWAR indices
+  const auto& spread = get_spread_table();
+  std::size_t group = 0;
+  for (; group + 2 <= num_groups; group += 2, planes += 2 * GROUP_SIZE, pixels += 2 * PIXELS_PER_GROUP)
+  {
+    const __m128i indices = _mm_set_epi64x(static_cast<int64_t>(decode_group_swar(spread, planes + GROUP_SIZE)),
+                                           static_cast<int64_t>(decode_group_swar(spread, planes)));
+    const __m128i t = _mm_cmplt_epi8(indices, _mm_set1_epi8(TRANSPARENT));
+    const __m128i b = bit_mask_sse2(indices, 1);
+    const __m128i g = bit_mask_sse2(indices, 2);
+    const __m128i r = bit_mask_sse2(indices, 4);
+    const __m128i i = bit_mask_sse2(indices, 8);
+    const __m128i x55 = _mm_set1_epi8(0x55);
+    const __m128i xaa = _mm_set1_epi8(static_cast<char>(0xAA));
+    const __m128i intensity = _mm_and_si128(i, x55);
+    const __m128i brown = _mm_and_si128(_mm_cmpeq_epi8(indices, _mm_set1_epi8(6)), x55);
+    const __m128i yellow = _mm_and_si128(_mm_cmpeq_epi8(indices, _mm_set1_epi8(14)), x55);
+
+    const __m128i blue = _mm_and_si128(t, _mm_add_epi8(_mm_add_epi8(_mm_and_si128(b, xaa), intensity), yellow));
+    const __m128i green = _mm_and_si128(t, _mm_sub_epi8(_mm_add_epi8(_mm_and_si128(g, xaa), intensity), brown));
+    const __m128i red = _mm_and_si128(t, _mm_add_epi8(_mm_and_si128(r, xaa), intensity));
+
+    // Interleave to B, G, R, A bytes, i.e. little endian ARGB8888
+    const __m128i bg_lo = _mm_unpacklo_epi8(blue, green);
+    const __m128i bg_hi = _mm_unpackhi_epi8(blue, green);
+    const __m128i ra_lo = _mm_unpacklo_epi8(red, t);
+    const __m128i ra_hi = _mm_unpackhi_epi8(red, t);
+    auto* out = reinterpret_cast<__m128i*>(pixels);
+    _mm_storeu_si128(out + 0, _mm_unpacklo_epi16(bg_lo, ra_lo));
+    _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(bg_lo, ra_lo));
+    _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(bg_hi, ra_hi));
+    _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(bg_hi, ra_hi));
+  }
+  decode_argb_swar(planes, num_groups - group, pixels);
+}
+
+// Returns -1 in each lane whose bit (0x80, 0x40, ..., 0x01) is set in the plane byte
+TARGET_AVX2 __m256i plane_mask_avx2(const uint8_t plane)
+{
+  const __m256i bits = _mm256_set_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+  return _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(plane), bits), bits);
+}
+
+TARGET_AVX2 void decode_argb_avx2(const uint8_t* planes, std::size_t num_groups, uint32_t* pixels)
+{
+  const auto* palette = reinterpret_cast<const int*>(PALETTE_WITH_TRANSPARENT.data());
+  for (std::size_t group = 0; group < num_groups; group++, planes += GROUP_SIZE, pixels += PIXELS_PER_GROUP)
+  {
+    const __m256i t = plane_mask_avx2(planes[0]);
+    const __m256i b = plane_mask_avx2(planes[1]);
+    const __m256i g = plane_mask_avx2(planes[2]);
+    const __m256i r = plane_mask_avx2(planes[3]);
+    const __m256i i = plane_mask_avx2(planes[4]);
+    const __m256i color =
+      _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(b, _mm256_set1_epi32(1)), _mm256_and_si256(g, _mm256_set1_epi32(2))),
+                      _mm256_or_si256(_mm256_and_si256(r, _mm256_set1_epi32(4)), _mm256_and_si256(i, _mm256_set1_epi32(8))));
+    const __m256i index = _mm256_or_si256(_mm256_and_si256(t, color), _mm256_andnot_si256(t, _mm256_set1_epi32(TRANSPARENT)));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(pixels), _mm256_i32gather_epi32(palette, index, 4));
+  }
+}
+
+bool cpu_has_avx2()
+{
+#ifdef _MSC_VER
+  int info[4];
+  __cpuid(info, 0);
+  if (info[0] < 7)
+  {
+    return false;
+  }
+  // The OS must also save the AVX registers
+  __cpuid(info, 1);
+  if (!(info[2] & (1 << 27)) || (_xgetbv(0) & 6) != 6)
+  {
+    return false;
+  }
+  __cpuidex(info, 7, 0);
+  return (info[1] & (1 << 5)) != 0;
+#else
+  return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+using DecodeArgbFunction = void (*)(const uint8_t*, std::size_t, uint32_t*);
+
+DecodeArgbFunction get_function(const DecodePath path)
+{
+  switch (path)
+  {
+    case DecodePath::SCALAR:
+      return decode_argb_scalar;
+    case DecodePath::SWAR:
+      return decode_argb_swar;
+#ifdef EGA_X86_64
+    case DecodePath::SSE2:
+      return decode_argb_sse2;
+    case DecodePath::AVX2:
+      return decode_argb_avx2;
+#endif
+    default:
+      return decode_argb_swar;
+  }
+}
+}
+
+const char* to_string(const DecodePath path)
+{
+  switch (path)
+  {
+    case DecodePath::SCALAR:
+      return "scalar";
+    case DecodePath::SWAR:
+      return "swar";
+    case DecodePath::SSE2:
+      return "sse2";
+    case DecodePath::AVX2:
+      return "avx2";
+  }
+  return "unknown";
+}
+
+bool is_supported(const DecodePath path)
+{
+  switch (path)
+  {
+    case DecodePath::SCALAR:
+    case DecodePath::SWAR:
+      return true;
+#ifdef EGA_X86_64
+    case DecodePath::SSE2:
+      return true;
+    case DecodePath::AVX2:
+    {
+      static const bool has_avx2 = cpu_has_avx2();
+      return has_avx2;
+    }
+#endif
+    default:
+      return false;
+  }
+}
+
+DecodePath get_best_path()
+{
+  // AVX2 needs a gather per 8 pixels, the SSE2 path computing 16 pixels at a time is as fast or faster (see tileset_bench)
+  for (const auto path : {DecodePath::SSE2, DecodePath::AVX2, DecodePath::SWAR})
+  {
+    if (is_supported(path))
+    {
+      return path;
+    }
+  }
+  return DecodePath::SCALAR;
+}
+
+void decode_indices(const uint8_t* planes, std::size_t num_groups, uint8_t* indices)
+{
+  const auto& spread = get_spread_table();
+  for (std::size_t group = 0; group < num_groups; group++, planes += GROUP_SIZE, indices += PIXELS_PER_GROUP)
+  {
+    const auto packed = decode_group_swar(spread, planes);
+    std::memcpy(indices, &packed, PIXELS_PER_GROUP);
+  }
+}
+
+void decode_argb(const uint8_t* planes, std::size_t num_groups, uint32_t* pixels)
+{
+  static const auto function = get_function(get_best_path());
+  function(planes, num_groups, pixels);
+}
+
+void decode_argb(const DecodePath path, const uint8_t* planes, std::size_t num_groups, uint32_t* pixels)
+{
+  get_function(path)(planes, num_groups, pixels);
+}
+
+}
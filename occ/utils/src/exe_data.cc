@@ -1,17 +1,188 @@
 #include "exe_data.h"
 
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <system_error>
+
+#include "logger.h"
 #include "misc.h"
 #include "path.h"
 #include <decompress.h>
 
 #define EXE_FILENAME_FMT "CC%d.EXE"
+#define CACHE_FILENAME_FMT "CC%d.EXE.%016llx.unlzexe"
+
+// Cache file layout: CacheHeader followed by the decompressed .EXE
+constexpr char CACHE_MAGIC[4] = {'O', 'C', 'C', 'X'};
+constexpr uint32_t CACHE_VERSION = 2u;
+
+struct CacheHeader
+{
+  char magic[4];
+  uint32_t version;
+  uint64_t exe_size;
+  uint64_t exe_hash;
+  uint64_t data_size;
+  uint64_t data_hash;
+};
+
+// https://moddingwiki.shikadi.net/wiki/Crystal_Caves_Map_Format
+constexpr std::size_t levelLoc = 0x8CE0;
+constexpr int levelRows[] = {
+  // intro
+  5,
+  // finale
+  6,
+  // main
+  25,
+  24,
+  24,
+  24,
+  24,
+  24,
+  24,
+  23,
+  23,
+  24,
+  24,
+  24,
+  24,
+  24,
+  23,
+  24,
+  24,
+};
 
 ExeData::ExeData(const int episode)
 {
-  const auto exe_file = misc::string_format(EXE_FILENAME_FMT, episode);
-  const auto exe_path = get_data_path(exe_file);
-  size_t exe_len;
-  const auto exe_data = decompress(exe_path.string().c_str(), &exe_len);
-  data = std::string(exe_data, exe_len);
-  free(exe_data);
+  const auto exe_filename = misc::string_format(EXE_FILENAME_FMT, episode);
+  const auto exe_path = get_data_path(exe_filename);
+  const auto exe_file = MappedFile::open(exe_path);
+  if (!exe_file)
+  {
+    LOG_ERROR("Could not open %s", exe_filename.c_str());
+    return;
+  }
+
+  // The cache file is named after the contents of the .EXE, so that each version gets its own
+  const auto exe_hash = misc::hash_fnv1a(exe_file->data(), exe_file->size());
+  const auto cache_name = misc::string_format(CACHE_FILENAME_FMT, episode, static_cast<unsigned long long>(exe_hash));
+  if (!load_cache(cache_name, *exe_file, exe_hash))
+  {
+    size_t exe_len;
+    const auto exe_data = decompress(exe_path.string().c_str(), &exe_len);
+    if (!exe_data)
+    {
+      LOG_ERROR("Could not decompress %s", exe_filename.c_str());
+      return;
+    }
+    decompressed_ = std::string(exe_data, exe_len);
+    free(exe_data);
+    data = decompressed_;
+    write_cache(cache_name, *exe_file, exe_hash);
+  }
+  index_levels();
+}
+
+bool ExeData::load_cache(const std::string& cache_name, const MappedFile& exe_file, const uint64_t exe_hash)
+{
+  const auto cache_path = get_cache_path(cache_name);
+  if (cache_path.empty())
+  {
+    return false;
+  }
+  auto file = MappedFile::open(cache_path);
+  if (!file || file->size() < sizeof(CacheHeader))
+  {
+    return false;
+  }
+  CacheHeader header;
+  std::memcpy(&header, file->data(), sizeof(CacheHeader));
+  if (std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 || header.version != CACHE_VERSION ||
+      header.exe_size != exe_file.size() || header.exe_hash != exe_hash || header.data_size != file->size() - sizeof(CacheHeader))
+  {
+    LOG_INFO("Ignoring outdated or corrupt EXE cache '%s'", cache_path.string().c_str());
+    return false;
+  }
+  // Hashing the data costs far less than decompressing it again, and catches caches damaged on disk
+  const auto cached_data = std::string_view(file->data() + sizeof(CacheHeader), header.data_size);
+  if (header.data_hash != misc::hash_fnv1a(cached_data.data(), cached_data.size()))
+  {
+    LOG_INFO("Ignoring corrupt EXE cache '%s'", cache_path.string().c_str());
+    return false;
+  }
+  LOG_DEBUG("Using EXE cache '%s'", cache_path.string().c_str());
+  data = cached_data;
+  mapped_ = std::move(file);
+  return true;
+}
+
+void ExeData::write_cache(const std::string& cache_name, const MappedFile& exe_file, const uint64_t exe_hash) const
+{
+  const auto cache_path = get_cache_path(cache_name);
+  if (cache_path.empty())
+  {
+    return;
+  }
+
+  CacheHeader header;
+  std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+  header.version = CACHE_VERSION;
+  header.exe_size = exe_file.size();
+  header.exe_hash = exe_hash;
+  header.data_size = data.size();
+  header.data_hash = misc::hash_fnv1a(data.data(), data.size());
+
+  // Write to a temporary file first so that a partially written cache file is never used
+  auto tmp_path = cache_path;
+  tmp_path += ".tmp";
+  {
+    std::ofstream output{tmp_path, std::ios::binary | std::ios::trunc};
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    output.write(data.data(), data.size());
+    if (!output)
+    {
+      LOG_ERROR("Could not write EXE cache '%s'", tmp_path.string().c_str());
+      return;
+    }
+  }
+  std::error_code ec;
+  std::filesystem::rename(tmp_path, cache_path, ec);
+  if (ec)
+  {
+    LOG_ERROR("Could not write EXE cache '%s': %s", cache_path.string().c_str(), ec.message().c_str());
+    std::filesystem::remove(tmp_path, ec);
+  }
+}
+
+void ExeData::index_levels()
+{
+  auto offset = levelLoc;
+  for (const auto height : levelRows)
+  {
+    Level level{offset, 0, height};
+    for (int row = 0; row < height; row++)
+    {
+      if (offset >= data.size())
+      {
+        LOG_ERROR("Level %d is outside of the EXE data", static_cast<int>(levels.size()));
+        levels.clear();
+        return;
+      }
+      const auto len = static_cast<uint8_t>(data[offset]);
+      if (row == 0)
+      {
+        level.width = len;
+      }
+      offset += 1 + len;
+    }
+    levels.push_back(level);
+  }
+  // The last row may not extend past the end of the data either
+  if (offset > data.size())
+  {
+    LOG_ERROR("Level %d is outside of the EXE data", static_cast<int>(levels.size()) - 1);
+    levels.clear();
+  }
 }
@@ -7,6 +7,14 @@
 
 namespace
 {
+struct ThreadSink
+{
+  Logger::Sink sink;
+  void* user_data;
+};
+
+thread_local ThreadSink thread_sink = {nullptr, nullptr};
+
 const char* level_to_string(Logger::Level level)
 {
   static const char* error = "ERROR";
@@ -33,6 +41,20 @@ const char* level_to_string(Logger::Level level)
 
 void Logger::log(const char* full_filename, int line, Level level, ...)
 {
+  // Extract variadic function arguments
+  va_list args;
+  va_start(args, level);
+  auto* format = va_arg(args, const char*);
+  char message[256];
+  vsnprintf(message, sizeof(message), format, args);
+  va_end(args);
+
+  if (thread_sink.sink)
+  {
+    thread_sink.sink(thread_sink.user_data, level, message);
+    return;
+  }
+
   // Remove directories in filename
   const char* filename;
   if (strrchr(full_filename, '/'))
@@ -55,13 +77,10 @@ void Logger::log(const char* full_filename, int line, Level level, ...)
 #endif
   strftime(time_str, sizeof(time_str), "%Y-%m-%d %X", &time_struct);
 
-  // Extract variadic function arguments
-  va_list args;
-  va_start(args, level);
-  auto* format = va_arg(args, const char*);
-  char message[256];
-  vsnprintf(message, sizeof(message), format, args);
-  va_end(args);
-
   printf("[%s][%s:%d] %s: %s\n", time_str, filename, line, level_to_string(level), message);
 }
+
+void Logger::set_thread_sink(Sink sink, void* user_data)
+{
+  thread_sink = {sink, user_data};
+}
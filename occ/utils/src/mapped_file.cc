@@ -0,0 +1,93 @@
+#include "mapped_file.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "logger.h"
+
+std::unique_ptr<MappedFile> MappedFile::open(const std::filesystem::path& path)
+{
+#ifdef _WIN32
+  auto file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+  {
+    return nullptr;
+  }
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file, &size))
+  {
+    CloseHandle(file);
+    return nullptr;
+  }
+  if (size.QuadPart == 0)
+  {
+    CloseHandle(file);
+    return std::unique_ptr<MappedFile>(new MappedFile(nullptr, 0u, nullptr));
+  }
+  auto mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  // The mapping keeps the file open
+  CloseHandle(file);
+  if (!mapping)
+  {
+    LOG_ERROR("Could not map '%s'", path.string().c_str());
+    return nullptr;
+  }
+  const auto* data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+  if (!data)
+  {
+    LOG_ERROR("Could not map '%s'", path.string().c_str());
+    CloseHandle(mapping);
+    return nullptr;
+  }
+  return std::unique_ptr<MappedFile>(new MappedFile(data, static_cast<std::size_t>(size.QuadPart), mapping));
+#else
+  const auto fd = ::open(path.c_str(), O_RDONLY);
+  if (fd == -1)
+  {
+    return nullptr;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0)
+  {
+    close(fd);
+    return nullptr;
+  }
+  const auto size = static_cast<std::size_t>(st.st_size);
+  if (size == 0u)
+  {
+    close(fd);
+    return std::unique_ptr<MappedFile>(new MappedFile(nullptr, 0u, nullptr));
+  }
+  auto* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // The mapping keeps the file open
+  close(fd);
+  if (data == MAP_FAILED)
+  {
+    LOG_ERROR("Could not map '%s'", path.c_str());
+    return nullptr;
+  }
+  return std::unique_ptr<MappedFile>(new MappedFile(static_cast<const char*>(data), size, nullptr));
+#endif
+}
+
+MappedFile::MappedFile(const char* data, std::size_t size, void* handle) : data_(data), size_(size), handle_(handle) {}
+
+MappedFile::~MappedFile()
+{
+  if (!data_)
+  {
+    return;
+  }
+#ifdef _WIN32
+  UnmapViewOfFile(data_);
+  CloseHandle(handle_);
+#else
+  munmap(const_cast<char*>(data_), size_);
+#endif
+}
@@ -21,4 +21,15 @@ void open_url(const std::string& url)
 #endif
 }
 
+uint64_t hash_fnv1a(const char* data, std::size_t size)
+{
+  uint64_t hash = 14695981039346656037ull;
+  for (std::size_t i = 0; i < size; i++)
+  {
+    hash ^= static_cast<uint8_t>(data[i]);
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
 }
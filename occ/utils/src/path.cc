@@ -1,9 +1,15 @@
 #include "path.h"
 
+#include <cstdlib>
+#include <system_error>
+
 #include <find_steam_game.h>
 
+#include "logger.h"
+
 #define GOG_ID "1207665273"
 #define GAME_NAME "Crystal Caves"
+#define CACHE_DIR_NAME "OpenCrystalCaves"
 
 std::filesystem::path get_data_path(const std::filesystem::path& filename)
 {
@@ -50,3 +56,52 @@ std::filesystem::path get_data_path(const std::filesystem::path& filename)
   }
   return std::filesystem::path();
 }
+
+namespace
+{
+std::filesystem::path get_cache_dir()
+{
+  if (const auto* dir = std::getenv("OCC_CACHE_DIR"); dir && dir[0])
+  {
+    return std::filesystem::path(dir);
+  }
+#ifdef _WIN32
+  if (const auto* dir = std::getenv("LOCALAPPDATA"); dir && dir[0])
+  {
+    return std::filesystem::path(dir) / CACHE_DIR_NAME;
+  }
+#elif defined(__APPLE__)
+  if (const auto* home = std::getenv("HOME"); home && home[0])
+  {
+    return std::filesystem::path(home) / "Library" / "Caches" / CACHE_DIR_NAME;
+  }
+#else
+  if (const auto* dir = std::getenv("XDG_CACHE_HOME"); dir && dir[0])
+  {
+    return std::filesystem::path(dir) / CACHE_DIR_NAME;
+  }
+  if (const auto* home = std::getenv("HOME"); home && home[0])
+  {
+    return std::filesystem::path(home) / ".cache" / CACHE_DIR_NAME;
+  }
+#endif
+  return std::filesystem::path();
+}
+}
+
+std::filesystem::path get_cache_path(const std::filesystem::path& filename)
+{
+  const auto dir = get_cache_dir();
+  if (dir.empty())
+  {
+    return std::filesystem::path();
+  }
+  std::error_code ec;
+  std::filesystem::create_directories(dir, ec);
+  if (ec)
+  {
+    LOG_ERROR("Could not create cache directory '%s': %s", dir.string().c_str(), ec.message().c_str());
+    return std::filesystem::path();
+  }
+  return dir / filename;
+}
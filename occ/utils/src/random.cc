@@ -0,0 +1,15 @@
+#include "random.h"
+
+void Random::seed(const uint64_t seed)
+{
+  // Expand the seed with splitmix64, as recommended by the xoshiro authors, so that similar seeds give unrelated states
+  auto x = seed;
+  for (auto& s : state_)
+  {
+    x += 0x9E3779B97F4A7C15u;
+    auto z = x;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9u;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBu;
+    s = z ^ (z >> 31);
+  }
+}
@@ -0,0 +1,178 @@
+#include "task_graph.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <utility>
+
+#include "misc.h"
+#include "thread_pool.h"
+
+TaskGraph::TaskId TaskGraph::add(const std::string& name,
+                                 const Thread thread,
+                                 const std::vector<TaskId>& dependencies,
+                                 std::function<bool()> function)
+{
+  tasks_.push_back({name, thread, dependencies, std::move(function), false, {}, {}});
+  return tasks_.size() - 1;
+}
+
+bool TaskGraph::run(const unsigned num_threads)
+{
+  start_ = Clock::now();
+
+  auto run_task = [](Task& task)
+  {
+    task.start = Clock::now();
+    const auto result = task.function();
+    task.end = Clock::now();
+    return result;
+  };
+
+  // Worker tasks report back through finished, the graph itself is only touched by this thread
+  std::mutex mutex;
+  std::condition_variable condition;
+  std::vector<std::pair<TaskId, bool>> finished;
+  std::vector<bool> started(tasks_.size(), false);
+  std::size_t num_running = 0u;
+  bool ok = true;
+
+  ThreadPool pool(num_threads);
+  while (true)
+  {
+    // Start all ready worker tasks first so that they run while this thread runs main tasks
+    TaskId main_task = tasks_.size();
+    for (TaskId id = 0u; ok && id < tasks_.size(); id++)
+    {
+      if (started[id] || !is_ready(tasks_[id]))
+      {
+        continue;
+      }
+      if (tasks_[id].thread == Thread::MAIN)
+      {
+        if (main_task == tasks_.size())
+        {
+          main_task = id;
+        }
+        continue;
+      }
+      started[id] = true;
+      num_running++;
+      pool.submit(
+        [this, id, &run_task, &mutex, &condition, &finished]()
+        {
+          const auto result = run_task(tasks_[id]);
+          {
+            std::lock_guard<std::mutex> lock(mutex);
+            finished.emplace_back(id, result);
+          }
+          condition.notify_one();
+        });
+    }
+
+    if (main_task != tasks_.size())
+    {
+      started[main_task] = true;
+      tasks_[main_task].done = run_task(tasks_[main_task]);
+      ok = ok && tasks_[main_task].done;
+      continue;
+    }
+
+    if (num_running == 0u)
+    {
+      break;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    condition.wait(lock, [&finished]() { return !finished.empty(); });
+    for (const auto& [id, result] : finished)
+    {
+      tasks_[id].done = result;
+      ok = ok && result;
+      num_running--;
+    }
+    finished.clear();
+  }
+
+  for (const auto& task : tasks_)
+  {
+    ok = ok && task.done;
+  }
+  return ok;
+}
+
+std::vector<TaskGraph::TaskId> TaskGraph::get_critical_path() const
+{
+  std::vector<TaskId> path;
+  auto latest = [this](const std::vector<TaskId>& ids)
+  {
+    auto last = tasks_.size();
+    for (const auto id : ids)
+    {
+      if (tasks_[id].done && (last == tasks_.size() || tasks_[id].end > tasks_[last].end))
+      {
+        last = id;
+      }
+    }
+    return last;
+  };
+
+  std::vector<TaskId> all(tasks_.size());
+  for (TaskId id = 0u; id < tasks_.size(); id++)
+  {
+    all[id] = id;
+  }
+  for (auto id = latest(all); id != tasks_.size(); id = latest(tasks_[id].dependencies))
+  {
+    path.insert(path.begin(), id);
+  }
+  return path;
+}
+
+std::string TaskGraph::get_report() const
+{
+  std::string report = misc::string_format("%-24s %-6s %9s %9s %9s\n", "task", "thread", "start ms", "time ms", "end ms");
+  for (const auto& task : tasks_)
+  {
+    if (!task.done)
+    {
+      report += misc::string_format("%-24s %-6s %9s\n", task.name.c_str(), task.thread == Thread::MAIN ? "main" : "worker", "-");
+      continue;
+    }
+    report += misc::string_format("%-24s %-6s %9.2f %9.2f %9.2f\n",
+                                  task.name.c_str(),
+                                  task.thread == Thread::MAIN ? "main" : "worker",
+                                  to_ms(task.start),
+                                  to_ms(task.end) - to_ms(task.start),
+                                  to_ms(task.end));
+  }
+
+  const auto path = get_critical_path();
+  report += "critical path:";
+  for (const auto id : path)
+  {
+    report += misc::string_format(" %s%s", id == path.front() ? "" : "-> ", tasks_[id].name.c_str());
+  }
+  if (!path.empty())
+  {
+    report += misc::string_format(" (%.2f ms)", to_ms(tasks_[path.back()].end));
+  }
+  report += "\n";
+  return report;
+}
+
+bool TaskGraph::is_ready(const Task& task) const
+{
+  for (const auto id : task.dependencies)
+  {
+    if (!tasks_[id].done)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+double TaskGraph::to_ms(const Clock::time_point time) const
+{
+  return std::chrono::duration<double, std::milli>(time - start_).count();
+}
@@ -0,0 +1,319 @@
+/*
+https://moddingwiki.shikadi.net/wiki/ProGraphx_Toolbox_tileset_format
+*/
+#include "tileset.h"
+
+#include <cstring>
+#include <fstream>
+#include <system_error>
+
+#include "ega.h"
+#include "logger.h"
+#include "misc.h"
+#include "occ_math.h"
+#include "path.h"
+
+namespace
+{
+struct Header
+{
+  uint8_t count;
+  uint8_t width;
+  uint8_t height;
+
+  size_t size() const { return count * width * height * 5; }
+};
+
+// Cache file layout: CacheHeader, one CacheSource per tileset file, then width * height pixels
+constexpr char CACHE_MAGIC[4] = {'O', 'C', 'C', 'T'};
+constexpr uint32_t CACHE_VERSION = 1u;
+
+struct CacheHeader
+{
+  char magic[4];
+  uint32_t version;
+  int32_t sprite_w;
+  int32_t sprite_h;
+  int32_t stride;
+  int32_t filler;
+  int32_t width;
+  int32_t height;
+  uint32_t num_sources;
+  uint32_t padding;
+};
+
+struct CacheSource
+{
+  uint64_t size;
+  int64_t mtime;
+  uint64_t hash;
+};
+
+// Decodes the tileset file and appends its sheet to all_pixels, returns the height of the sheet
+// The file is read in a single pass, the sheet grows by a row of sprites when needed
+int decode_tileset(const std::filesystem::path& path, const TilesetFormat& format, std::vector<uint32_t>& all_pixels)
+{
+  LOG_DEBUG("Reading %s...", path.string().c_str());
+  const auto file = MappedFile::open(path);
+  if (!file)
+  {
+    return 0;
+  }
+  const int sprite_w = format.sprite_w;
+  const int sprite_h = format.sprite_h;
+  const int stride = format.stride;
+  const int sheet_w = stride * sprite_w;
+  const auto offset = all_pixels.size();
+  // Note: deliberately ignoring the header width/height,
+  //  and reading our preferred sprite size here... it seems to work
+  const auto row_groups = static_cast<std::size_t>(sprite_w) / ega::PIXELS_PER_GROUP;
+  const auto sprite_size = row_groups * sprite_h * ega::GROUP_SIZE;
+
+  // The file can not hold more sprites than this, reserve for them so that growing the sheet does not reallocate
+  const int max_sprites = static_cast<int>(file->size() / sprite_size);
+  const int max_slots = max_sprites + (max_sprites / 50 + 1) * format.filler;
+  all_pixels.reserve(offset + math::round_up(max_slots, stride) * sprite_w * sprite_h);
+
+  const auto* data = reinterpret_cast<const uint8_t*>(file->data());
+  const auto* end = data + file->size();
+  int index = 0;
+  int sheet_h = 0;
+  while (end - data >= static_cast<std::ptrdiff_t>(sizeof(Header)))
+  {
+    Header header;
+    std::memcpy(&header, data, sizeof(header));
+    data += sizeof(header);
+    LOG_DEBUG("Read chunk %d sprites, %d bytes by %d pixels", header.count, header.width, header.height);
+    if (header.count != 50)
+    {
+      // Don't read sprite chunks that are not exactly 50 sprites, they are lies!
+      break;
+    }
+    if (static_cast<std::size_t>(end - data) < header.size() || header.size() < header.count * sprite_size)
+    {
+      LOG_ERROR("Truncated sprite chunk in %s", path.string().c_str());
+      break;
+    }
+    for (int c = 0; c < header.count; c++, index++, data += sprite_size)
+    {
+      const int x = (index % stride) * sprite_w;
+      const int y = (index / stride) * sprite_h;
+      if (y + sprite_h > sheet_h)
+      {
+        sheet_h = y + sprite_h;
+        all_pixels.resize(offset + sheet_w * sheet_h, 0u);
+      }
+      uint32_t* sheet_pixels = all_pixels.data() + offset;
+      const uint8_t* planes = data;
+      for (int h = 0; h < sprite_h; h++, planes += row_groups * ega::GROUP_SIZE)
+      {
+        ega::decode_argb(planes, row_groups, &sheet_pixels[x + (y + h) * sheet_w]);
+      }
+    }
+    data += header.size() - header.count * sprite_size;
+    index += format.filler;
+  }
+
+  // Keep the empty slots after the last chunk
+  const int filled_h = math::round_up(index, stride) / stride * sprite_h;
+  if (filled_h > sheet_h)
+  {
+    sheet_h = filled_h;
+    all_pixels.resize(offset + sheet_w * sheet_h, 0u);
+  }
+  return sheet_h;
+}
+
+uint64_t hash_contents(const std::filesystem::path& path)
+{
+  const auto file = MappedFile::open(path);
+  return file ? misc::hash_fnv1a(file->data(), file->size()) : misc::hash_fnv1a(nullptr, 0);
+}
+
+bool stat_source(const std::filesystem::path& path, CacheSource& source)
+{
+  std::error_code ec;
+  source.size = std::filesystem::file_size(path, ec);
+  if (ec)
+  {
+    return false;
+  }
+  source.mtime = std::filesystem::last_write_time(path, ec).time_since_epoch().count();
+  return !ec;
+}
+
+// Fills in the current state of the source files, with touched set if any of them has a different mtime than the cached one
+bool is_cache_valid(const MappedFile& file,
+                    const std::vector<std::filesystem::path>& paths,
+                    const TilesetFormat& format,
+                    std::vector<CacheSource>& sources,
+                    bool& touched)
+{
+  if (file.size() < sizeof(CacheHeader))
+  {
+    return false;
+  }
+  CacheHeader header;
+  std::memcpy(&header, file.data(), sizeof(CacheHeader));
+  if (std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 || header.version != CACHE_VERSION ||
+      header.sprite_w != format.sprite_w || header.sprite_h != format.sprite_h || header.stride != format.stride ||
+      header.filler != format.filler || header.num_sources != paths.size() || header.width <= 0 || header.height <= 0)
+  {
+    return false;
+  }
+  const auto pixels_offset = sizeof(CacheHeader) + (header.num_sources * sizeof(CacheSource));
+  if (file.size() != pixels_offset + (static_cast<std::size_t>(header.width) * header.height * sizeof(uint32_t)))
+  {
+    return false;
+  }
+  sources.resize(paths.size());
+  touched = false;
+  for (std::size_t i = 0; i < paths.size(); i++)
+  {
+    CacheSource cached;
+    std::memcpy(&cached, file.data() + sizeof(CacheHeader) + (i * sizeof(CacheSource)), sizeof(CacheSource));
+    auto& current = sources[i];
+    if (!stat_source(paths[i], current) || current.size != cached.size)
+    {
+      return false;
+    }
+    // Only hash the contents if the file has been touched
+    if (current.mtime != cached.mtime)
+    {
+      if (hash_contents(paths[i]) != cached.hash)
+      {
+        return false;
+      }
+      touched = true;
+    }
+    current.hash = cached.hash;
+  }
+  return true;
+}
+
+// Rewrites the sources of a valid cache file so that touched but unchanged files are not hashed again next time
+void update_cache_sources(const std::filesystem::path& cache_path, const std::vector<CacheSource>& sources)
+{
+  std::fstream output{cache_path, std::ios::binary | std::ios::in | std::ios::out};
+  output.seekp(sizeof(CacheHeader));
+  output.write(reinterpret_cast<const char*>(sources.data()), sources.size() * sizeof(CacheSource));
+  if (!output)
+  {
+    LOG_ERROR("Could not update tileset cache '%s'", cache_path.string().c_str());
+  }
+}
+
+void write_cache(const std::filesystem::path& cache_path,
+                 const std::vector<std::filesystem::path>& paths,
+                 const TilesetFormat& format,
+                 const TilesetPixels& pixels)
+{
+  CacheHeader header;
+  std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+  header.version = CACHE_VERSION;
+  header.sprite_w = format.sprite_w;
+  header.sprite_h = format.sprite_h;
+  header.stride = format.stride;
+  header.filler = format.filler;
+  header.width = pixels.width();
+  header.height = pixels.height();
+  header.num_sources = static_cast<uint32_t>(paths.size());
+  header.padding = 0u;
+
+  // Write to a temporary file first so that a partially written cache file is never used
+  auto tmp_path = cache_path;
+  tmp_path += ".tmp";
+  {
+    std::ofstream output{tmp_path, std::ios::binary | std::ios::trunc};
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (const auto& path : paths)
+    {
+      CacheSource source;
+      if (!stat_source(path, source))
+      {
+        return;
+      }
+      source.hash = hash_contents(path);
+      output.write(reinterpret_cast<const char*>(&source), sizeof(source));
+    }
+    output.write(reinterpret_cast<const char*>(pixels.data()), static_cast<std::size_t>(pixels.width()) * pixels.height() * sizeof(uint32_t));
+    if (!output)
+    {
+      LOG_ERROR("Could not write tileset cache '%s'", tmp_path.string().c_str());
+      return;
+    }
+  }
+  std::error_code ec;
+  std::filesystem::rename(tmp_path, cache_path, ec);
+  if (ec)
+  {
+    LOG_ERROR("Could not write tileset cache '%s': %s", cache_path.string().c_str(), ec.message().c_str());
+    std::filesystem::remove(tmp_path, ec);
+  }
+}
+}
+
+TilesetPixels decode_tilesets(const std::vector<std::filesystem::path>& paths, const TilesetFormat& format)
+{
+  TilesetPixels pixels;
+  for (const auto& path : paths)
+  {
+    const auto sheet_h = decode_tileset(path, format, pixels.pixels_);
+    if (sheet_h == 0)
+    {
+      LOG_ERROR("Could not load any sprites from '%s'", path.string().c_str());
+      continue;
+    }
+    pixels.height_ += sheet_h;
+  }
+  if (pixels.height_ > 0)
+  {
+    pixels.width_ = format.stride * format.sprite_w;
+    pixels.data_ = pixels.pixels_.data();
+  }
+  return pixels;
+}
+
+TilesetPixels load_tilesets(const std::vector<std::filesystem::path>& paths, const TilesetFormat& format, const std::string& cache_name)
+{
+  const auto cache_path = get_cache_path(cache_name);
+  if (cache_path.empty())
+  {
+    return decode_tilesets(paths, format);
+  }
+
+  std::vector<CacheSource> sources;
+  bool touched = false;
+  auto file = MappedFile::open(cache_path);
+  if (file && !is_cache_valid(*file, paths, format, sources, touched))
+  {
+    file.reset();
+  }
+  else if (file && touched)
+  {
+    // The mapping has to be closed while writing to the file on some platforms
+    file.reset();
+    update_cache_sources(cache_path, sources);
+    file = MappedFile::open(cache_path);
+  }
+  if (file)
+  {
+    LOG_DEBUG("Using tileset cache '%s'", cache_path.string().c_str());
+    CacheHeader header;
+    std::memcpy(&header, file->data(), sizeof(CacheHeader));
+    TilesetPixels pixels;
+    pixels.width_ = header.width;
+    pixels.height_ = header.height;
+    // The pixels start at a multiple of 8 bytes into the page aligned mapping
+    pixels.data_ = reinterpret_cast<const uint32_t*>(file->data() + sizeof(CacheHeader) + (header.num_sources * sizeof(CacheSource)));
+    pixels.mapped_ = std::move(file);
+    return pixels;
+  }
+
+  auto pixels = decode_tilesets(paths, format);
+  if (!pixels.empty())
+  {
+    write_cache(cache_path, paths, format, pixels);
+  }
+  return pixels;
+}
@@ -0,0 +1,131 @@
+#include "work_stealing_pool.h"
+
+#include <algorithm>
+
+WorkStealingPool::WorkStealingPool(const unsigned num_threads)
+  : queues_(),
+    function_(nullptr),
+    mutex_(),
+    start_condition_(),
+    done_condition_(),
+    batch_(0u),
+    num_remaining_(0u),
+    stopping_(false),
+    num_stolen_(0u),
+    threads_()
+{
+  const auto num_workers = std::max(1u, num_threads);
+  for (unsigned i = 0u; i < num_workers; i++)
+  {
+    queues_.push_back(std::make_unique<Queue>());
+  }
+  threads_.reserve(num_workers);
+  for (unsigned i = 0u; i < num_workers; i++)
+  {
+    threads_.emplace_back(&WorkStealingPool::work, this, i);
+  }
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  start_condition_.notify_all();
+  for (auto& thread : threads_)
+  {
+    thread.join();
+  }
+}
+
+void WorkStealingPool::run(const std::size_t num_tasks, const std::function<void(std::size_t)>& f)
+{
+  if (num_tasks == 0u)
+  {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    function_ = &f;
+    num_remaining_ = num_tasks;
+    const auto num_workers = queues_.size();
+    for (std::size_t worker = 0u; worker < num_workers; worker++)
+    {
+      auto& queue = *queues_[worker];
+      std::lock_guard<std::mutex> queue_lock(queue.mutex);
+      for (auto task = num_tasks * worker / num_workers; task < num_tasks * (worker + 1u) / num_workers; task++)
+      {
+        queue.tasks.push_back(task);
+      }
+    }
+    batch_++;
+  }
+  start_condition_.notify_all();
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_condition_.wait(lock, [this]() { return num_remaining_ == 0u; });
+}
+
+bool WorkStealingPool::pop(const std::size_t worker, std::size_t& task)
+{
+  // The newest task of the own queue first, then the oldest task of the next worker that has one
+  {
+    auto& queue = *queues_[worker];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (!queue.tasks.empty())
+    {
+      task = queue.tasks.back();
+      queue.tasks.pop_back();
+      return true;
+    }
+  }
+  for (std::size_t offset = 1u; offset < queues_.size(); offset++)
+  {
+    auto& victim = *queues_[(worker + offset) % queues_.size()];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.tasks.empty())
+    {
+      task = victim.tasks.front();
+      victim.tasks.pop_front();
+      num_stolen_++;
+      return true;
+    }
+  }
+  return false;
+}
+
+void WorkStealingPool::work(const std::size_t worker)
+{
+  uint64_t batch = 0u;
+  while (true)
+  {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      start_condition_.wait(lock, [this, batch]() { return stopping_ || batch_ != batch; });
+      if (stopping_)
+      {
+        return;
+      }
+      batch = batch_;
+    }
+
+    // A worker that wakes up late may already take tasks of the next batch, function_ is read after taking a task
+    // so that it is the function of the task's batch
+    std::size_t num_done = 0u;
+    std::size_t task;
+    while (pop(worker, task))
+    {
+      (*function_)(task);
+      num_done++;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    num_remaining_ -= num_done;
+    if (num_remaining_ == 0u)
+    {
+      done_condition_.notify_one();
+    }
+  }
+}
@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "atlas.h"
+
+namespace
+{
+
+std::vector<uint32_t> make_image(const int width, const int height, const uint32_t color)
+{
+  return std::vector<uint32_t>(width * height, color);
+}
+
+void expect_rect(const geometry::Rectangle& expected, const geometry::Rectangle& actual)
+{
+  EXPECT_EQ(expected.position, actual.position);
+  EXPECT_EQ(expected.size, actual.size);
+}
+
+}  // namespace
+
+TEST(Atlas, Pack)
+{
+  const auto a = make_image(8, 4, 0xFF0000AAu);
+  const auto b = make_image(4, 8, 0xFF0000BBu);
+  const auto c = make_image(8, 2, 0xFF0000CCu);
+  const auto d = make_image(16, 16, 0xFF0000DDu);
+
+  Atlas atlas;
+  ASSERT_TRUE(atlas.pack({{8, 4, a.data()}, {4, 8, b.data()}, {8, 2, c.data()}}, 16));
+  ASSERT_EQ(1u, atlas.get_pages().size());
+
+  // Sorted by height: b, then a next to it, then c next to a
+  EXPECT_EQ(0, atlas.get_region(1).page);
+  expect_rect(geometry::Rectangle(0, 0, 4, 8), atlas.get_region(1).rect);
+  expect_rect(geometry::Rectangle(4, 0, 8, 4), atlas.get_region(0).rect);
+  // c does not fit in the first row
+  expect_rect(geometry::Rectangle(0, 8, 8, 2), atlas.get_region(2).rect);
+
+  const auto& page = atlas.get_pages()[0];
+  EXPECT_EQ(12, page.width);
+  EXPECT_EQ(10, page.height);
+  for (int i = 0; i < 3; i++)
+  {
+    const auto& rect = atlas.get_region(i).rect;
+    const uint32_t colors[] = {0xFF0000AAu, 0xFF0000BBu, 0xFF0000CCu};
+    for (int y = 0; y < rect.size.y(); y++)
+    {
+      for (int x = 0; x < rect.size.x(); x++)
+      {
+        EXPECT_EQ(colors[i], page.pixels[(rect.position.y() + y) * page.width + rect.position.x() + x]);
+      }
+    }
+  }
+  // Unused space is transparent
+  EXPECT_EQ(0u, page.pixels[9 * page.width + 11]);
+
+  // Full pages start new ones
+  ASSERT_TRUE(atlas.pack({{8, 4, a.data()}, {16, 16, d.data()}}, 16));
+  ASSERT_EQ(2u, atlas.get_pages().size());
+  EXPECT_EQ(0, atlas.get_region(1).page);
+  EXPECT_EQ(1, atlas.get_region(0).page);
+  expect_rect(geometry::Rectangle(0, 0, 8, 4), atlas.get_region(0).rect);
+
+  atlas.clear_pixels();
+  EXPECT_TRUE(atlas.get_pages()[0].pixels.empty());
+  EXPECT_EQ(1, atlas.get_region(0).page);
+
+  // Too large
+  EXPECT_FALSE(atlas.pack({{16, 16, d.data()}}, 8));
+}
@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "ega.h"
+
+namespace
+{
+constexpr ega::DecodePath PATHS[] = {ega::DecodePath::SCALAR, ega::DecodePath::SWAR, ega::DecodePath::SSE2, ega::DecodePath::AVX2};
+}
+
+TEST(Ega, decode_indices)
+{
+  // Pixel 0: transparent, 1: black, 2: blue, 3: green, 4: red, 5: intensity, 6: white, 7: transparent
+  const uint8_t group[] = {0x7E, 0x22, 0x12, 0x0A, 0x06};
+  uint8_t indices[8];
+  ega::decode_indices(group, 1, indices);
+  EXPECT_EQ(ega::TRANSPARENT, indices[0]);
+  EXPECT_EQ(0u, indices[1]);
+  EXPECT_EQ(1u, indices[2]);
+  EXPECT_EQ(2u, indices[3]);
+  EXPECT_EQ(4u, indices[4]);
+  EXPECT_EQ(8u, indices[5]);
+  EXPECT_EQ(15u, indices[6]);
+  EXPECT_EQ(ega::TRANSPARENT, indices[7]);
+}
+
+TEST(Ega, decode_argb)
+{
+  const uint8_t group[] = {0x7E, 0x22, 0x12, 0x0A, 0x06};
+  for (const auto path : PATHS)
+  {
+    if (!ega::is_supported(path))
+    {
+      continue;
+    }
+    uint32_t pixels[8];
+    ega::decode_argb(path, group, 1, pixels);
+    EXPECT_EQ(0u, pixels[0]) << ega::to_string(path);
+    EXPECT_EQ(ega::PALETTE[0], pixels[1]) << ega::to_string(path);
+    EXPECT_EQ(ega::PALETTE[1], pixels[2]) << ega::to_string(path);
+    EXPECT_EQ(ega::PALETTE[2], pixels[3]) << ega::to_string(path);
+    EXPECT_EQ(ega::PALETTE[4], pixels[4]) << ega::to_string(path);
+    EXPECT_EQ(ega::PALETTE[8], pixels[5]) << ega::to_string(path);
+    EXPECT_EQ(ega::PALETTE[15], pixels[6]) << ega::to_string(path);
+    EXPECT_EQ(0u, pixels[7]) << ega::to_string(path);
+  }
+}
+
+TEST(Ega, all_paths_match_scalar)
+{
+  std::mt19937 gen(1234);
+  std::uniform_int_distribution<int> dis(0, 255);
+  std::vector<uint8_t> planes(ega::GROUP_SIZE * 1001);
+  for (auto& plane : planes)
+  {
+    plane = static_cast<uint8_t>(dis(gen));
+  }
+
+  // Odd group counts exercise the tails of the paths that decode several groups at a time
+  for (const std::size_t num_groups : {1u, 2u, 3u, 7u, 1001u})
+  {
+    std::vector<uint32_t> expected(num_groups * ega::PIXELS_PER_GROUP);
+    ega::decode_argb(ega::DecodePath::SCALAR, planes.data(), num_groups, expected.data());
+    for (const auto path : PATHS)
+    {
+      if (!ega::is_supported(path))
+      {
+        continue;
+      }
+      std::vector<uint32_t> pixels(num_groups * ega::PIXELS_PER_GROUP);
+      ega::decode_argb(path, planes.data(), num_groups, pixels.data());
+      EXPECT_EQ(expected, pixels) << ega::to_string(path) << " " << num_groups;
+    }
+    std::vector<uint32_t> pixels(num_groups * ega::PIXELS_PER_GROUP);
+    ega::decode_argb(planes.data(), num_groups, pixels.data());
+    EXPECT_EQ(expected, pixels) << num_groups;
+  }
+}
@@ -0,0 +1,31 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "logger.h"
+
+namespace
+{
+void collect(void* user_data, Logger::Level, const char* message)
+{
+  static_cast<std::vector<std::string>*>(user_data)->push_back(message);
+}
+}
+
+TEST(Logger, ThreadSink)
+{
+  std::vector<std::string> messages;
+  Logger::set_thread_sink(&collect, &messages);
+  LOG_INFO("Loading level %d", 3);
+
+  // Other threads still print their messages
+  std::thread other([]() { LOG_INFO("From another thread"); });
+  other.join();
+
+  LOG_ERROR("%s", "Oops");
+  Logger::set_thread_sink(nullptr, nullptr);
+  LOG_INFO("Printed");
+  EXPECT_EQ((std::vector<std::string>{"Loading level 3", "Oops"}), messages);
+}
@@ -11,8 +11,10 @@ TEST(Misc, make_array)
   EXPECT_EQ(3, array[2]);
 }
 
-TEST(Misc, random)
+TEST(Misc, hash_fnv1a)
 {
-  // Yeah, what can we test really..?
-  const auto a = misc::random<int>(0, 10);
+  // Reference values from the FNV specification
+  EXPECT_EQ(0xcbf29ce484222325ull, misc::hash_fnv1a("", 0));
+  EXPECT_EQ(0xaf63dc4c8601ec8cull, misc::hash_fnv1a("a", 1));
+  EXPECT_EQ(0x85944171f73967e8ull, misc::hash_fnv1a("foobar", 6));
 }
@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <limits>
+
+#include "random.h"
+
+TEST(Random, ReferenceValues)
+{
+  // xoshiro256** seeded with splitmix64, computed with the reference algorithms
+  Random random(0u);
+  EXPECT_EQ(0x99ec5f36cb75f2b4ull, random.next());
+  EXPECT_EQ(0xbf6e1f784956452aull, random.next());
+  EXPECT_EQ(0x1a5f849d4933e6e0ull, random.next());
+
+  random.seed(42u);
+  EXPECT_EQ(0x15780b2e0c2ec716ull, random.next());
+  EXPECT_EQ(0x6104d9866d113a7eull, random.next());
+  EXPECT_EQ(0xae17533239e499a1ull, random.next());
+}
+
+TEST(Random, SameSeedSameNumbers)
+{
+  Random a(1234u);
+  Random b(1234u);
+  Random c(1235u);
+  EXPECT_EQ(a, b);
+  EXPECT_NE(a, c);
+  for (int i = 0; i < 100; i++)
+  {
+    EXPECT_EQ(a.range<int>(-5, 5), b.range<int>(-5, 5));
+  }
+  EXPECT_EQ(a, b);
+
+  // Copies continue from the same state
+  auto copy = a;
+  EXPECT_EQ(a.next(), copy.next());
+}
+
+TEST(Random, Range)
+{
+  Random random(7u);
+  std::array<int, 11> counts{};
+  for (int i = 0; i < 11000; i++)
+  {
+    const auto value = random.range<int>(-5, 5);
+    ASSERT_GE(value, -5);
+    ASSERT_LE(value, 5);
+    counts[value + 5]++;
+  }
+  for (const auto count : counts)
+  {
+    // Roughly uniform
+    EXPECT_GT(count, 800);
+    EXPECT_LT(count, 1200);
+  }
+
+  EXPECT_EQ(3, random.range<int>(3, 3));
+  random.range<int64_t>(std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max());
+  const auto u = random.range<unsigned>(0u, std::numeric_limits<unsigned>::max());
+  EXPECT_LE(u, std::numeric_limits<unsigned>::max());
+}
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "task_graph.h"
+
+TEST(TaskGraph, Dependencies)
+{
+  // a -> c and b -> c -> d, with a and b on workers and d on the main thread
+  const auto main_thread = std::this_thread::get_id();
+  std::atomic<int> num_run{0};
+  int a_result = 0;
+  int b_result = 0;
+  int c_result = 0;
+  std::thread::id d_thread;
+
+  TaskGraph graph;
+  const auto a = graph.add("a",
+                           TaskGraph::Thread::WORKER,
+                           {},
+                           [&]()
+                           {
+                             std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                             a_result = 1;
+                             return ++num_run > 0;
+                           });
+  const auto b = graph.add("b",
+                           TaskGraph::Thread::WORKER,
+                           {},
+                           [&]()
+                           {
+                             b_result = 2;
+                             return ++num_run > 0;
+                           });
+  const auto c = graph.add("c",
+                           TaskGraph::Thread::WORKER,
+                           {a, b},
+                           [&]()
+                           {
+                             c_result = a_result + b_result;
+                             return ++num_run > 0;
+                           });
+  graph.add("d",
+            TaskGraph::Thread::MAIN,
+            {c},
+            [&]()
+            {
+              d_thread = std::this_thread::get_id();
+              return ++num_run > 0;
+            });
+
+  EXPECT_TRUE(graph.run(2u));
+  EXPECT_EQ(4, num_run);
+  EXPECT_EQ(3, c_result);
+  EXPECT_EQ(main_thread, d_thread);
+
+  // a is slower than b, so c waited on a
+  const auto path = graph.get_critical_path();
+  EXPECT_EQ((std::vector<TaskGraph::TaskId>{a, c, 3u}), path);
+  for (const auto& task : graph.get_tasks())
+  {
+    EXPECT_TRUE(task.done);
+    EXPECT_LE(task.start, task.end);
+  }
+  EXPECT_NE(std::string::npos, graph.get_report().find("critical path: a -> c -> d"));
+}
+
+TEST(TaskGraph, Failure)
+{
+  bool dependent_run = false;
+  bool independent_run = false;
+
+  TaskGraph graph;
+  const auto a = graph.add("a", TaskGraph::Thread::MAIN, {}, []() { return false; });
+  graph.add("b",
+            TaskGraph::Thread::WORKER,
+            {a},
+            [&]()
+            {
+              dependent_run = true;
+              return true;
+            });
+  graph.add("c",
+            TaskGraph::Thread::WORKER,
+            {},
+            [&]()
+            {
+              independent_run = true;
+              return true;
+            });
+
+  EXPECT_FALSE(graph.run(1u));
+  EXPECT_FALSE(dependent_run);
+  // c was started before a ran on the main thread
+  EXPECT_TRUE(independent_run);
+  EXPECT_FALSE(graph.get_tasks()[a].done);
+}
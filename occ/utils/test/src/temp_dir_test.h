@@ -0,0 +1,36 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <string>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+// Fixture for tests that need files, each test gets an empty directory that is removed afterwards
+// The directory is named after the test and the process, so test binaries running in parallel do not share it
+class TempDirTest : public ::testing::Test
+{
+ protected:
+  void SetUp() override
+  {
+    const auto* info = ::testing::UnitTest::GetInstance()->current_test_info();
+#ifdef _WIN32
+    const auto pid = _getpid();
+#else
+    const auto pid = getpid();
+#endif
+    dir_ = std::filesystem::temp_directory_path() /
+           ("occ_" + std::string(info->test_suite_name()) + "_" + info->name() + "_" + std::to_string(pid));
+    std::filesystem::remove_all(dir_);
+    std::filesystem::create_directories(dir_);
+  }
+
+  void TearDown() override { std::filesystem::remove_all(dir_); }
+
+  std::filesystem::path dir_;
+};
@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <vector>
+
+#include "thread_pool.h"
+
+TEST(ThreadPool, Submit)
+{
+  ThreadPool pool(4u);
+  EXPECT_EQ(4u, pool.get_num_threads());
+
+  std::vector<std::future<int>> futures;
+  for (int i = 0; i < 100; i++)
+  {
+    futures.push_back(pool.submit([i]() { return i * i; }));
+  }
+  for (int i = 0; i < 100; i++)
+  {
+    EXPECT_EQ(i * i, futures[i].get());
+  }
+
+  // Move-only results
+  auto future = pool.submit([]() { return std::make_unique<int>(42); });
+  EXPECT_EQ(42, *future.get());
+}
+
+TEST(ThreadPool, DestructorDropsQueuedTasks)
+{
+  std::promise<void> started;
+  std::promise<void> release;
+  std::atomic<int> num_run{0};
+  std::future<void> queued;
+  {
+    ThreadPool pool(1u);
+    pool.submit(
+      [&started, &num_run, blocker = release.get_future()]() mutable
+      {
+        started.set_value();
+        blocker.wait();
+        num_run++;
+      });
+    queued = pool.submit([&num_run]() { num_run++; });
+    started.get_future().wait();
+    // The running task must finish before the pool is destroyed
+    std::thread releaser(
+      [&release]()
+      {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        release.set_value();
+      });
+    releaser.detach();
+  }
+  EXPECT_EQ(1, num_run.load());
+  EXPECT_THROW(queued.get(), std::future_error);
+}
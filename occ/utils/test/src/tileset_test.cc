@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include "temp_dir_test.h"
+#include "tileset.h"
+
+namespace
+{
+constexpr TilesetFormat FORMAT = {8, 8, 50, 0};
+
+// Writes a tileset with a single chunk of 50 8x8 sprites, where only the first two pixels of the
+// first sprite are opaque: the first pixel has the given color and the second is black
+void write_tileset(const std::filesystem::path& path, const uint8_t color)
+{
+  std::string data(3 + (50 * 8 * 5), '\0');
+  data[0] = 50;
+  data[1] = 1;
+  data[2] = 8;
+  data[3] = static_cast<char>(0xC0);                     // transparency plane
+  data[4] = static_cast<char>((color & 1) << 7);         // blue plane
+  data[5] = static_cast<char>(((color >> 1) & 1) << 7);  // green plane
+  data[6] = static_cast<char>(((color >> 2) & 1) << 7);  // red plane
+  data[7] = static_cast<char>(((color >> 3) & 1) << 7);  // intensity plane
+  std::ofstream output{path, std::ios::binary | std::ios::trunc};
+  output.write(data.data(), data.size());
+}
+
+std::string read_file(const std::filesystem::path& path)
+{
+  std::ifstream input{path, std::ios::binary};
+  return {std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>()};
+}
+
+void set_cache_dir(const std::filesystem::path& dir)
+{
+#ifdef _WIN32
+  _putenv_s("OCC_CACHE_DIR", dir.string().c_str());
+#else
+  setenv("OCC_CACHE_DIR", dir.c_str(), 1);
+#endif
+}
+
+class TilesetTest : public TempDirTest
+{
+ protected:
+  void SetUp() override
+  {
+    TempDirTest::SetUp();
+    set_cache_dir(dir_ / "cache");
+  }
+};
+}
+
+TEST_F(TilesetTest, decode)
+{
+  const auto path = dir_ / "test.gfx";
+  write_tileset(path, 1u);
+
+  const auto pixels = decode_tilesets({path}, FORMAT);
+  ASSERT_FALSE(pixels.empty());
+  EXPECT_EQ(400, pixels.width());
+  EXPECT_EQ(8, pixels.height());
+  EXPECT_EQ(0xFF0000AAu, pixels.data()[0]);
+  EXPECT_EQ(0xFF000000u, pixels.data()[1]);
+  EXPECT_EQ(0u, pixels.data()[2]);
+  EXPECT_EQ(0u, pixels.data()[400]);
+
+  // Files are stacked vertically and invalid files are skipped
+  const auto stacked = decode_tilesets({path, dir_ / "missing.gfx", path}, FORMAT);
+  EXPECT_EQ(400, stacked.width());
+  EXPECT_EQ(16, stacked.height());
+  EXPECT_EQ(0xFF0000AAu, stacked.data()[400 * 8]);
+}
+
+TEST_F(TilesetTest, truncated)
+{
+  const auto path = dir_ / "test.gfx";
+  write_tileset(path, 1u);
+  std::filesystem::resize_file(path, 3 + (49 * 8 * 5));
+
+  EXPECT_TRUE(decode_tilesets({path}, FORMAT).empty());
+
+  // A truncated chunk after a complete one is ignored
+  write_tileset(path, 1u);
+  std::ofstream{path, std::ios::binary | std::ios::app}.write("\x32\x01\x08\xC0", 4);
+  const auto pixels = decode_tilesets({path}, FORMAT);
+  EXPECT_EQ(400, pixels.width());
+  EXPECT_EQ(8, pixels.height());
+}
+
+TEST_F(TilesetTest, cache)
+{
+  const auto path = dir_ / "test.gfx";
+  write_tileset(path, 1u);
+
+  const auto cold = load_tilesets({path}, FORMAT, "test.pixels");
+  ASSERT_FALSE(cold.empty());
+  EXPECT_FALSE(cold.is_cached());
+  EXPECT_TRUE(std::filesystem::exists(dir_ / "cache" / "test.pixels"));
+
+  const auto warm = load_tilesets({path}, FORMAT, "test.pixels");
+  ASSERT_FALSE(warm.empty());
+  EXPECT_TRUE(warm.is_cached());
+  ASSERT_EQ(cold.width(), warm.width());
+  ASSERT_EQ(cold.height(), warm.height());
+  EXPECT_EQ(0, std::memcmp(cold.data(), warm.data(), cold.width() * cold.height() * sizeof(uint32_t)));
+
+  // Touching the file without changing it keeps the cache, and updates it so that the file is not hashed again
+  const auto mtime = std::filesystem::last_write_time(path);
+  std::filesystem::last_write_time(path, mtime + std::chrono::hours(1));
+  const auto untouched = read_file(dir_ / "cache" / "test.pixels");
+  EXPECT_TRUE(load_tilesets({path}, FORMAT, "test.pixels").is_cached());
+  const auto updated = read_file(dir_ / "cache" / "test.pixels");
+  EXPECT_EQ(untouched.size(), updated.size());
+  EXPECT_NE(untouched, updated);
+  EXPECT_TRUE(load_tilesets({path}, FORMAT, "test.pixels").is_cached());
+  EXPECT_EQ(updated, read_file(dir_ / "cache" / "test.pixels"));
+
+  // Changing the file invalidates the cache
+  write_tileset(path, 15u);
+  std::filesystem::last_write_time(path, mtime + std::chrono::hours(2));
+  const auto changed = load_tilesets({path}, FORMAT, "test.pixels");
+  ASSERT_FALSE(changed.empty());
+  EXPECT_FALSE(changed.is_cached());
+  EXPECT_EQ(0xFFFFFFFFu, changed.data()[0]);
+
+  // A different format does not use the cache
+  EXPECT_FALSE(load_tilesets({path}, {8, 8, 25, 0}, "test.pixels").is_cached());
+}
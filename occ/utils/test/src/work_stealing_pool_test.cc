@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "work_stealing_pool.h"
+
+TEST(WorkStealingPool, RunsEachTaskOnce)
+{
+  WorkStealingPool pool(4u);
+  EXPECT_EQ(4u, pool.get_num_threads());
+
+  std::vector<std::atomic<int>> counts(1000u);
+  for (int batch = 1; batch <= 10; batch++)
+  {
+    // A different function each batch, and a different number of tasks than workers
+    pool.run(counts.size() - batch, [&counts, batch](const std::size_t index) { counts[index] += batch; });
+  }
+  for (std::size_t i = 0u; i < counts.size(); i++)
+  {
+    int expected = 0;
+    for (int batch = 1; batch <= 10; batch++)
+    {
+      expected += i < counts.size() - batch ? batch : 0;
+    }
+    EXPECT_EQ(expected, counts[i].load()) << "task " << i;
+  }
+
+  pool.run(0u, [](const std::size_t) { FAIL(); });
+}
+
+TEST(WorkStealingPool, Steals)
+{
+  // Worker 0 gets tasks 0-3 and worker 1 tasks 4-7. Worker 1 starts with task 7, which waits for all other tasks,
+  // so tasks 4-6 must be stolen by worker 0.
+  WorkStealingPool pool(2u);
+  std::atomic<int> num_done{0};
+  pool.run(8u,
+           [&num_done](const std::size_t index)
+           {
+             if (index == 7u)
+             {
+               const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+               while (num_done < 7 && std::chrono::steady_clock::now() < deadline)
+               {
+                 std::this_thread::sleep_for(std::chrono::milliseconds(1));
+               }
+             }
+             num_done++;
+           });
+  EXPECT_EQ(8, num_done.load());
+  EXPECT_GE(pool.get_num_stolen(), 3u);
+}
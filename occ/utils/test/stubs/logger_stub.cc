@@ -3,3 +3,7 @@
 void Logger::log(char const*, int, Logger::Level, ...)
 {
 }
+
+void Logger::set_thread_sink(Logger::Sink, void*)
+{
+}